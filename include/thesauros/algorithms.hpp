@@ -2,11 +2,14 @@
 #define INCLUDE_THESAUROS_ALGORITHMS_HPP
 
 // IWYU pragma: begin_exports
+#include "algorithms/crc32c.hpp"
 #include "algorithms/ranges.hpp"
 #include "algorithms/sort-indices.hpp"
+#include "algorithms/stable-sort.hpp"
 #include "algorithms/static-ranges.hpp"
 #include "algorithms/swap-or-equal.hpp"
 #include "algorithms/transform-inclusive-scan.hpp"
+#include "algorithms/transform-reduce.hpp"
 // IWYU pragma: end_exports
 
 #endif // INCLUDE_THESAUROS_ALGORITHMS_HPP
@@ -0,0 +1,136 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_ALGORITHMS_CRC32C_HPP
+#define INCLUDE_THESAUROS_ALGORITHMS_CRC32C_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "thesauros/macropolis/platform.hpp"
+
+#if THES_X86_64 && THES_GCC_COMPAT
+#include <nmmintrin.h>
+#endif
+#if THES_ARM64 && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
+namespace thes {
+namespace detail::crc {
+// The Castagnoli polynomial in reversed bit order.
+inline constexpr std::uint32_t polynomial = 0x82F63B78U;
+
+// The tables for slicing by eight bytes, where `tables[k][b]` is the CRC of the byte `b`
+// followed by `k` zero bytes.
+inline constexpr auto tables = [] {
+  std::array<std::array<std::uint32_t, 256>, 8> out{};
+  for (std::uint32_t b = 0; b < 256; ++b) {
+    std::uint32_t crc = b;
+    for (int i = 0; i < 8; ++i) {
+      crc = (crc >> 1U) ^ ((crc & 1U) * polynomial);
+    }
+    out[0][b] = crc;
+  }
+  for (std::size_t k = 1; k < 8; ++k) {
+    for (std::size_t b = 0; b < 256; ++b) {
+      out[k][b] = (out[k - 1][b] >> 8U) ^ out[0][out[k - 1][b] & 0xFFU];
+    }
+  }
+  return out;
+}();
+
+constexpr std::uint32_t update_byte(std::uint32_t crc, std::byte byte) {
+  return (crc >> 8U) ^ tables[0][(crc ^ std::uint32_t(byte)) & 0xFFU];
+}
+
+constexpr std::uint32_t update_software(std::uint32_t crc, std::span<const std::byte> data) {
+  const std::byte* it = data.data();
+  const std::byte* const end = it + data.size();
+  for (; end - it >= 8; it += 8) {
+    const auto at = [&](std::size_t i) { return std::uint32_t(it[i]); };
+    const std::uint32_t lo = crc ^ (at(0) | (at(1) << 8U) | (at(2) << 16U) | (at(3) << 24U));
+    crc = tables[7][lo & 0xFFU] ^ tables[6][(lo >> 8U) & 0xFFU] ^
+          tables[5][(lo >> 16U) & 0xFFU] ^ tables[4][lo >> 24U] ^ tables[3][at(4)] ^
+          tables[2][at(5)] ^ tables[1][at(6)] ^ tables[0][at(7)];
+  }
+  for (; it != end; ++it) {
+    crc = update_byte(crc, *it);
+  }
+  return crc;
+}
+
+#if THES_X86_64 && THES_GCC_COMPAT
+__attribute__((target("sse4.2"))) inline std::uint32_t
+update_hardware(std::uint32_t crc, std::span<const std::byte> data) {
+  const std::byte* it = data.data();
+  const std::byte* const end = it + data.size();
+  std::uint64_t crc64 = crc;
+  for (; end - it >= 8; it += 8) {
+    std::uint64_t word{};
+    std::memcpy(&word, it, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+  }
+  crc = std::uint32_t(crc64);
+  for (; it != end; ++it) {
+    crc = _mm_crc32_u8(crc, std::uint8_t(*it));
+  }
+  return crc;
+}
+
+inline bool has_hardware() {
+#ifdef __SSE4_2__
+  return true;
+#else
+  static const bool supported = __builtin_cpu_supports("sse4.2");
+  return supported;
+#endif
+}
+#elif THES_ARM64 && defined(__ARM_FEATURE_CRC32)
+inline std::uint32_t update_hardware(std::uint32_t crc, std::span<const std::byte> data) {
+  const std::byte* it = data.data();
+  const std::byte* const end = it + data.size();
+  for (; end - it >= 8; it += 8) {
+    std::uint64_t word{};
+    std::memcpy(&word, it, sizeof(word));
+    crc = __crc32cd(crc, word);
+  }
+  for (; it != end; ++it) {
+    crc = __crc32cb(crc, std::uint8_t(*it));
+  }
+  return crc;
+}
+
+inline bool has_hardware() {
+  return true;
+}
+#endif
+} // namespace detail::crc
+
+/**
+ * The CRC-32C (Castagnoli) checksum of `data`, as used by iSCSI, ext4 and many storage formats.
+ *
+ * Passing the checksum of a preceding range as `crc` continues it, so that the checksum of a
+ * concatenation can be computed piecewise. At runtime, this uses the CRC32 instructions of SSE 4.2
+ * or ARMv8 where available and slicing by eight bytes otherwise.
+ */
+constexpr std::uint32_t crc32c(std::span<const std::byte> data, std::uint32_t crc = 0) {
+  crc = ~crc;
+#if (THES_X86_64 && THES_GCC_COMPAT) || (THES_ARM64 && defined(__ARM_FEATURE_CRC32))
+  if !consteval {
+    if (detail::crc::has_hardware()) {
+      return ~detail::crc::update_hardware(crc, data);
+    }
+  }
+#endif
+  return ~detail::crc::update_software(crc, data);
+}
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_ALGORITHMS_CRC32C_HPP
@@ -0,0 +1,65 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_ALGORITHMS_STABLE_SORT_HPP
+#define INCLUDE_THESAUROS_ALGORITHMS_STABLE_SORT_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace thes {
+/**
+ * Sorts `[first, last)` stably in parallel using `expo`, an execution policy providing
+ * `execute_chunked` and `thread_num`: Each chunk is sorted on its own, after which
+ * neighbouring runs are merged pairwise until a single run is left.
+ */
+template<std::random_access_iterator It, typename ExPo, typename Cmp = std::less<>>
+requires requires(const ExPo& expo) { expo.thread_num(); }
+inline void stable_sort(It first, It last, const ExPo& expo, Cmp cmp = Cmp{}) {
+  using Run = std::pair<std::size_t, std::size_t>;
+  const auto size = std::size_t(last - first);
+  const auto at = [first](std::size_t i) { return first + std::ptrdiff_t(i); };
+
+  std::vector<std::vector<Run>> thread_runs(expo.thread_num());
+  expo.execute_chunked(size, [&](std::size_t thread_idx, auto begin, auto end) {
+    std::stable_sort(at(std::size_t(begin)), at(std::size_t(end)), cmp);
+    thread_runs[thread_idx].emplace_back(std::size_t(begin), std::size_t(end));
+  });
+
+  std::vector<Run> runs{};
+  for (const std::vector<Run>& local : thread_runs) {
+    runs.insert(runs.end(), local.begin(), local.end());
+  }
+  std::sort(runs.begin(), runs.end());
+
+  while (runs.size() > 1) {
+    const std::size_t pair_num = runs.size() / 2;
+    expo.execute_chunked(pair_num, [&](std::size_t /*thread_idx*/, auto begin, auto end) {
+      for (auto i = std::size_t(begin); i < std::size_t(end); ++i) {
+        const Run& lhs = runs[2 * i];
+        const Run& rhs = runs[2 * i + 1];
+        std::inplace_merge(at(lhs.first), at(rhs.first), at(rhs.second), cmp);
+      }
+    });
+
+    std::vector<Run> merged{};
+    merged.reserve(pair_num + 1);
+    for (std::size_t i = 0; i < pair_num; ++i) {
+      merged.emplace_back(runs[2 * i].first, runs[2 * i + 1].second);
+    }
+    if (runs.size() % 2 != 0) {
+      merged.push_back(runs.back());
+    }
+    runs = std::move(merged);
+  }
+}
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_ALGORITHMS_STABLE_SORT_HPP
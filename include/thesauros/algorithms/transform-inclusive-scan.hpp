@@ -7,53 +7,174 @@
 #ifndef INCLUDE_THESAUROS_ALGORITHMS_TRANSFORM_INCLUSIVE_SCAN_HPP
 #define INCLUDE_THESAUROS_ALGORITHMS_TRANSFORM_INCLUSIVE_SCAN_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <functional>
 #include <iterator>
-#include <latch>
 #include <numeric>
-#include <type_traits>
 #include <utility>
 
+#include "thesauros/algorithms/transform-reduce.hpp"
 #include "thesauros/containers/array/fixed.hpp"
-#include "thesauros/math/integer-cast.hpp"
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/memory/cache-line.hpp"
+#include "thesauros/types/primitives.hpp"
 
 namespace thes {
+/**
+ * The default number of elements per tile of the parallel scans, which is small enough for a tile
+ * to still be cached when it is read for the second time.
+ */
+inline constexpr std::size_t default_scan_tile_size = std::size_t{1} << 14U;
+
+namespace detail {
+/** The state a tile of a decoupled look-back scan publishes to its successors. */
+template<typename T>
+struct ScanTile {
+  enum struct Status : u8 { invalid, aggregate, inclusive };
+
+  std::atomic<Status> status{Status::invalid};
+  // Each field is written once, before the release store of the status that makes it valid.
+  T aggregate{};
+  T inclusive{};
+
+  void publish(Status s) {
+    status.store(s, std::memory_order_release);
+    status.notify_all();
+  }
+};
+
+/**
+ * A single-pass parallel scan with decoupled look-back, as described by Merrill and Garland in
+ * “Single-pass Parallel Prefix Scan with Decoupled Look-back” (2016).
+ *
+ * The threads claim tiles in increasing order from a shared counter. A thread reduces its tile,
+ * publishes the aggregate, and then combines the aggregates of its predecessors from right to
+ * left until it reaches one which has published its inclusive prefix, waiting only for
+ * predecessors whose aggregate is still being computed. Once the thread has published its own
+ * inclusive prefix, it scans the tile, which is still cached, starting from the exclusive prefix.
+ * Each element is therefore read from memory only once, and no thread waits for more than the
+ * reduction of a single tile, in contrast to a reduction and a scan separated by a barrier.
+ *
+ * Since the tiles are handed out dynamically, only `policy.executor()` is used.
+ * `scan_tile(tile_first, tile_last, tile_d_first, exclusive_prefix)` scans a single tile.
+ */
+template<typename T, typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2,
+         typename BinaryOperation, typename UnaryOperation, typename ScanTileFun>
+inline void decoupled_look_back_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last,
+                                     ForwardIt2 d_first, BinaryOperation binary_op,
+                                     UnaryOperation unary_op, const T& first_prefix,
+                                     std::size_t tile_size, ScanTileFun scan_tile) {
+  using Tile = ScanTile<T>;
+  using Status = Tile::Status;
+
+  const std::size_t size = std::size_t(detail::execution_size<ExecutionPolicy>(first, last));
+  if (size == 0) {
+    return;
+  }
+  tile_size = std::max(tile_size, std::size_t{1});
+  const std::size_t tile_num = div_ceil(size, tile_size);
+
+  // Each tile is written by one thread and polled by its successors, so no two share a cache line.
+  FixedArray<CacheAligned<Tile>> tiles(tile_num);
+  CacheAligned<std::atomic<std::size_t>> next_tile{};
+
+  policy.executor().execute([&](std::size_t /*thread_idx*/) {
+    while (true) {
+      const std::size_t tile_idx = next_tile.value.fetch_add(1, std::memory_order_relaxed);
+      if (tile_idx >= tile_num) {
+        break;
+      }
+      Tile& tile = tiles[tile_idx].value;
+
+      const std::size_t begin = tile_idx * tile_size;
+      const std::size_t end = std::min(begin + tile_size, size);
+      auto tile_first = first;
+      std::advance(tile_first, begin);
+      auto tile_last = tile_first;
+      std::advance(tile_last, end - begin);
+
+      T aggregate = std::transform_reduce(std::next(tile_first), tile_last,
+                                          std::invoke(unary_op, *tile_first), binary_op, unary_op);
+
+      T exclusive = first_prefix;
+      if (tile_idx == 0) {
+        tile.inclusive = std::invoke(binary_op, first_prefix, std::move(aggregate));
+        tile.publish(Status::inclusive);
+      } else {
+        tile.aggregate = std::move(aggregate);
+        tile.publish(Status::aggregate);
+
+        // Tile 0 always publishes its inclusive prefix, so the look-back ends there at the latest.
+        bool has_exclusive = false;
+        for (std::size_t pred_idx = tile_idx; pred_idx-- > 0;) {
+          Tile& pred = tiles[pred_idx].value;
+          Status status = pred.status.load(std::memory_order_acquire);
+          while (status == Status::invalid) {
+            pred.status.wait(Status::invalid, std::memory_order_acquire);
+            status = pred.status.load(std::memory_order_acquire);
+          }
+
+          const T& pred_value = (status == Status::inclusive) ? pred.inclusive : pred.aggregate;
+          exclusive = has_exclusive ? std::invoke(binary_op, pred_value, std::move(exclusive))
+                                    : pred_value;
+          has_exclusive = true;
+          if (status == Status::inclusive) {
+            break;
+          }
+        }
+
+        tile.inclusive = std::invoke(binary_op, exclusive, tile.aggregate);
+        tile.publish(Status::inclusive);
+      }
+
+      auto tile_d_first = d_first;
+      std::advance(tile_d_first, begin);
+      scan_tile(tile_first, tile_last, tile_d_first, std::move(exclusive));
+    }
+  });
+}
+} // namespace detail
+
+/**
+ * Compute the inclusive scan of `unary_op` applied to `[first, last)` with `binary_op` into the
+ * range starting at `d_first` in parallel, using a single-pass scan with decoupled look-back.
+ *
+ * `neutral` has to be the neutral element of `binary_op`.
+ */
 template<typename T, typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2,
          typename BinaryOperation, typename UnaryOperation>
 inline void transform_inclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last,
                                      ForwardIt2 d_first, BinaryOperation binary_op,
-                                     UnaryOperation unary_op, T neutral) {
-  const auto raw_size = std::distance(first, last);
-  const auto size = [raw_size] {
-    using ExPo = std::decay_t<ExecutionPolicy>;
-    if constexpr (requires { typename ExPo::Size; }) {
-      return *safe_cast<typename ExPo::Size>(raw_size);
-    } else {
-      using Size = std::make_unsigned_t<std::decay_t<decltype(raw_size)>>;
-      return *safe_cast<Size>(raw_size);
-    }
-  }();
-
-  std::latch barrier{*safe_cast<std::ptrdiff_t>(policy.thread_num())};
-  FixedArray<T> offsets(policy.thread_num());
-  std::forward<ExecutionPolicy>(policy).execute_segmented(
-    size, [=, &barrier, &offsets](std::size_t thread_idx, auto begin, auto end) {
-      auto thread_first = first;
-      std::advance(thread_first, begin);
-
-      auto thread_last = first;
-      std::advance(thread_last, end);
-
-      const T part = std::transform_reduce(thread_first, thread_last, neutral, binary_op, unary_op);
-      offsets[thread_idx] = part;
-      barrier.arrive_and_wait();
-
-      const T offset =
-        std::reduce(offsets.begin(), offsets.begin() + thread_idx, neutral, binary_op);
-      auto thread_d_first = d_first;
-      std::advance(thread_d_first, begin);
-      std::transform_inclusive_scan(thread_first, thread_last, thread_d_first, binary_op, unary_op,
-                                    offset);
+                                     UnaryOperation unary_op, T neutral,
+                                     std::size_t tile_size = default_scan_tile_size) {
+  detail::decoupled_look_back_scan<T>(
+    std::forward<ExecutionPolicy>(policy), first, last, d_first, binary_op, unary_op, neutral,
+    tile_size,
+    [&binary_op, &unary_op](auto tile_first, auto tile_last, auto tile_d_first, T prefix) {
+      std::transform_inclusive_scan(tile_first, tile_last, tile_d_first, binary_op, unary_op,
+                                    std::move(prefix));
+    });
+}
+
+/**
+ * Compute the exclusive scan of `unary_op` applied to `[first, last)` with `binary_op`, starting
+ * from `init`, into the range starting at `d_first` in parallel, using a single-pass scan with
+ * decoupled look-back.
+ */
+template<typename T, typename ExecutionPolicy, typename ForwardIt1, typename ForwardIt2,
+         typename BinaryOperation, typename UnaryOperation>
+inline void transform_exclusive_scan(ExecutionPolicy&& policy, ForwardIt1 first, ForwardIt1 last,
+                                     ForwardIt2 d_first, T init, BinaryOperation binary_op,
+                                     UnaryOperation unary_op,
+                                     std::size_t tile_size = default_scan_tile_size) {
+  detail::decoupled_look_back_scan<T>(
+    std::forward<ExecutionPolicy>(policy), first, last, d_first, binary_op, unary_op, init,
+    tile_size,
+    [&binary_op, &unary_op](auto tile_first, auto tile_last, auto tile_d_first, T prefix) {
+      std::transform_exclusive_scan(tile_first, tile_last, tile_d_first, std::move(prefix),
+                                    binary_op, unary_op);
     });
 }
 } // namespace thes
@@ -0,0 +1,105 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_ALGORITHMS_TRANSFORM_REDUCE_HPP
+#define INCLUDE_THESAUROS_ALGORITHMS_TRANSFORM_REDUCE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/math/integer-cast.hpp"
+#include "thesauros/memory/cache-line.hpp"
+
+namespace thes {
+namespace detail {
+/** The size of `[first, last)` in the index type of the execution policy, if it defines one. */
+template<typename ExecutionPolicy, typename ForwardIt>
+inline auto execution_size(ForwardIt first, ForwardIt last) {
+  const auto raw_size = std::distance(first, last);
+  using ExPo = std::decay_t<ExecutionPolicy>;
+  if constexpr (requires { typename ExPo::Size; }) {
+    return *safe_cast<typename ExPo::Size>(raw_size);
+  } else {
+    using Size = std::make_unsigned_t<std::decay_t<decltype(raw_size)>>;
+    return *safe_cast<Size>(raw_size);
+  }
+}
+} // namespace detail
+
+/**
+ * Reduce `transform_op` applied to the elements of `[first, last)` and `init` with `reduce_op`,
+ * which has to be associative and commutative, as for `std::transform_reduce`.
+ *
+ * Each thread accumulates the chunks it is given by `policy.execute_chunked` into an accumulator
+ * on cache lines of its own, and the accumulators are combined pairwise in a tree afterwards,
+ * which keeps the rounding error of floating-point sums growing logarithmically in the number of
+ * threads. With `LinearExecutionPolicy`, the elements are combined in their order in the range.
+ */
+template<typename ExecutionPolicy, typename ForwardIt, typename T, typename BinaryReductionOp,
+         typename UnaryTransformOp>
+inline T transform_reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, T init,
+                          BinaryReductionOp reduce_op, UnaryTransformOp transform_op) {
+  const auto size = detail::execution_size<ExecutionPolicy>(first, last);
+  const std::size_t thread_num = policy.thread_num();
+
+  FixedArray<CacheAligned<std::optional<T>>> partials(thread_num);
+  std::forward<ExecutionPolicy>(policy).execute_chunked(
+    size, [&](std::size_t thread_idx, auto begin, auto end) {
+      auto chunk_first = first;
+      std::advance(chunk_first, begin);
+      auto chunk_last = chunk_first;
+      std::advance(chunk_last, end - begin);
+
+      // The first element seeds the chunk, as there is no neutral element to start from.
+      T chunk_init = std::invoke(transform_op, *chunk_first);
+      T part = std::transform_reduce(std::next(chunk_first), chunk_last, std::move(chunk_init),
+                                     reduce_op, transform_op);
+
+      std::optional<T>& partial = partials[thread_idx].value;
+      if (partial.has_value()) {
+        partial = std::invoke(reduce_op, std::move(*partial), std::move(part));
+      } else {
+        partial.emplace(std::move(part));
+      }
+    });
+
+  for (std::size_t stride = 1; stride < thread_num; stride *= 2) {
+    for (std::size_t i = 0; i + stride < thread_num; i += 2 * stride) {
+      std::optional<T>& lhs = partials[i].value;
+      std::optional<T>& rhs = partials[i + stride].value;
+      if (!rhs.has_value()) {
+        continue;
+      }
+      if (lhs.has_value()) {
+        lhs = std::invoke(reduce_op, std::move(*lhs), std::move(*rhs));
+      } else {
+        lhs = std::move(rhs);
+      }
+    }
+  }
+
+  if (thread_num == 0 || !partials[0].value.has_value()) {
+    return init;
+  }
+  return std::invoke(reduce_op, std::move(init), std::move(*partials[0].value));
+}
+
+/** Reduce the elements of `[first, last)` and `init` with `op` using `transform_reduce`. */
+template<typename ExecutionPolicy, typename ForwardIt, typename T, typename BinaryOp = std::plus<>>
+inline T reduce(ExecutionPolicy&& policy, ForwardIt first, ForwardIt last, T init,
+                BinaryOp op = {}) {
+  return transform_reduce(std::forward<ExecutionPolicy>(policy), first, last, std::move(init),
+                          std::move(op), std::identity{});
+}
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_ALGORITHMS_TRANSFORM_REDUCE_HPP
@@ -9,6 +9,7 @@
 #include "array/growth-policy.hpp"
 #include "array/initialization-policy.hpp"
 #include "array/limited.hpp"
+#include "array/small-dynamic.hpp"
 #include "array/typed-chunk.hpp"
 // IWYU pragma: end_exports
 
@@ -11,6 +11,7 @@
 #include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
@@ -21,6 +22,7 @@
 #include "thesauros/containers/array/initialization-policy.hpp"
 #include "thesauros/containers/array/typed-chunk.hpp"
 #include "thesauros/math/integer-cast.hpp"
+#include "thesauros/types/trivially-relocatable.hpp"
 
 namespace thes {
 /**
@@ -40,7 +42,9 @@ namespace thes {
  * sense if the elements are implicitly initialized by the initialization policy.
  *
  * The growth policy `GP` determines the growth behavior when e.g. `resize` or `push_back` are
- * called.
+ * called. When growing, trivially relocatable elements (see `TriviallyRelocatable`) are copied
+ * bytewise instead of being moved and destroyed, and if the allocator is a `ReallocatingAllocator`,
+ * it is given the chance to grow the allocation without copying at all, e.g. using `mremap`.
  */
 template<typename V, typename InitPol = DefaultInit, typename GrowthPol = DoublingGrowth,
          typename Alloc = std::allocator<V>>
@@ -81,9 +85,21 @@ struct DynamicArray {
   constexpr DynamicArray(Size size, const Allocator& alloc) : allocation_(size, alloc) {
     initialize_all();
   }
+  /** Initialize using the given instance of the initialization policy, e.g. `ParallelInit`. */
+  constexpr DynamicArray(Size size, const InitPol& init) : allocation_(size), init_(init) {
+    initialize_all();
+  }
+  constexpr DynamicArray(Size size, const InitPol& init, const Allocator& alloc)
+      : allocation_(size, alloc), init_(init) {
+    initialize_all();
+  }
 
   explicit constexpr DynamicArray(Size size, const V& value) : allocation_(size) {
-    std::uninitialized_fill(begin(), end(), value);
+    uninit_fill(value);
+  }
+  constexpr DynamicArray(Size size, const V& value, const InitPol& init)
+      : allocation_(size), init_(init) {
+    uninit_fill(value);
   }
 
   constexpr DynamicArray(std::initializer_list<Value> init) : allocation_(init.size()) {
@@ -91,13 +107,14 @@ struct DynamicArray {
   }
 
   constexpr DynamicArray(DynamicArray&& other) noexcept
-      : allocation_(std::move(other.allocation_)), data_end_(other.data_end_) {
+      : allocation_(std::move(other.allocation_)), data_end_(other.data_end_),
+        init_(other.init_) {
     other.data_end_ = nullptr;
   }
   // Only valid if the data is fully initialized.
   constexpr DynamicArray(const DynamicArray& other)
       : allocation_(other.allocation_.size(), other.allocation_.allocator()),
-        data_end_(allocation_.begin() + other.size()) {
+        data_end_(allocation_.begin() + other.size()), init_(other.init_) {
     const Value* other_begin = other.allocation_.begin();
     const Value* other_end = other.data_end_;
     std::uninitialized_copy(other_begin, other_end, allocation_.begin());
@@ -108,6 +125,7 @@ struct DynamicArray {
     allocation_.move_to_destroyed(std::move(other.allocation_));
     data_end_ = other.data_end_;
     other.data_end_ = nullptr;
+    init_ = other.init_;
     return *this;
   }
   // Only valid if the data is fully initialized.
@@ -117,6 +135,7 @@ struct DynamicArray {
       allocation_.reallocate_to_destroyed(other.allocation_);
       std::uninitialized_copy(other.allocation_.begin(), other.end(), allocation_.begin());
       data_end_ = allocation_.begin() + other.size();
+      init_ = other.init_;
     }
     return *this;
   }
@@ -130,6 +149,7 @@ struct DynamicArray {
     using std::swap;
     swap(lhs.allocation_, rhs.allocation_);
     swap(lhs.data_end_, rhs.data_end_);
+    swap(lhs.init_, rhs.init_);
   }
 
   template<typename... Args>
@@ -159,6 +179,13 @@ struct DynamicArray {
     return allocation_.begin() == data_end_;
   }
 
+  [[nodiscard]] constexpr const Allocator& allocator() const noexcept {
+    return allocation_.allocator();
+  }
+  [[nodiscard]] constexpr const InitPolicy& initialization_policy() const noexcept {
+    return init_;
+  }
+
   [[nodiscard]] constexpr auto data(this auto&& self) {
     return self.allocation_.data();
   }
@@ -212,7 +239,7 @@ struct DynamicArray {
       data_end_ = new_data_end;
     } else {
       const Size old_size = size();
-      allocation_expand(new_size, [old_size, new_size](iterator new_begin) {
+      allocation_expand(new_size, [this, old_size, new_size](iterator new_begin) {
         initialize(new_begin + old_size, new_begin + new_size);
       });
       data_end_ = allocation_.begin() + new_size;
@@ -249,6 +276,13 @@ struct DynamicArray {
     if (new_size <= allocation_.size()) {
       new (data_end_) Value(std::forward<Args>(args)...);
       ++data_end_;
+    } else if constexpr (can_reallocate) {
+      // The arguments may refer to elements, which are gone once the memory has been reallocated.
+      Value value(std::forward<Args>(args)...);
+      allocation_expand(new_size, [old_size, &value](iterator new_begin) {
+        new (new_begin + old_size) Value(std::move(value));
+      });
+      data_end_ = allocation_.begin() + new_size;
     } else {
       allocation_expand(new_size, [old_size, &args...](iterator new_begin) {
         new (new_begin + old_size) Value(std::forward<Args>(args)...);
@@ -375,9 +409,40 @@ struct DynamicArray {
   }
 
 private:
+  static constexpr bool can_reallocate =
+    TriviallyRelocatable<Value> && ReallocatingAllocator<Allocator>;
+
+  /**
+   * Grow the allocation to hold at least `new_size` elements, moving the existing elements and
+   * calling `initializer` with the new beginning to construct the new ones.
+   */
   constexpr void allocation_expand(const Size new_size, auto&& initializer) {
+    const Size new_alloc = grown_size(new_size);
+    if constexpr (TriviallyRelocatable<Value>) {
+      if !consteval {
+        const Size old_size = size();
+        if constexpr (can_reallocate) {
+          if (allocation_.try_reallocate(new_alloc)) {
+            // Keep the array valid in case the initializer throws.
+            data_end_ = allocation_.begin() + old_size;
+            initializer(allocation_.begin());
+            return;
+          }
+        }
+        allocation_.expand(new_alloc,
+                           [&](iterator old_begin, iterator /*old_end*/, iterator new_begin) {
+                             // The old elements are not destroyed, as their bytes live on.
+                             if (old_size > 0) {
+                               std::memcpy(static_cast<void*>(new_begin), old_begin,
+                                           old_size * sizeof(Value));
+                             }
+                             initializer(new_begin);
+                           });
+        return;
+      }
+    }
     allocation_.expand(
-      grown_size(new_size),
+      new_alloc,
       [&, old_data_end = data_end_](iterator old_begin, iterator /*old_end*/, iterator new_begin) {
         std::uninitialized_move(old_begin, old_data_end, new_begin);
         initializer(new_begin);
@@ -388,12 +453,21 @@ private:
   constexpr void initialize_all() {
     initialize(allocation_.begin(), data_end_);
   }
-  static constexpr void initialize(iterator begin, iterator end) {
-    InitPolicy::initialize(begin, end);
+  constexpr void initialize(iterator begin, iterator end) const {
+    init_.initialize(begin, end);
+  }
+  /** Fill the whole allocation, using the initialization policy if it knows how to. */
+  constexpr void uninit_fill(const Value& value) {
+    if constexpr (requires { init_.fill(allocation_.begin(), allocation_.end(), value); }) {
+      init_.fill(allocation_.begin(), allocation_.end(), value);
+    } else {
+      std::uninitialized_fill(allocation_.begin(), allocation_.end(), value);
+    }
   }
 
   constexpr Size grown_size(Size new_size_lower_bound) const {
-    return GrowthPolicy::new_allocation_size(size(), new_size_lower_bound);
+    return growth_allocation_size<GrowthPolicy, Value>(size(), new_size_lower_bound,
+                                                       allocation_.allocator());
   }
 
   // Only valid if the data is fully initialized.
@@ -407,6 +481,7 @@ private:
 
   Data allocation_{};
   Value* data_end_{allocation_.end()};
+  [[no_unique_address]] InitPol init_{};
 };
 } // namespace thes
 
@@ -55,6 +55,14 @@ struct FixedArray {
   constexpr FixedArray(Size size, const Allocator& alloc) : allocation_(size, alloc) {
     initialize_all();
   }
+  /** Initialize using the given instance of the initialization policy, e.g. `ParallelInit`. */
+  constexpr FixedArray(Size size, const InitPol& init) : allocation_(size), init_(init) {
+    initialize_all();
+  }
+  constexpr FixedArray(Size size, const InitPol& init, const Allocator& alloc)
+      : allocation_(size, alloc), init_(init) {
+    initialize_all();
+  }
 
   template<typename Other>
   explicit constexpr FixedArray(Size size, const Other& value) : allocation_(size) {
@@ -70,6 +78,11 @@ struct FixedArray {
       : allocation_(size, alloc) {
     uninit_fill(value);
   }
+  template<typename Other>
+  constexpr FixedArray(Size size, const Other& value, const InitPol& init)
+      : allocation_(size), init_(init) {
+    uninit_fill(value);
+  }
 
   constexpr FixedArray(std::initializer_list<Value> init) : allocation_(init.size()) {
     std::uninitialized_copy(init.begin(), init.end(), begin());
@@ -84,9 +97,11 @@ struct FixedArray {
     }
   }
 
-  constexpr FixedArray(FixedArray&& other) noexcept : allocation_(std::move(other.allocation_)) {}
+  constexpr FixedArray(FixedArray&& other) noexcept
+      : allocation_(std::move(other.allocation_)), init_(other.init_) {}
   // Only valid if the data is fully initialized.
-  constexpr FixedArray(const FixedArray& other) : allocation_(other.allocation_.size()) {
+  constexpr FixedArray(const FixedArray& other)
+      : allocation_(other.allocation_.size()), init_(other.init_) {
     std::uninitialized_copy(other.allocation_.begin(), other.allocation_.end(),
                             allocation_.begin());
   }
@@ -94,6 +109,7 @@ struct FixedArray {
   constexpr FixedArray& operator=(FixedArray&& other) noexcept {
     allocation_.destroy_initialized();
     allocation_.move_to_destroyed(std::move(other.allocation_));
+    init_ = other.init_;
     return *this;
   }
   // Only valid if the data is fully initialized.
@@ -103,6 +119,7 @@ struct FixedArray {
       allocation_.reallocate_to_destroyed(other.allocation_);
       std::uninitialized_copy(other.allocation_.begin(), other.allocation_.end(),
                               allocation_.begin());
+      init_ = other.init_;
     }
     return *this;
   }
@@ -132,6 +149,7 @@ struct FixedArray {
   friend constexpr void swap(FixedArray& lhs, FixedArray& rhs) noexcept {
     using std::swap;
     swap(lhs.allocation_, rhs.allocation_);
+    swap(lhs.init_, rhs.init_);
   }
 
   [[nodiscard]] constexpr Size size() const noexcept {
@@ -141,6 +159,10 @@ struct FixedArray {
     return allocation_.empty();
   }
 
+  [[nodiscard]] constexpr const InitPolicy& initialization_policy() const noexcept {
+    return init_;
+  }
+
   [[nodiscard]] constexpr auto data(this auto&& self) {
     return self.allocation_.data();
   }
@@ -182,16 +204,25 @@ private:
   constexpr void initialize_all() {
     initialize(allocation_.begin(), allocation_.end());
   }
-  static constexpr void initialize(iterator begin, iterator end) {
-    InitPolicy::initialize(begin, end);
+  constexpr void initialize(iterator begin, iterator end) const {
+    init_.initialize(begin, end);
   }
 
+  /** Fill the whole allocation, using the initialization policy if it knows how to. */
   template<typename Other>
   constexpr void uninit_fill(const Other& value) {
-    std::uninitialized_fill(allocation_.begin(), allocation_.end(), value);
+    if constexpr (requires(const Value& v) {
+                    init_.fill(allocation_.begin(), allocation_.end(), v);
+                  }) {
+      const Value converted(value);
+      init_.fill(allocation_.begin(), allocation_.end(), converted);
+    } else {
+      std::uninitialized_fill(allocation_.begin(), allocation_.end(), value);
+    }
   }
 
   Data allocation_{};
+  [[no_unique_address]] InitPol init_{};
 };
 } // namespace thes
 
@@ -7,6 +7,7 @@
 #ifndef INCLUDE_THESAUROS_CONTAINERS_ARRAY_GROWTH_POLICY_HPP
 #define INCLUDE_THESAUROS_CONTAINERS_ARRAY_GROWTH_POLICY_HPP
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 
@@ -29,6 +30,117 @@ struct DoublingGrowth {
     return one << logarithm;
   }
 };
+
+/**
+ * The allocation size chosen by the growth policy `GP` for an array of elements of type `V` which
+ * grows from `old_size` elements to at least `new_size_lower_bound` elements using `alloc`.
+ *
+ * Policies that depend on the element type or the allocator provide
+ * `new_allocation_size<V>(old_size, new_size_lower_bound, alloc)`, all others only
+ * `new_allocation_size(old_size, new_size_lower_bound)`.
+ */
+template<typename GP, typename V, typename Alloc>
+constexpr std::size_t growth_allocation_size(std::size_t old_size,
+                                             std::size_t new_size_lower_bound,
+                                             const Alloc& alloc) {
+  if constexpr (requires {
+                  GP::template new_allocation_size<V>(old_size, new_size_lower_bound, alloc);
+                }) {
+    return GP::template new_allocation_size<V>(old_size, new_size_lower_bound, alloc);
+  } else {
+    return GP::new_allocation_size(old_size, new_size_lower_bound);
+  }
+}
+
+/**
+ * Grows the allocation by the factor `Num / Den` (or to the lower bound if that is larger), e.g.
+ * by 1.5 for `ProportionalGrowth<3, 2>`, which wastes less memory than `DoublingGrowth`.
+ */
+template<std::size_t Num, std::size_t Den>
+requires(Num > Den && Den > 0)
+struct ProportionalGrowth {
+  using Size = std::size_t;
+
+  static constexpr Size new_allocation_size(Size old_size, Size new_size_lower_bound) {
+    assert(new_size_lower_bound > old_size);
+    if (old_size / Den > NumericInfo<Size>::max / Num) {
+      return NumericInfo<Size>::max;
+    }
+    const Size grown = (old_size > NumericInfo<Size>::max / Num) ? old_size / Den * Num
+                                                                 : old_size * Num / Den;
+    return std::max(grown, new_size_lower_bound);
+  }
+};
+using OneAndHalfGrowth = ProportionalGrowth<3, 2>;
+
+/**
+ * Grows like `Base`, but rounds the allocation up to a multiple of `PageBytes` bytes, so that the
+ * memory occupied by the last page, which is part of the allocation anyway, can be used.
+ */
+template<typename Base = DoublingGrowth, std::size_t PageBytes = std::size_t{1} << 12U>
+struct PageRoundedGrowth {
+  using Size = std::size_t;
+  static constexpr Size page_bytes = PageBytes;
+
+  template<typename V, typename Alloc>
+  static constexpr Size new_allocation_size(Size old_size, Size new_size_lower_bound,
+                                            const Alloc& alloc) {
+    const Size size = growth_allocation_size<Base, V>(old_size, new_size_lower_bound, alloc);
+    if (size > (NumericInfo<Size>::max - page_bytes) / sizeof(V)) {
+      return size;
+    }
+    const Size bytes = (size * sizeof(V) + page_bytes - 1) / page_bytes * page_bytes;
+    return bytes / sizeof(V);
+  }
+};
+/** Rounds up to a multiple of the 2 MiB huge page size, e.g. for `HugePagesAllocator`. */
+template<typename Base = DoublingGrowth>
+using HugePageRoundedGrowth = PageRoundedGrowth<Base, std::size_t{1} << 21U>;
+
+/**
+ * Grows like `Base`, but by at most `MaxIncrementBytes` bytes at a time (unless more are needed),
+ * so that large arrays do not reserve memory in proportion to their size, e.g. 40 GB for a 40 GB
+ * array with `DoublingGrowth`. The number of reallocations then grows linearly with the size
+ * beyond the cap, which is cheap if the allocator can grow allocations in place, e.g. using
+ * `mremap` in `HugePagesAllocator`.
+ */
+template<typename Base = DoublingGrowth, std::size_t MaxIncrementBytes = std::size_t{1} << 30U>
+struct CappedGrowth {
+  using Size = std::size_t;
+  static constexpr Size max_increment_bytes = MaxIncrementBytes;
+
+  template<typename V, typename Alloc>
+  static constexpr Size new_allocation_size(Size old_size, Size new_size_lower_bound,
+                                            const Alloc& alloc) {
+    const Size size = growth_allocation_size<Base, V>(old_size, new_size_lower_bound, alloc);
+    const Size max_increment = std::max<Size>(max_increment_bytes / sizeof(V), 1);
+    if (old_size > NumericInfo<Size>::max - max_increment) {
+      return size;
+    }
+    return std::max(std::min(size, old_size + max_increment), new_size_lower_bound);
+  }
+};
+
+/**
+ * Grows like `Base`, but extends the allocation to the number of elements that the allocator
+ * provides for an allocation of that size anyway, if the allocator can tell by providing
+ * `usable_size(n)`, as `MallocAllocator` and `HugePagesAllocator` do.
+ */
+template<typename Base = DoublingGrowth>
+struct UsableSizeGrowth {
+  using Size = std::size_t;
+
+  template<typename V, typename Alloc>
+  static constexpr Size new_allocation_size(Size old_size, Size new_size_lower_bound,
+                                            const Alloc& alloc) {
+    const Size size = growth_allocation_size<Base, V>(old_size, new_size_lower_bound, alloc);
+    if constexpr (requires { alloc.usable_size(size); }) {
+      return std::max<Size>(alloc.usable_size(size), size);
+    } else {
+      return size;
+    }
+  }
+};
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_CONTAINERS_ARRAY_GROWTH_POLICY_HPP
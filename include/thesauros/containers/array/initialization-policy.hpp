@@ -7,7 +7,12 @@
 #ifndef INCLUDE_THESAUROS_CONTAINERS_ARRAY_INITIALIZATION_POLICY_HPP
 #define INCLUDE_THESAUROS_CONTAINERS_ARRAY_INITIALIZATION_POLICY_HPP
 
+#include <concepts>
+#include <cstddef>
 #include <memory>
+#include <type_traits>
+
+#include "thesauros/memory/non-temporal.hpp"
 
 namespace thes {
 struct ValueInit {
@@ -28,6 +33,78 @@ struct NoInit {
   template<typename T>
   static constexpr void initialize(T* /*begin*/, T* /*end*/) {}
 };
+
+/**
+ * An initialization policy which initializes like `Base`, but splits the range into segments that
+ * are initialized concurrently using the execution policy `ExPo`, which has to provide
+ * `execute_segmented`. This also places the pages of a fresh allocation on the NUMA nodes of the
+ * threads that work on them later if the same execution policy is used.
+ *
+ * In contrast to the other policies, this one has state, which is passed to the constructors of
+ * the arrays. A default-constructed `ParallelInit` initializes sequentially.
+ *
+ * Value-initialized and filled ranges of trivially copyable types spanning at least
+ * `non_temporal_bytes` are written using non-temporal stores.
+ */
+template<typename Base, typename ExPo>
+struct ParallelInit {
+  using BasePolicy = Base;
+  using ExecutionPolicy = ExPo;
+
+  static constexpr std::size_t non_temporal_bytes = std::size_t{1} << 20U; // 1 MiB
+
+  ParallelInit() = default;
+  /** The policy refers to `expo`, which therefore has to outlive it. */
+  explicit ParallelInit(const ExPo& expo) : expo_(&expo) {}
+
+  template<typename T>
+  void initialize(T* begin, T* end) const {
+    if constexpr (std::same_as<Base, ValueInit> && std::is_trivially_copyable_v<T> &&
+                  std::is_default_constructible_v<T>) {
+      fill(begin, end, T());
+    } else if constexpr (!std::same_as<Base, NoInit> &&
+                         !(std::same_as<Base, DefaultInit> &&
+                           std::is_trivially_default_constructible_v<T>)) {
+      for_each_segment(begin, end, [](T* seg_begin, T* seg_end) {
+        Base::initialize(seg_begin, seg_end);
+      });
+    }
+  }
+
+  /** Fill the uninitialized range `[begin, end)` with copies of `value`. */
+  template<typename T>
+  void fill(T* begin, T* end, const T& value) const {
+    const bool non_temporal = std::size_t(end - begin) * sizeof(T) >= non_temporal_bytes;
+    for_each_segment(begin, end, [&value, non_temporal](T* seg_begin, T* seg_end) {
+      if constexpr (std::is_trivially_copyable_v<T>) {
+        if (non_temporal) {
+          non_temporal_fill(seg_begin, seg_end, value);
+          return;
+        }
+      }
+      std::uninitialized_fill(seg_begin, seg_end, value);
+    });
+  }
+
+  [[nodiscard]] const ExPo* execution_policy() const {
+    return expo_;
+  }
+
+private:
+  template<typename T>
+  void for_each_segment(T* begin, T* end, auto op) const {
+    if (expo_ == nullptr) {
+      op(begin, end);
+      return;
+    }
+    const auto segment = [begin, &op](std::size_t /*thread_idx*/, auto seg_begin, auto seg_end) {
+      op(begin + seg_begin, begin + seg_end);
+    };
+    expo_->execute_segmented(std::size_t(end - begin), segment);
+  }
+
+  const ExPo* expo_{nullptr};
+};
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_CONTAINERS_ARRAY_INITIALIZATION_POLICY_HPP
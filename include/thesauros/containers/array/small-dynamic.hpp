@@ -0,0 +1,518 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_CONTAINERS_ARRAY_SMALL_DYNAMIC_HPP
+#define INCLUDE_THESAUROS_CONTAINERS_ARRAY_SMALL_DYNAMIC_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "thesauros/containers/array/growth-policy.hpp"
+#include "thesauros/containers/array/initialization-policy.hpp"
+#include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/math/integer-cast.hpp"
+
+namespace thes {
+/**
+ * A dynamic array which stores up to `InlineCapacity` elements within the object itself and only
+ * allocates memory once it grows beyond that, which avoids the allocator for arrays that are
+ * small most of the time, such as adjacency lists.
+ *
+ * Apart from that, it behaves like `DynamicArray` with the same policies and constructors: The
+ * initialization policy `InitPol` initializes newly created elements, including filling them with
+ * a value, the growth policy `GrowthPol` determines the allocation size once the array no longer
+ * fits into the inline storage, and the same assumptions about the state of the elements apply,
+ * e.g. elements of a `NoInit` array have to be constructed using `initial_emplace`.
+ *
+ * Once allocated, the memory is kept until `clear_memory` is called, even if the elements would
+ * fit into the inline storage again. In contrast to `DynamicArray`, moving an array whose
+ * elements are stored inline moves the elements one by one.
+ */
+template<typename V, std::size_t InlineCapacity, typename InitPol = DefaultInit,
+         typename GrowthPol = DoublingGrowth, typename Alloc = std::allocator<V>>
+requires(InlineCapacity > 0)
+struct SmallDynamicArray {
+  using Data = TypedChunk<V, std::size_t, Alloc>;
+
+  using Value = Data::Value;
+  using Size = Data::Size;
+  using Allocator = Data::Allocator;
+
+  using value_type = Value;
+  using allocator_type = Allocator;
+  using size_type = Size;
+  using difference_type = std::iter_difference_t<V*>;
+  using reference = Value&;
+  using const_reference = const Value&;
+  using pointer = Value*;
+  using const_pointer = const Value*;
+
+  using iterator = Data::iterator;
+  using const_iterator = Data::const_iterator;
+
+  using InitPolicy = InitPol;
+  using GrowthPolicy = GrowthPol;
+
+  static constexpr Size inline_capacity = InlineCapacity;
+
+  constexpr SmallDynamicArray() = default;
+  explicit constexpr SmallDynamicArray(const Allocator& alloc) : heap_(alloc) {}
+  explicit constexpr SmallDynamicArray(Allocator&& alloc) : heap_(std::forward<Allocator>(alloc)) {}
+
+  explicit constexpr SmallDynamicArray(Size size) {
+    allocate_for(size);
+    initialize_all();
+  }
+  constexpr SmallDynamicArray(Size size, Allocator&& alloc)
+      : heap_(std::forward<Allocator>(alloc)) {
+    allocate_for(size);
+    initialize_all();
+  }
+  constexpr SmallDynamicArray(Size size, const Allocator& alloc) : heap_(alloc) {
+    allocate_for(size);
+    initialize_all();
+  }
+  /** Initialize using the given instance of the initialization policy, e.g. `ParallelInit`. */
+  constexpr SmallDynamicArray(Size size, const InitPol& init) : init_(init) {
+    allocate_for(size);
+    initialize_all();
+  }
+  constexpr SmallDynamicArray(Size size, const InitPol& init, const Allocator& alloc)
+      : heap_(alloc), init_(init) {
+    allocate_for(size);
+    initialize_all();
+  }
+
+  explicit constexpr SmallDynamicArray(Size size, const V& value) {
+    allocate_for(size);
+    uninit_fill(value);
+  }
+  constexpr SmallDynamicArray(Size size, const V& value, const InitPol& init) : init_(init) {
+    allocate_for(size);
+    uninit_fill(value);
+  }
+
+  constexpr SmallDynamicArray(std::initializer_list<Value> init) {
+    allocate_for(init.size());
+    std::uninitialized_copy(init.begin(), init.end(), begin());
+  }
+
+  constexpr SmallDynamicArray(SmallDynamicArray&& other) noexcept(
+    std::is_nothrow_move_constructible_v<Value>)
+      : size_(other.size_), heap_(std::move(other.heap_)), init_(other.init_) {
+    if (is_inline()) {
+      std::uninitialized_move(other.begin(), other.end(), inline_begin());
+      other.destroy();
+    }
+    other.size_ = 0;
+  }
+  // Only valid if the data is fully initialized.
+  constexpr SmallDynamicArray(const SmallDynamicArray& other)
+      : heap_(other.heap_.allocator()), init_(other.init_) {
+    allocate_for(other.size());
+    std::uninitialized_copy(other.begin(), other.end(), begin());
+  }
+
+  constexpr SmallDynamicArray& operator=(SmallDynamicArray&& other) noexcept(
+    std::is_nothrow_move_constructible_v<Value>) {
+    if (this == &other) {
+      return *this;
+    }
+    destroy();
+    if (other.is_inline()) {
+      heap_.deallocate();
+      heap_.copy_allocator(other.heap_.allocator());
+      std::uninitialized_move(other.begin(), other.end(), inline_begin());
+      other.destroy();
+    } else {
+      heap_.move_to_destroyed(std::move(other.heap_));
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+    init_ = other.init_;
+    return *this;
+  }
+  // Only valid if the data is fully initialized.
+  constexpr SmallDynamicArray& operator=(const SmallDynamicArray& other) {
+    if (this != &other) {
+      SmallDynamicArray copy(other);
+      *this = std::move(copy);
+    }
+    return *this;
+  }
+
+  // Only valid if the data is fully initialized.
+  constexpr ~SmallDynamicArray() {
+    destroy();
+  }
+
+  friend constexpr void swap(SmallDynamicArray& lhs, SmallDynamicArray& rhs) noexcept(
+    std::is_nothrow_move_constructible_v<Value>) {
+    if (!lhs.is_inline() && !rhs.is_inline()) {
+      using std::swap;
+      swap(lhs.heap_, rhs.heap_);
+      swap(lhs.size_, rhs.size_);
+      swap(lhs.init_, rhs.init_);
+      return;
+    }
+    SmallDynamicArray tmp(std::move(lhs));
+    lhs = std::move(rhs);
+    rhs = std::move(tmp);
+  }
+
+  template<typename... Args>
+  void initial_emplace(Size index, Args&&... args)
+  requires(std::same_as<InitPol, NoInit>)
+  {
+    new (this->begin() + index) Value(std::forward<Args>(args)...);
+  }
+  void initialize(Size index, Value&& value)
+  requires(std::same_as<InitPol, NoInit>)
+  {
+    initial_emplace(index, std::forward<Value>(value));
+  }
+  void initialize(Size index, const Value& value)
+  requires(std::same_as<InitPol, NoInit>)
+  {
+    initial_emplace(index, value);
+  }
+
+  [[nodiscard]] constexpr Size size() const noexcept {
+    return size_;
+  }
+  [[nodiscard]] constexpr Size allocation_size() const noexcept {
+    return is_inline() ? inline_capacity : heap_.size();
+  }
+  [[nodiscard]] constexpr bool empty() const noexcept {
+    return size_ == 0;
+  }
+  /** Whether the elements are stored within the object, i.e. no memory has been allocated. */
+  [[nodiscard]] constexpr bool is_inline() const noexcept {
+    return heap_.data() == nullptr;
+  }
+
+  [[nodiscard]] constexpr const Allocator& allocator() const noexcept {
+    return heap_.allocator();
+  }
+  [[nodiscard]] constexpr const InitPolicy& initialization_policy() const noexcept {
+    return init_;
+  }
+
+  template<typename Self>
+  [[nodiscard]] constexpr std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>,
+                                             const_pointer, pointer>
+  data(this Self&& self) noexcept {
+    return self.storage_begin();
+  }
+
+  template<typename Self>
+  [[nodiscard]] constexpr std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>,
+                                             const_iterator, iterator>
+  begin(this Self&& self) noexcept {
+    return self.storage_begin();
+  }
+  template<typename Self>
+  [[nodiscard]] constexpr std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>,
+                                             const_iterator, iterator>
+  end(this Self&& self) noexcept {
+    return self.storage_begin() + self.size_;
+  }
+
+  template<typename Self>
+  [[nodiscard]] constexpr std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>,
+                                             const_reference, reference>
+  operator[](this Self&& self, Size index) {
+    assert(index < self.size());
+    return self.storage_begin()[index];
+  }
+
+  template<typename Self>
+  [[nodiscard]] constexpr std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>,
+                                             const_reference, reference>
+  front(this Self&& self) {
+    assert(!self.empty());
+    return *self.storage_begin();
+  }
+  template<typename Self>
+  [[nodiscard]] constexpr std::conditional_t<std::is_const_v<std::remove_reference_t<Self>>,
+                                             const_reference, reference>
+  back(this Self&& self) {
+    assert(!self.empty());
+    return self.storage_begin()[self.size_ - 1];
+  }
+
+  [[nodiscard]] friend constexpr bool operator==(const SmallDynamicArray& lhs,
+                                                 const SmallDynamicArray& rhs) {
+    return std::ranges::equal(lhs, rhs);
+  }
+
+  constexpr void clear() {
+    destroy();
+    size_ = 0;
+  }
+  /** Destroy all elements and free the allocated memory, if any. */
+  constexpr void clear_memory() {
+    destroy();
+    heap_.deallocate();
+    size_ = 0;
+  }
+
+  constexpr void expand(Size new_size) {
+    assert(new_size > size());
+    const Size old_size = size_;
+    if (new_size <= allocation_size()) {
+      initialize(begin() + old_size, begin() + new_size);
+    } else {
+      allocation_expand(new_size, [this, old_size, new_size](iterator new_begin) {
+        initialize(new_begin + old_size, new_begin + new_size);
+      });
+    }
+    size_ = new_size;
+  }
+  constexpr void shrink(Size new_size) {
+    assert(new_size < size());
+    std::destroy(begin() + new_size, end());
+    size_ = new_size;
+  }
+  constexpr void resize(Size new_size) {
+    if (new_size < size()) {
+      shrink(new_size);
+    }
+    if (new_size > size()) {
+      expand(new_size);
+    }
+  }
+
+  constexpr void reserve(Size new_alloc) {
+    if (new_alloc > allocation_size()) {
+      storage_expand(new_alloc, [this](iterator old_begin, iterator new_begin) {
+        std::uninitialized_move(old_begin, old_begin + size_, new_begin);
+        std::destroy(old_begin, old_begin + size_);
+      });
+    }
+  }
+
+  template<typename... Args>
+  constexpr Value& emplace_back(Args&&... args) {
+    const Size old_size = size_;
+    if (!is_allocation_full()) {
+      std::construct_at(end(), std::forward<Args>(args)...);
+    } else {
+      // The arguments may refer to elements, which are only destroyed after the construction.
+      allocation_expand(old_size + 1, [old_size, &args...](iterator new_begin) {
+        std::construct_at(new_begin + old_size, std::forward<Args>(args)...);
+      });
+    }
+    ++size_;
+    return back();
+  }
+  constexpr Value& push_back(Value&& value) {
+    return emplace_back(std::forward<Value>(value));
+  }
+  constexpr Value& push_back(const Value& value) {
+    return emplace_back(value);
+  }
+  constexpr void pop_back() {
+    assert(!empty());
+    --size_;
+    std::destroy_at(end());
+  }
+
+  constexpr iterator erase(iterator pos) {
+    assert(pos != end());
+    std::move(pos + 1, end(), pos);
+    pop_back();
+    return pos;
+  }
+  /**
+   * Erases `[first, last)` and returns an iterator to the element that followed the erased range,
+   * which is `first` once the trailing elements have moved down.
+   */
+  constexpr iterator erase(iterator first, iterator last) {
+    assert(first <= last);
+    assert(last <= end());
+    iterator new_end = std::move(last, end(), first);
+    std::destroy(new_end, end());
+    size_ = static_cast<Size>(new_end - begin());
+    return first;
+  }
+
+  /**
+   * Inserts `ins_size` elements before `pos` and appends `pad_end` elements at the end, all of
+   * which are created by the initialization policy, and returns an iterator to the first inserted
+   * element.
+   */
+  constexpr iterator insert_any(const_iterator pos, Size ins_size, Size pad_end = 0) {
+    const auto offset = pos - begin();
+    const Size old_size = size_;
+    const Size add_size = ins_size + pad_end;
+    const Size new_size = old_size + add_size;
+
+    if (new_size <= allocation_size()) {
+      iterator mut_pos = begin() + offset;
+      iterator data_end = end();
+      // See `DynamicArray::insert_any`: The trailing elements move past the old end into raw
+      // storage, and the moved-from elements left in the gap are replaced.
+      const Size moved_size = std::min(old_size - *safe_cast<Size>(offset), ins_size);
+      iterator moved_begin = data_end - moved_size;
+
+      std::uninitialized_move(moved_begin, data_end, moved_begin + ins_size);
+      std::move_backward(mut_pos, moved_begin, moved_begin + ins_size);
+      size_ = new_size;
+
+      std::destroy(mut_pos, mut_pos + moved_size);
+      initialize(mut_pos, mut_pos + ins_size);
+      initialize(end() - pad_end, end());
+      return mut_pos;
+    }
+
+    storage_expand(grown_size(new_size), [&](iterator old_begin, iterator new_begin) {
+      iterator old_pos = old_begin + offset;
+      iterator old_end = old_begin + old_size;
+      iterator moved_start = new_begin + offset;
+      iterator moved_end = moved_start + ins_size;
+
+      std::uninitialized_move(old_begin, old_pos, new_begin);
+      initialize(moved_start, moved_end);
+      std::uninitialized_move(old_pos, old_end, moved_end);
+      initialize(new_begin + (old_size + ins_size), new_begin + new_size);
+
+      std::destroy(old_begin, old_end);
+    });
+    size_ = new_size;
+    return begin() + offset;
+  }
+
+  constexpr iterator insert(const_iterator pos, Value value) {
+    const auto offset = pos - begin();
+    const Size old_size = size_;
+
+    if (old_size < allocation_size()) {
+      iterator mut_pos = begin() + offset;
+      iterator data_end = end();
+      ++size_;
+      if (mut_pos == data_end) {
+        std::construct_at(data_end, std::move(value));
+        return mut_pos;
+      }
+      // The last element moves into raw storage and thus has to be constructed there, while the
+      // remaining ones can be move-assigned.
+      std::construct_at(data_end, std::move(*(data_end - 1)));
+      std::move_backward(mut_pos, data_end - 1, data_end);
+      *mut_pos = std::move(value);
+      return mut_pos;
+    }
+
+    storage_expand(grown_size(old_size + 1), [&](iterator old_begin, iterator new_begin) {
+      iterator old_pos = old_begin + offset;
+      iterator old_end = old_begin + old_size;
+      iterator target = new_begin + offset;
+
+      std::uninitialized_move(old_begin, old_pos, new_begin);
+      std::uninitialized_move(old_pos, old_end, target + 1);
+      std::construct_at(target, std::move(value));
+
+      std::destroy(old_begin, old_end);
+    });
+    ++size_;
+    return begin() + offset;
+  }
+
+private:
+  /** Uninitialized storage for the inline elements, which are constructed and destroyed by us. */
+  union InlineStorage {
+    // NOLINTNEXTLINE(*-member-init)
+    constexpr InlineStorage() {}
+    constexpr ~InlineStorage() {}
+
+    InlineStorage(const InlineStorage&) = delete;
+    InlineStorage(InlineStorage&&) = delete;
+    InlineStorage& operator=(const InlineStorage&) = delete;
+    InlineStorage& operator=(InlineStorage&&) = delete;
+
+    Value values[inline_capacity]; // NOLINT(*-c-arrays)
+  };
+
+  [[nodiscard]] constexpr Value* inline_begin() const noexcept {
+    // The storage is only modified through non-const member functions.
+    return const_cast<Value*>(static_cast<const Value*>(inline_.values)); // NOLINT(*-const-cast)
+  }
+  [[nodiscard]] constexpr Value* storage_begin() const noexcept {
+    return is_inline() ? inline_begin() : heap_.mutable_data();
+  }
+
+  /** Allocate memory if `size` elements do not fit inline, and set the size to `size`. */
+  constexpr void allocate_for(Size size) {
+    if (size > inline_capacity) {
+      heap_.allocate_to_empty(size);
+    }
+    size_ = size;
+  }
+
+  /**
+   * Move to newly allocated memory for `new_alloc` elements, where `mover` is called with the
+   * beginnings of the old and the new memory and has to move the elements and destroy the old
+   * ones, like for `TypedChunk::expand`.
+   */
+  constexpr void storage_expand(Size new_alloc, auto&& mover) {
+    assert(new_alloc > allocation_size());
+    Data new_heap(new_alloc, heap_.allocator());
+    mover(storage_begin(), new_heap.begin());
+    using std::swap;
+    swap(heap_, new_heap);
+  }
+  constexpr void allocation_expand(Size new_size, auto&& initializer) {
+    storage_expand(grown_size(new_size), [&](iterator old_begin, iterator new_begin) {
+      std::uninitialized_move(old_begin, old_begin + size_, new_begin);
+      initializer(new_begin);
+      std::destroy(old_begin, old_begin + size_);
+    });
+  }
+
+  constexpr void initialize_all() {
+    initialize(begin(), end());
+  }
+  constexpr void initialize(iterator begin, iterator end) const {
+    init_.initialize(begin, end);
+  }
+  constexpr void uninit_fill(const Value& value) {
+    if constexpr (requires { init_.fill(begin(), end(), value); }) {
+      init_.fill(begin(), end(), value);
+    } else {
+      std::uninitialized_fill(begin(), end(), value);
+    }
+  }
+
+  constexpr Size grown_size(Size new_size_lower_bound) const {
+    return growth_allocation_size<GrowthPolicy, Value>(size(), new_size_lower_bound,
+                                                       heap_.allocator());
+  }
+
+  // Only valid if the data is fully initialized.
+  constexpr void destroy() {
+    std::destroy(begin(), end());
+  }
+
+  [[nodiscard]] constexpr bool is_allocation_full() const {
+    return size_ == allocation_size();
+  }
+
+  Size size_{0};
+  Data heap_{};
+  [[no_unique_address]] InitPol init_{};
+  InlineStorage inline_{};
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_CONTAINERS_ARRAY_SMALL_DYNAMIC_HPP
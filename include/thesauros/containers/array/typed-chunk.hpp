@@ -8,17 +8,36 @@
 #define INCLUDE_THESAUROS_CONTAINERS_ARRAY_TYPED_CHUNK_HPP
 
 #include <cassert>
+#include <concepts>
+#include <cstddef>
 #include <memory>
 #include <span>
 #include <type_traits>
 #include <utility>
 
 namespace thes {
+/**
+ * An allocator which can resize an allocation without copying the elements itself, e.g. using
+ * `realloc` or `mremap`.
+ *
+ * `alloc.reallocate(p, old_n, new_n)` returns memory for `new_n` elements whose first `old_n`
+ * elements have the bytes of the `old_n` elements at `p`, which may or may not be at `p`, and
+ * frees the memory at `p`. If this is not possible, it returns `nullptr` and leaves the memory at
+ * `p` untouched, in which case the caller allocates new memory and copies the elements itself.
+ */
+template<typename Alloc>
+concept ReallocatingAllocator =
+  requires(Alloc& alloc, typename Alloc::value_type* p, std::size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<typename Alloc::value_type*>;
+  };
+
 /**
  * A helper class managing a typed chunk of memory.
  *
  * Managing the lifetime of elements is the responsibility of the user; elements are neither
  * constructed nor destroyed by this class.
+ * The allocator is always passed the exact number of elements of the allocation being freed or
+ * reallocated, which allocators such as `HugePagesAllocator` rely on.
  */
 template<typename V, typename S, typename Alloc>
 struct TypedChunk {
@@ -178,6 +197,26 @@ struct TypedChunk {
     begin_ = new_begin;
     end_ = new_begin + new_size;
   }
+  /**
+   * Expand to `new_size` using `reallocate` of the allocator, which keeps the bytes but not the
+   * objects, and is therefore only valid for trivially relocatable elements. Returns whether this
+   * has succeeded, leaving everything unchanged otherwise.
+   */
+  bool try_reallocate(Size new_size)
+  requires(ReallocatingAllocator<Allocator>)
+  {
+    assert(new_size > size());
+    if (begin_ == nullptr) {
+      return false;
+    }
+    Value* new_begin = alloc_.reallocate(begin_, size(), new_size);
+    if (new_begin == nullptr) {
+      return false;
+    }
+    begin_ = new_begin;
+    end_ = new_begin + new_size;
+    return true;
+  }
   constexpr void expand(Size new_size, iterator data_end) {
     expand(new_size, [data_end](iterator old_begin, iterator /*old_end*/, iterator new_begin) {
       std::uninitialized_move(old_begin, data_end, new_begin);
@@ -2,9 +2,12 @@
 #define INCLUDE_THESAUROS_CONTAINERS_BITSET_HPP
 
 // IWYU pragma: begin_exports
+#include "bitset/chunks.hpp"
+#include "bitset/compressed.hpp"
 #include "bitset/dynamic.hpp"
 #include "bitset/fixed.hpp"
 #include "bitset/iterator.hpp"
+#include "bitset/set-bits.hpp"
 #include "bitset/static.hpp"
 // IWYU pragma: end_exports
 
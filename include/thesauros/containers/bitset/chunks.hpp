@@ -0,0 +1,248 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_CONTAINERS_BITSET_CHUNKS_HPP
+#define INCLUDE_THESAUROS_CONTAINERS_BITSET_CHUNKS_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "thesauros/macropolis/platform.hpp"
+
+#if THES_X86_64 && THES_GCC_COMPAT
+#include <immintrin.h>
+#endif
+
+/** Operations on the chunk arrays of the bitsets, which are shared between the bitset types. */
+namespace thes::detail::bitset {
+template<std::unsigned_integral C>
+inline constexpr std::size_t chunk_bits = CHAR_BIT * sizeof(C);
+
+/** The chunk with the bits `[begin, end)` set, for `begin < end <= chunk_bits<C>`. */
+template<std::unsigned_integral C>
+constexpr C range_mask(std::size_t begin, std::size_t end) {
+  constexpr C ones = C(~C{0});
+  const C upper = end == chunk_bits<C> ? ones : C((C{1} << end) - 1U);
+  return C(upper & C(ones << begin));
+}
+
+/**
+ * Calls `partial(chunk_index, mask)` for the chunks which are partially covered by the bit range
+ * `[begin, end)` and `full(chunk_begin, chunk_end)` for the range of fully covered chunks, if any.
+ */
+template<std::unsigned_integral C>
+constexpr void visit_range(std::size_t begin, std::size_t end, auto partial, auto full) {
+  constexpr std::size_t bits = chunk_bits<C>;
+  if (begin >= end) {
+    return;
+  }
+  std::size_t first = begin / bits;
+  const std::size_t last = end / bits;
+  if (first == last) {
+    partial(first, range_mask<C>(begin % bits, end % bits));
+    return;
+  }
+  if (begin % bits != 0) {
+    partial(first, range_mask<C>(begin % bits, bits));
+    ++first;
+  }
+  if (first < last) {
+    full(first, last);
+  }
+  if (end % bits != 0) {
+    partial(last, range_mask<C>(0, end % bits));
+  }
+}
+
+constexpr std::size_t popcount_scalar(std::span<const std::byte> bytes) {
+  std::size_t count = 0;
+  std::size_t i = 0;
+  if !consteval {
+    for (; bytes.size() - i >= sizeof(std::uint64_t); i += sizeof(std::uint64_t)) {
+      std::uint64_t word{};
+      std::memcpy(&word, bytes.data() + i, sizeof(word));
+      count += std::size_t(std::popcount(word));
+    }
+  }
+  for (; i < bytes.size(); ++i) {
+    count += std::size_t(std::popcount(std::uint8_t(bytes[i])));
+  }
+  return count;
+}
+
+#if THES_X86_64 && THES_GCC_COMPAT && !defined(__AVX512VPOPCNTDQ__)
+/**
+ * Counts the set bits using AVX2 by looking up the counts of both nibbles of each byte with a
+ * byte shuffle and summing the byte counts with `vpsadbw`, which is considerably faster than
+ * `popcnt` for each word (Muła, Kurz and Lemire, “Faster Population Counts Using AVX2
+ * Instructions”, 2018).
+ */
+__attribute__((target("avx2"))) inline std::size_t
+popcount_avx2(std::span<const std::byte> bytes) {
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1,
+                                          2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+
+  const std::byte* it = bytes.data();
+  const std::byte* const end = it + bytes.size();
+  __m256i total = zero;
+  while (end - it >= 32) {
+    // Each iteration adds at most 8 to each byte, so 31 iterations cannot overflow.
+    __m256i local = zero;
+    for (int i = 0; i < 31 && end - it >= 32; ++i, it += 32) {
+      const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(it)); // NOLINT
+      const __m256i lo = _mm256_and_si256(v, low_mask);
+      const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+      local = _mm256_add_epi8(local, _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                                     _mm256_shuffle_epi8(lookup, hi)));
+    }
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(local, zero));
+  }
+  const auto count = std::size_t(_mm256_extract_epi64(total, 0)) +
+                     std::size_t(_mm256_extract_epi64(total, 1)) +
+                     std::size_t(_mm256_extract_epi64(total, 2)) +
+                     std::size_t(_mm256_extract_epi64(total, 3));
+  return count + popcount_scalar({it, end});
+}
+
+inline bool has_avx2() {
+#ifdef __AVX2__
+  return true;
+#else
+  static const bool supported = __builtin_cpu_supports("avx2");
+  return supported;
+#endif
+}
+#endif
+
+/**
+ * The number of set bits in `bytes`, using AVX2 if it is available at runtime. If the compiler
+ * targets AVX-512 VPOPCNTDQ or a NEON-capable architecture, the scalar loop is vectorized instead.
+ */
+constexpr std::size_t popcount(std::span<const std::byte> bytes) {
+#if THES_X86_64 && THES_GCC_COMPAT && !defined(__AVX512VPOPCNTDQ__)
+  if !consteval {
+    if (bytes.size() >= 256 && has_avx2()) {
+      return popcount_avx2(bytes);
+    }
+  }
+#endif
+  return popcount_scalar(bytes);
+}
+
+/** The number of set bits in the chunks `[begin, end)`. */
+template<std::unsigned_integral C>
+inline std::size_t popcount(const C* begin, const C* end) {
+  return popcount(std::as_bytes(std::span{begin, end}));
+}
+
+/** Sets `dst[i] = op(dst[i], src[i])` for all `i` in `[0, size)`, written to be vectorized. */
+template<std::unsigned_integral C>
+inline void combine(C* dst, const C* src, std::size_t size, auto op) {
+  for (std::size_t i = 0; i < size; ++i) {
+    dst[i] = C(op(dst[i], src[i]));
+  }
+}
+
+/** Sets the bits in `mask` of `dst` to those of `op(dst, src)`. */
+template<std::unsigned_integral C>
+constexpr C combine_masked(C dst, C src, C mask, auto op) {
+  return C((dst & C(~mask)) | (C(op(dst, src)) & mask));
+}
+
+/**
+ * The first index in `[i, chunks.size())` whose chunk is non-zero, or `chunks.size()`.
+ * Runs of zero chunks are skipped in blocks whose disjunction is checked at once, which the
+ * compiler can vectorize, instead of branching on every chunk.
+ */
+template<std::unsigned_integral C>
+constexpr std::size_t skip_zero_forward(std::span<const C> chunks, std::size_t i) {
+  constexpr std::size_t block = 8;
+  for (; chunks.size() - i >= block; i += block) {
+    C any{0};
+    for (std::size_t j = 0; j < block; ++j) {
+      any |= chunks[i + j];
+    }
+    if (any != 0) {
+      break;
+    }
+  }
+  for (; i < chunks.size() && chunks[i] == 0; ++i) {
+  }
+  return i;
+}
+
+/** The smallest `j <= end` such that the chunks `[j, end)` are all zero. */
+template<std::unsigned_integral C>
+constexpr std::size_t skip_zero_backward(std::span<const C> chunks, std::size_t end) {
+  constexpr std::size_t block = 8;
+  for (; end >= block; end -= block) {
+    C any{0};
+    for (std::size_t j = end - block; j < end; ++j) {
+      any |= chunks[j];
+    }
+    if (any != 0) {
+      break;
+    }
+  }
+  for (; end > 0 && chunks[end - 1] == 0; --end) {
+  }
+  return end;
+}
+
+/**
+ * The index of the first set bit at or after `pos` among the first `size` bits of `chunks`,
+ * or `size` if there is none.
+ */
+template<std::unsigned_integral C>
+constexpr std::size_t find_next(std::span<const C> chunks, std::size_t size, std::size_t pos) {
+  constexpr std::size_t bits = chunk_bits<C>;
+  if (pos >= size) {
+    return size;
+  }
+  std::size_t i = pos / bits;
+  C chunk = C(chunks[i] & range_mask<C>(pos % bits, bits));
+  if (chunk == 0) {
+    i = skip_zero_forward(chunks, i + 1);
+    if (i == chunks.size()) {
+      return size;
+    }
+    chunk = chunks[i];
+  }
+  // The bits beyond `size` in the last chunk are unspecified.
+  return std::min(i * bits + std::size_t(std::countr_zero(chunk)), size);
+}
+
+/**
+ * The index of the last set bit at or before `pos < size` among the first `size` bits of
+ * `chunks`, or `size` if there is none.
+ */
+template<std::unsigned_integral C>
+constexpr std::size_t find_prev(std::span<const C> chunks, std::size_t size, std::size_t pos) {
+  constexpr std::size_t bits = chunk_bits<C>;
+  assert(pos < size);
+  std::size_t i = pos / bits;
+  C chunk = C(chunks[i] & range_mask<C>(0, pos % bits + 1));
+  if (chunk == 0) {
+    i = skip_zero_backward(chunks, i);
+    if (i == 0) {
+      return size;
+    }
+    chunk = chunks[--i];
+  }
+  return i * bits + (bits - 1) - std::size_t(std::countl_zero(chunk));
+}
+} // namespace thes::detail::bitset
+
+#endif // INCLUDE_THESAUROS_CONTAINERS_BITSET_CHUNKS_HPP
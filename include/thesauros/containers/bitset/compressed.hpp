@@ -0,0 +1,509 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_CONTAINERS_BITSET_COMPRESSED_HPP
+#define INCLUDE_THESAUROS_CONTAINERS_BITSET_COMPRESSED_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <utility>
+
+#include "thesauros/containers/array/dynamic.hpp"
+#include "thesauros/containers/bitset/chunks.hpp"
+#include "thesauros/containers/bitset/iterator.hpp"
+#include "thesauros/types/primitives.hpp"
+
+namespace thes {
+enum struct CompressedBlockKind : u8 { array, bitmap, run };
+
+/**
+ * A bitset which is split into blocks of 2¹⁶ bits, each of which is stored in the most compact of
+ * three forms, as in Roaring bitmaps (Lemire et al., “Consistently faster and smaller compressed
+ * bitmaps with Roaring”, 2016):
+ * - An array of the sorted offsets of the set bits, if there are at most 4096 of them.
+ * - A bitmap of 2¹⁶ bits otherwise.
+ * - The runs of set bits as pairs of their first and last offset, if `optimize` finds that this
+ *   is smaller than the other forms.
+ * Blocks without set bits are not stored at all.
+ *
+ * `set` and `unset` keep arrays and bitmaps in the smaller of these two forms, turning a run block
+ * into one of them before modifying it, which is why `optimize` should be called again after a
+ * batch of modifications. The bits can be read through `get`, `operator[]` and the read-only
+ * `const_iterator`, and the set bits can be visited efficiently using `views::set_bits`.
+ */
+struct CompressedBitset {
+  using Offset = u16;
+  using Word = u64;
+  using BlockKind = CompressedBlockKind;
+
+  static constexpr std::size_t block_bit_num = std::size_t{1} << 16U;
+  static constexpr std::size_t word_bit_num = 64;
+  static constexpr std::size_t bitmap_word_num = block_bit_num / word_bit_num;
+  /** The largest array, beyond which a bitmap takes less memory. */
+  static constexpr std::size_t array_max_size = bitmap_word_num * sizeof(Word) / sizeof(Offset);
+
+  struct Block {
+    /** The index of the block, i.e. the index of its first bit divided by `block_bit_num`. */
+    std::size_t key;
+    BlockKind kind;
+    /** The number of set bits, which is always positive. */
+    std::size_t cardinality;
+    /** The sorted offsets for an array, the first and last offset of each run for runs. */
+    DynamicArray<Offset> offsets{};
+    /** The words of a bitmap. */
+    DynamicArray<Word> words{};
+  };
+  using Blocks = DynamicArray<Block>;
+
+  using value_type = bool;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using const_reference = bool;
+  using const_iterator = detail::BitsetIterator<CompressedBitset, true>;
+
+  CompressedBitset() = default;
+  explicit CompressedBitset(std::size_t size) : size_{size} {}
+  /** Takes over `blocks`, which have to be sorted by key and fit into `size` bits. */
+  CompressedBitset(std::size_t size, Blocks blocks) : blocks_(std::move(blocks)), size_{size} {
+    assert(std::ranges::is_sorted(blocks_, std::less<>{}, &Block::key));
+    assert(blocks_.empty() || blocks_.back().key * block_bit_num < size_);
+  }
+
+  [[nodiscard]] bool get(std::size_t index) const {
+    assert(index < size_);
+    const auto it = std::ranges::lower_bound(blocks_, index / block_bit_num, {}, &Block::key);
+    return it != blocks_.end() && it->key == index / block_bit_num &&
+           block_get(*it, Offset(index % block_bit_num));
+  }
+  [[nodiscard]] bool operator[](std::size_t index) const {
+    return get(index);
+  }
+
+  void set(std::size_t index) {
+    assert(index < size_);
+    const std::size_t key = index / block_bit_num;
+    const auto offset = Offset(index % block_bit_num);
+
+    auto it = std::ranges::lower_bound(blocks_, key, {}, &Block::key);
+    if (it == blocks_.end() || it->key != key) {
+      it = blocks_.insert(it, Block{.key = key, .kind = BlockKind::array, .cardinality = 0});
+    }
+    Block& block = *it;
+    if (block.kind == BlockKind::run) {
+      expand_runs(block);
+    }
+    if (block.kind == BlockKind::array) {
+      const auto pos = std::ranges::lower_bound(block.offsets, offset);
+      if (pos != block.offsets.end() && *pos == offset) {
+        return;
+      }
+      if (block.cardinality < array_max_size) {
+        block.offsets.insert(pos, offset);
+        ++block.cardinality;
+        return;
+      }
+      block = Block{.key = key, .kind = BlockKind::bitmap, .cardinality = block.cardinality,
+                    .words = words_of(block)};
+    }
+    Word& word = block.words[offset / word_bit_num];
+    const Word mask = Word{1} << (offset % word_bit_num);
+    block.cardinality += (word & mask) == 0 ? 1 : 0;
+    word |= mask;
+  }
+
+  void unset(std::size_t index) {
+    assert(index < size_);
+    const std::size_t key = index / block_bit_num;
+    const auto offset = Offset(index % block_bit_num);
+
+    const auto it = std::ranges::lower_bound(blocks_, key, {}, &Block::key);
+    if (it == blocks_.end() || it->key != key) {
+      return;
+    }
+    Block& block = *it;
+    if (block.kind == BlockKind::run) {
+      expand_runs(block);
+    }
+    if (block.kind == BlockKind::array) {
+      const auto pos = std::ranges::lower_bound(block.offsets, offset);
+      if (pos == block.offsets.end() || *pos != offset) {
+        return;
+      }
+      block.offsets.erase(pos);
+      --block.cardinality;
+    } else {
+      Word& word = block.words[offset / word_bit_num];
+      const Word mask = Word{1} << (offset % word_bit_num);
+      block.cardinality -= (word & mask) != 0 ? 1 : 0;
+      word &= ~mask;
+      if (block.cardinality <= array_max_size) {
+        block = from_words(key, block.words, block.cardinality);
+      }
+    }
+    if (block.cardinality == 0) {
+      blocks_.erase(it);
+    }
+  }
+
+  void push_back(bool value) {
+    ++size_;
+    if (value) {
+      set(size_ - 1);
+    }
+  }
+
+  void clear() {
+    blocks_.clear();
+    size_ = 0;
+  }
+
+  /** The number of set bits, which is stored for each block. */
+  [[nodiscard]] std::size_t count() const {
+    std::size_t out = 0;
+    for (const Block& block : blocks_) {
+      out += block.cardinality;
+    }
+    return out;
+  }
+  [[nodiscard]] bool any() const {
+    return !blocks_.empty();
+  }
+  [[nodiscard]] bool none() const {
+    return blocks_.empty();
+  }
+
+  /** The index of the first set bit at or after `pos`, or `size()` if there is none. */
+  [[nodiscard]] std::size_t find_next(std::size_t pos) const {
+    if (pos >= size_) {
+      return size_;
+    }
+    const std::size_t key = pos / block_bit_num;
+    for (auto it = std::ranges::lower_bound(blocks_, key, {}, &Block::key); it != blocks_.end();
+         ++it) {
+      const std::size_t first = it->key == key ? pos % block_bit_num : 0;
+      const std::size_t offset = block_find_next(*it, first);
+      if (offset != block_bit_num) {
+        return it->key * block_bit_num + offset;
+      }
+    }
+    return size_;
+  }
+  /** The index of the last set bit at or before `pos < size()`, or `size()` if there is none. */
+  [[nodiscard]] std::size_t find_prev(std::size_t pos) const {
+    assert(pos < size_);
+    const std::size_t key = pos / block_bit_num;
+    auto it = std::ranges::upper_bound(blocks_, key, {}, &Block::key);
+    while (it != blocks_.begin()) {
+      --it;
+      const std::size_t last = it->key == key ? pos % block_bit_num : block_bit_num - 1;
+      const std::size_t offset = block_find_prev(*it, last);
+      if (offset != block_bit_num) {
+        return it->key * block_bit_num + offset;
+      }
+    }
+    return size_;
+  }
+
+  /** Stores each block in its most compact form, including runs. */
+  void optimize() {
+    for (Block& block : blocks_) {
+      auto words = words_of(block);
+      const std::size_t run_num = count_runs(words);
+      const std::size_t plain_bytes = block.cardinality <= array_max_size
+                                        ? block.cardinality * sizeof(Offset)
+                                        : bitmap_word_num * sizeof(Word);
+      if (2 * run_num * sizeof(Offset) < plain_bytes) {
+        if (block.kind != BlockKind::run) {
+          block = runs_from_words(block.key, words, run_num, block.cardinality);
+        }
+      } else if (block.kind == BlockKind::run) {
+        block = from_words(block.key, words, block.cardinality);
+      }
+    }
+  }
+
+  /** Sets all bits which are set in `other`, which has to have the same size. */
+  CompressedBitset& operator|=(const CompressedBitset& other) {
+    assert(size_ == other.size_);
+    Blocks out{};
+    out.reserve(blocks_.size() + other.blocks_.size());
+    auto it1 = blocks_.begin();
+    auto it2 = other.blocks_.begin();
+    while (it1 != blocks_.end() || it2 != other.blocks_.end()) {
+      if (it2 == other.blocks_.end() || (it1 != blocks_.end() && it1->key < it2->key)) {
+        out.push_back(std::move(*it1++));
+      } else if (it1 == blocks_.end() || it2->key < it1->key) {
+        out.push_back(*it2++);
+      } else {
+        out.push_back(unite(*it1++, *it2++));
+      }
+    }
+    blocks_ = std::move(out);
+    return *this;
+  }
+  /** Unsets all bits which are not set in `other`, which has to have the same size. */
+  CompressedBitset& operator&=(const CompressedBitset& other) {
+    assert(size_ == other.size_);
+    Blocks out{};
+    auto it2 = other.blocks_.begin();
+    for (Block& block : blocks_) {
+      it2 = std::ranges::lower_bound(it2, other.blocks_.end(), block.key, {}, &Block::key);
+      if (it2 == other.blocks_.end()) {
+        break;
+      }
+      if (it2->key == block.key) {
+        Block intersection = intersect(block, *it2);
+        if (intersection.cardinality > 0) {
+          out.push_back(std::move(intersection));
+        }
+      }
+    }
+    blocks_ = std::move(out);
+    return *this;
+  }
+  friend CompressedBitset operator|(CompressedBitset lhs, const CompressedBitset& rhs) {
+    lhs |= rhs;
+    return lhs;
+  }
+  friend CompressedBitset operator&(CompressedBitset lhs, const CompressedBitset& rhs) {
+    lhs &= rhs;
+    return lhs;
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return size_;
+  }
+  [[nodiscard]] bool empty() const {
+    return size_ == 0;
+  }
+  [[nodiscard]] const Blocks& blocks() const {
+    return blocks_;
+  }
+  /** The number of bytes used by the blocks, including their bookkeeping. */
+  [[nodiscard]] std::size_t byte_size() const {
+    std::size_t out = blocks_.size() * sizeof(Block);
+    for (const Block& block : blocks_) {
+      out += block.offsets.size() * sizeof(Offset) + block.words.size() * sizeof(Word);
+    }
+    return out;
+  }
+
+  [[nodiscard]] const_iterator begin() const {
+    return const_iterator{0, *this};
+  }
+  [[nodiscard]] const_iterator end() const {
+    return const_iterator{size_, *this};
+  }
+  [[nodiscard]] const_iterator cbegin() const {
+    return begin();
+  }
+  [[nodiscard]] const_iterator cend() const {
+    return end();
+  }
+
+private:
+  using Words = DynamicArray<Word>;
+
+  static std::span<const Word> word_span(const Words& words) {
+    return {words.data(), words.size()};
+  }
+  /** The runs of a run block as a random-access range of `{first, last}` offset pairs. */
+  static auto runs_of(const Block& block) {
+    assert(block.offsets.size() % 2 == 0);
+    struct Run {
+      std::size_t first;
+      std::size_t last;
+    };
+    return std::views::iota(std::size_t{0}, block.offsets.size() / 2) |
+           std::views::transform([&block](std::size_t i) {
+             return Run{block.offsets[2 * i], block.offsets[2 * i + 1]};
+           });
+  }
+
+  static bool block_get(const Block& block, Offset offset) {
+    switch (block.kind) {
+      case BlockKind::array: return std::ranges::binary_search(block.offsets, offset);
+      case BlockKind::bitmap:
+        return ((block.words[offset / word_bit_num] >> (offset % word_bit_num)) & 1U) != 0;
+      case BlockKind::run: return block_find_next(block, offset) == offset;
+    }
+    return false;
+  }
+
+  /** The first set offset at or after `first`, or `block_bit_num` if there is none. */
+  static std::size_t block_find_next(const Block& block, std::size_t first) {
+    switch (block.kind) {
+      case BlockKind::array: {
+        const auto it = std::ranges::lower_bound(block.offsets, first);
+        return it == block.offsets.end() ? block_bit_num : std::size_t{*it};
+      }
+      case BlockKind::bitmap:
+        return detail::bitset::find_next(word_span(block.words), block_bit_num, first);
+      case BlockKind::run: {
+        // The runs are sorted and disjoint, so the first one not ending before `first` is it.
+        const auto runs = runs_of(block);
+        const auto it =
+          std::ranges::partition_point(runs, [first](auto run) { return run.last < first; });
+        return it == runs.end() ? block_bit_num : std::max((*it).first, first);
+      }
+    }
+    return block_bit_num;
+  }
+  /** The last set offset at or before `last`, or `block_bit_num` if there is none. */
+  static std::size_t block_find_prev(const Block& block, std::size_t last) {
+    switch (block.kind) {
+      case BlockKind::array: {
+        const auto it = std::ranges::upper_bound(block.offsets, last);
+        return it == block.offsets.begin() ? block_bit_num : std::size_t{*std::prev(it)};
+      }
+      case BlockKind::bitmap:
+        return detail::bitset::find_prev(word_span(block.words), block_bit_num, last);
+      case BlockKind::run: {
+        // The last run starting at or before `last` is the only candidate.
+        const auto runs = runs_of(block);
+        const auto it =
+          std::ranges::partition_point(runs, [last](auto run) { return run.first <= last; });
+        return it == runs.begin() ? block_bit_num : std::min((*std::ranges::prev(it)).last, last);
+      }
+    }
+    return block_bit_num;
+  }
+
+  /** The bitmap words of `block`, whatever its kind. */
+  static Words words_of(const Block& block) {
+    if (block.kind == BlockKind::bitmap) {
+      return block.words;
+    }
+    Words words(bitmap_word_num, Word{0});
+    if (block.kind == BlockKind::array) {
+      for (const Offset offset : block.offsets) {
+        words[offset / word_bit_num] |= Word{1} << (offset % word_bit_num);
+      }
+    } else {
+      for (const auto [first, last] : runs_of(block)) {
+        visit_words(first, last + 1, [&](std::size_t i, Word mask) { words[i] |= mask; });
+      }
+    }
+    return words;
+  }
+  static void visit_words(std::size_t begin, std::size_t end, auto f) {
+    detail::bitset::visit_range<Word>(begin, end, f, [&](std::size_t first, std::size_t last) {
+      for (std::size_t i = first; i < last; ++i) {
+        f(i, ~Word{0});
+      }
+    });
+  }
+
+  /** An array or bitmap block with the bits set in `words`, of which there are `cardinality`. */
+  static Block from_words(std::size_t key, Words words, std::size_t cardinality) {
+    if (cardinality > array_max_size) {
+      return Block{.key = key, .kind = BlockKind::bitmap, .cardinality = cardinality,
+                   .words = std::move(words)};
+    }
+    DynamicArray<Offset> offsets{};
+    offsets.reserve(cardinality);
+    for (std::size_t i = 0; i < bitmap_word_num; ++i) {
+      for (Word word = words[i]; word != 0; word &= word - 1) {
+        offsets.push_back(Offset(i * word_bit_num + std::size_t(std::countr_zero(word))));
+      }
+    }
+    return Block{.key = key, .kind = BlockKind::array, .cardinality = cardinality,
+                 .offsets = std::move(offsets)};
+  }
+  static void expand_runs(Block& block) {
+    block = from_words(block.key, words_of(block), block.cardinality);
+  }
+
+  /** The number of runs of set bits, i.e. of set bits whose predecessor is unset. */
+  static std::size_t count_runs(const Words& words) {
+    std::size_t out = 0;
+    Word carry = 0;
+    for (const Word word : words) {
+      out += std::size_t(std::popcount(Word(word & ~((word << 1U) | carry))));
+      carry = word >> (word_bit_num - 1);
+    }
+    return out;
+  }
+  static Block runs_from_words(std::size_t key, const Words& words, std::size_t run_num,
+                               std::size_t cardinality) {
+    DynamicArray<Offset> offsets{};
+    offsets.reserve(2 * run_num);
+    const auto span = word_span(words);
+    for (std::size_t first = detail::bitset::find_next(span, block_bit_num, 0);
+         first != block_bit_num;) {
+      // The run ends at the first unset bit after `first`, the first set bit of the complement.
+      std::size_t end = first;
+      while (end < block_bit_num) {
+        const Word rest = Word(~words[end / word_bit_num]) >> (end % word_bit_num);
+        if (rest != 0) {
+          end += std::size_t(std::countr_zero(rest));
+          break;
+        }
+        end = (end / word_bit_num + 1) * word_bit_num;
+      }
+      offsets.push_back(Offset(first));
+      offsets.push_back(Offset(end - 1));
+      first = detail::bitset::find_next(span, block_bit_num, end);
+    }
+    assert(offsets.size() == 2 * run_num);
+    return Block{.key = key, .kind = BlockKind::run, .cardinality = cardinality,
+                 .offsets = std::move(offsets)};
+  }
+
+  static Block combine_words(const Block& b1, const Block& b2, auto op) {
+    Words words = words_of(b1);
+    const Words other = words_of(b2);
+    detail::bitset::combine(words.data(), other.data(), bitmap_word_num, op);
+    const std::size_t cardinality =
+      detail::bitset::popcount(words.data(), words.data() + words.size());
+    return from_words(b1.key, std::move(words), cardinality);
+  }
+  static Block unite(const Block& b1, const Block& b2) {
+    if (b1.kind == BlockKind::array && b2.kind == BlockKind::array &&
+        b1.cardinality + b2.cardinality <= array_max_size) {
+      DynamicArray<Offset> offsets(b1.cardinality + b2.cardinality);
+      const auto end = std::ranges::set_union(b1.offsets, b2.offsets, offsets.begin()).out;
+      offsets.erase(end, offsets.end());
+      const std::size_t cardinality = offsets.size();
+      return Block{.key = b1.key, .kind = BlockKind::array, .cardinality = cardinality,
+                   .offsets = std::move(offsets)};
+    }
+    return combine_words(b1, b2, std::bit_or<>{});
+  }
+  static Block intersect(const Block& b1, const Block& b2) {
+    if (b1.kind == BlockKind::array || b2.kind == BlockKind::array) {
+      // Only the offsets of the smaller array can be set in the intersection.
+      const Block& array = b1.kind == BlockKind::array &&
+                               (b2.kind != BlockKind::array || b1.cardinality <= b2.cardinality)
+                             ? b1
+                             : b2;
+      const Block& other = &array == &b1 ? b2 : b1;
+      DynamicArray<Offset> offsets{};
+      offsets.reserve(array.cardinality);
+      for (const Offset offset : array.offsets) {
+        if (block_get(other, offset)) {
+          offsets.push_back(offset);
+        }
+      }
+      const std::size_t cardinality = offsets.size();
+      return Block{.key = b1.key, .kind = BlockKind::array, .cardinality = cardinality,
+                   .offsets = std::move(offsets)};
+    }
+    return combine_words(b1, b2, std::bit_and<>{});
+  }
+
+  Blocks blocks_{};
+  std::size_t size_ = 0;
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_CONTAINERS_BITSET_COMPRESSED_HPP
@@ -9,18 +9,27 @@
 
 #include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cassert>
 #include <climits>
 #include <concepts>
 #include <cstddef>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <ranges>
+#include <span>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "thesauros/containers/array/dynamic.hpp"
 #include "thesauros/containers/array/initialization-policy.hpp"
+#include "thesauros/containers/bitset/chunks.hpp"
 #include "thesauros/containers/bitset/iterator.hpp"
+#include "thesauros/functional/binary.hpp"
 #include "thesauros/math/arithmetic.hpp"
+#include "thesauros/memory/cache-line.hpp"
 #include "thesauros/ranges/indices.hpp"
 #include "thesauros/utility/multi-bit-reference.hpp"
 
@@ -29,6 +38,13 @@ namespace thes {
  * A bitset whose bits are packed into chunks of `C`, growing dynamically via `push_back` and
  * `resize`. Models `std::ranges::sized_range` and `std::ranges::random_access_range`, with a
  * writable `iterator` in addition to the read-only `const_iterator`.
+ *
+ * The bulk operations work on whole chunks, either for all bits or for a range of bits, and have
+ * overloads taking an execution policy providing `execute_chunked` and `thread_num`.
+ *
+ * `set_if_unset`, `unset_if_set`, `load`, `set_many` and `atomic_count` use atomic operations and
+ * can be called concurrently, e.g. from the tasks of a `FixedThreadPool`, but must not be mixed
+ * with concurrent calls to the other member functions.
  */
 template<std::unsigned_integral C = std::size_t, typename Alloc = std::allocator<C>>
 struct DynamicBitset {
@@ -68,16 +84,103 @@ struct DynamicBitset {
     return chunks_[index / chunk_bit_num] & mask(index % chunk_bit_num);
   }
 
-  /** Atomically sets a bit, returning whether it was previously unset. */
-  [[nodiscard]] bool set_if_unset(std::size_t index) {
+  /**
+   * Atomically sets a bit, returning whether it was previously unset.
+   *
+   * The bit is tested with a plain atomic load first, so that a bit which is already set costs
+   * neither a read-modify-write nor exclusive ownership of the cache line. That load uses `order`,
+   * or acquire for orders which a load cannot have, so that returning `false` early synchronizes
+   * with the thread which has set the bit just like the read-modify-write would.
+   */
+  [[nodiscard]] bool set_if_unset(std::size_t index,
+                                  std::memory_order order = std::memory_order_seq_cst) {
     assert(index < size_);
     const auto index_mask = mask(index % chunk_bit_num);
 
     std::atomic_ref atomic_chunk{chunks_[index / chunk_bit_num]};
-    const Chunk prev = atomic_chunk.fetch_or(index_mask);
+    if ((atomic_chunk.load(load_order(order)) & index_mask) != 0) {
+      return false;
+    }
+    const Chunk prev = atomic_chunk.fetch_or(index_mask, order);
     return (prev & index_mask) == 0;
   }
 
+  /**
+   * Atomically unsets a bit, returning whether it was previously set. As in `set_if_unset`, a bit
+   * which is already unset is only loaded, with the same memory order.
+   */
+  [[nodiscard]] bool unset_if_set(std::size_t index,
+                                  std::memory_order order = std::memory_order_seq_cst) {
+    assert(index < size_);
+    const auto index_mask = mask(index % chunk_bit_num);
+
+    std::atomic_ref atomic_chunk{chunks_[index / chunk_bit_num]};
+    if ((atomic_chunk.load(load_order(order)) & index_mask) == 0) {
+      return false;
+    }
+    const Chunk prev = atomic_chunk.fetch_and(Chunk(~index_mask), order);
+    return (prev & index_mask) != 0;
+  }
+
+  /**
+   * Atomically reads a bit. This is non-`const` because `std::atomic_ref` can only be formed over
+   * a non-`const` object.
+   */
+  [[nodiscard]] bool load(std::size_t index, std::memory_order order) {
+    assert(index < size_);
+    return std::atomic_ref{chunks_[index / chunk_bit_num]}.load(order) &
+           mask(index % chunk_bit_num);
+  }
+
+  /**
+   * Atomically sets the bits at `indices`, calling `on_set(index)` for each bit that was
+   * previously unset and returning their number.
+   *
+   * Consecutive indices within the same chunk are combined into a single read-modify-write,
+   * so sorted or clustered indices need far fewer atomic operations than `set_if_unset` for
+   * each of them. Chunks whose bits are all set already are only loaded, as in `set_if_unset`.
+   */
+  template<std::ranges::input_range R>
+  std::size_t set_many(R&& indices, // NOLINT(*-missing-std-forward)
+                       std::invocable<std::size_t> auto on_set,
+                       std::memory_order order = std::memory_order_seq_cst) {
+    std::size_t out = 0;
+    std::size_t chunk_index = 0;
+    Chunk pending{0};
+
+    const auto flush = [&] {
+      if (pending == 0) {
+        return;
+      }
+      std::atomic_ref atomic_chunk{chunks_[chunk_index]};
+      Chunk fresh = Chunk(pending & Chunk(~atomic_chunk.load(load_order(order))));
+      if (fresh == 0) {
+        return;
+      }
+      fresh = Chunk(fresh & Chunk(~atomic_chunk.fetch_or(fresh, order)));
+      out += std::size_t(std::popcount(fresh));
+      for (; fresh != 0; fresh = Chunk(fresh & Chunk(fresh - 1))) {
+        on_set(chunk_index * chunk_bit_num + std::size_t(std::countr_zero(fresh)));
+      }
+    };
+
+    for (const std::size_t index : indices) {
+      assert(index < size_);
+      if (index / chunk_bit_num != chunk_index) {
+        flush();
+        chunk_index = index / chunk_bit_num;
+        pending = 0;
+      }
+      pending |= mask(index % chunk_bit_num);
+    }
+    flush();
+    return out;
+  }
+  template<std::ranges::input_range R>
+  std::size_t set_many(R&& indices, std::memory_order order = std::memory_order_seq_cst) {
+    return set_many(std::forward<R>(indices), [](std::size_t /*index*/) {}, order);
+  }
+
   void push_back(bool value) {
     if (size_ == chunks_.size() * chunk_bit_num) {
       chunks_.push_back(Chunk{value});
@@ -95,11 +198,162 @@ struct DynamicBitset {
   }
 
   [[nodiscard]] std::size_t countr_zero() const {
-    return count([](const auto x) { return static_cast<std::size_t>(std::countr_zero(x)); });
+    return count_run([](const auto x) { return static_cast<std::size_t>(std::countr_zero(x)); });
   }
 
   [[nodiscard]] std::size_t countr_one() const {
-    return count([](const auto x) { return static_cast<std::size_t>(std::countr_one(x)); });
+    return count_run([](const auto x) { return static_cast<std::size_t>(std::countr_one(x)); });
+  }
+
+  /** The index of the first set bit at or after `pos`, or `size()` if there is none. */
+  [[nodiscard]] std::size_t find_next(std::size_t pos) const {
+    return detail::bitset::find_next(chunk_span(), size_, pos);
+  }
+  /** The index of the last set bit at or before `pos < size()`, or `size()` if there is none. */
+  [[nodiscard]] std::size_t find_prev(std::size_t pos) const {
+    return detail::bitset::find_prev(chunk_span(), size_, pos);
+  }
+
+  /** The number of set bits. */
+  [[nodiscard]] std::size_t count() const {
+    return count(0, size_);
+  }
+  /** The number of set bits in `[begin, end)`. */
+  [[nodiscard]] std::size_t count(std::size_t begin, std::size_t end) const {
+    assert(begin <= end && end <= size_);
+    std::size_t out = 0;
+    detail::bitset::visit_range<Chunk>(
+      begin, end,
+      [&](std::size_t i, Chunk mask) {
+        out += std::size_t(std::popcount(Chunk(chunks_[i] & mask)));
+      },
+      [&](std::size_t first, std::size_t last) {
+        out += detail::bitset::popcount(chunks_.data() + first, chunks_.data() + last);
+      });
+    return out;
+  }
+  /** The number of set bits, counted in parallel using `expo`. */
+  template<typename ExPo>
+  requires requires(const ExPo& expo) { expo.thread_num(); }
+  [[nodiscard]] std::size_t count(const ExPo& expo) const {
+    // One counter per cache line, so that the threads do not share them.
+    std::vector<CacheAligned<std::size_t>> counters(expo.thread_num());
+    expo.execute_chunked(chunks_.size(), [&](std::size_t thread_idx, auto first, auto last) {
+      counters[thread_idx].value += count(std::size_t(first) * chunk_bit_num,
+                                          std::min(std::size_t(last) * chunk_bit_num, size_));
+    });
+    std::size_t out = 0;
+    for (const CacheAligned<std::size_t>& counter : counters) {
+      out += counter.value;
+    }
+    return out;
+  }
+
+  /**
+   * The number of set bits, reading each chunk atomically, so that this can be called while
+   * other threads set or unset bits. The result is not a consistent snapshot if they do: each
+   * chunk is counted at a different point in time.
+   * This is non-`const` because `std::atomic_ref` can only be formed over a non-`const` object.
+   */
+  [[nodiscard]] std::size_t atomic_count(std::memory_order order = std::memory_order_relaxed) {
+    std::size_t out = 0;
+    detail::bitset::visit_range<Chunk>(
+      0, size_,
+      [&](std::size_t i, Chunk mask) {
+        out += std::size_t(std::popcount(Chunk(std::atomic_ref{chunks_[i]}.load(order) & mask)));
+      },
+      [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+          out += std::size_t(std::popcount(std::atomic_ref{chunks_[i]}.load(order)));
+        }
+      });
+    return out;
+  }
+
+  /** Whether any bit in `[begin, end)` is set, stopping at the first chunk containing one. */
+  [[nodiscard]] bool any(std::size_t begin, std::size_t end) const {
+    assert(begin <= end && end <= size_);
+    bool out = false;
+    detail::bitset::visit_range<Chunk>(
+      begin, end, [&](std::size_t i, Chunk mask) { out = out || (chunks_[i] & mask) != 0; },
+      [&](std::size_t first, std::size_t last) {
+        out = out || std::any_of(chunks_.begin() + first, chunks_.begin() + last,
+                                 [](Chunk c) { return c != zero_chunk; });
+      });
+    return out;
+  }
+  [[nodiscard]] bool any() const {
+    return any(0, size_);
+  }
+  [[nodiscard]] bool none(std::size_t begin, std::size_t end) const {
+    return !any(begin, end);
+  }
+  [[nodiscard]] bool none() const {
+    return !any();
+  }
+  /** Whether all bits in `[begin, end)` are set. */
+  [[nodiscard]] bool all(std::size_t begin, std::size_t end) const {
+    assert(begin <= end && end <= size_);
+    bool out = true;
+    detail::bitset::visit_range<Chunk>(
+      begin, end, [&](std::size_t i, Chunk mask) { out = out && (chunks_[i] & mask) == mask; },
+      [&](std::size_t first, std::size_t last) {
+        out = out && std::all_of(chunks_.begin() + first, chunks_.begin() + last,
+                                 [](Chunk c) { return c == one_chunk; });
+      });
+    return out;
+  }
+  [[nodiscard]] bool all() const {
+    return all(0, size_);
+  }
+
+  /**
+   * Sets each bit in `[begin, end)` to the result of `op` applied to it and the bit at the same
+   * position in `other`, where `op` is a bitwise operation on whole chunks such as `std::bit_or`.
+   */
+  void combine(const DynamicBitset& other, auto op, std::size_t begin, std::size_t end) {
+    assert(begin <= end && end <= size_ && end <= other.size_);
+    detail::bitset::visit_range<Chunk>(
+      begin, end,
+      [&](std::size_t i, Chunk mask) {
+        chunks_[i] = detail::bitset::combine_masked(chunks_[i], other.chunks_[i], mask, op);
+      },
+      [&](std::size_t first, std::size_t last) {
+        detail::bitset::combine(chunks_.data() + first, other.chunks_.data() + first,
+                                last - first, op);
+      });
+  }
+  void combine(const DynamicBitset& other, auto op) {
+    assert(size_ == other.size_);
+    detail::bitset::combine(chunks_.data(), other.chunks_.data(), chunks_.size(), op);
+  }
+  /** Combines all bits in parallel using `expo`, splitting the bitset at chunk boundaries. */
+  template<typename ExPo>
+  requires requires(const ExPo& expo) { expo.thread_num(); }
+  void combine(const DynamicBitset& other, auto op, const ExPo& expo) {
+    assert(size_ == other.size_);
+    expo.execute_chunked(chunks_.size(), [&](std::size_t /*thread_idx*/, auto first, auto last) {
+      detail::bitset::combine(chunks_.data() + first, other.chunks_.data() + first,
+                              std::size_t(last - first), op);
+    });
+  }
+
+  DynamicBitset& operator&=(const DynamicBitset& other) {
+    combine(other, std::bit_and<>{});
+    return *this;
+  }
+  DynamicBitset& operator|=(const DynamicBitset& other) {
+    combine(other, std::bit_or<>{});
+    return *this;
+  }
+  DynamicBitset& operator^=(const DynamicBitset& other) {
+    combine(other, std::bit_xor<>{});
+    return *this;
+  }
+  /** Unsets all bits which are set in `other`. */
+  DynamicBitset& and_not(const DynamicBitset& other) {
+    combine(other, BitAndNot{});
+    return *this;
   }
 
   [[nodiscard]] std::size_t chunk_num() const {
@@ -116,6 +370,19 @@ struct DynamicBitset {
   void fill(const bool value) {
     std::fill(chunks_.begin(), chunks_.end(), value ? one_chunk : zero_chunk);
   }
+  /** Sets all bits in `[begin, end)` to `value`. */
+  void fill(std::size_t begin, std::size_t end, const bool value) {
+    assert(begin <= end && end <= size_);
+    detail::bitset::visit_range<Chunk>(
+      begin, end,
+      [&](std::size_t i, Chunk mask) {
+        chunks_[i] = value ? Chunk(chunks_[i] | mask) : Chunk(chunks_[i] & Chunk(~mask));
+      },
+      [&](std::size_t first, std::size_t last) {
+        std::fill(chunks_.begin() + first, chunks_.begin() + last,
+                  value ? one_chunk : zero_chunk);
+      });
+  }
 
   /** Indexed access: `bool` on a `const` bitset, an assignable `MutBitRef` otherwise. */
   template<typename Self>
@@ -149,7 +416,7 @@ private:
   static constexpr Chunk one_chunk{static_cast<Chunk>(~zero_chunk)};
 
   template<typename Counter>
-  std::size_t count(Counter counter) const {
+  std::size_t count_run(Counter counter) const {
     if (size_ == 0) {
       return 0;
     }
@@ -170,6 +437,19 @@ private:
     return Chunk(Chunk{1} << i);
   }
 
+  /** The order of a load replacing a read-modify-write with `order`: acquire unless relaxed. */
+  static constexpr std::memory_order load_order(std::memory_order order) {
+    switch (order) {
+      case std::memory_order_relaxed:
+      case std::memory_order_seq_cst: return order;
+      default: return std::memory_order_acquire;
+    }
+  }
+
+  [[nodiscard]] std::span<const Chunk> chunk_span() const {
+    return {chunks_.data(), chunks_.size()};
+  }
+
   DynamicArray<Chunk, DefaultInit, DoublingGrowth, Alloc> chunks_{};
   std::size_t size_ = 0;
 };
@@ -14,9 +14,11 @@
 #include <concepts>
 #include <cstddef>
 #include <functional>
+#include <span>
 #include <type_traits>
 
 #include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/containers/bitset/chunks.hpp"
 #include "thesauros/containers/bitset/iterator.hpp"
 #include "thesauros/math/arithmetic.hpp"
 #include "thesauros/math/bit.hpp"
@@ -96,6 +98,15 @@ struct FixedBitset {
     return count([](const auto x) { return thes::countr_one(x); });
   }
 
+  /** The index of the first set bit at or after `pos`, or `size()` if there is none. */
+  [[nodiscard]] std::size_t find_next(std::size_t pos) const {
+    return detail::bitset::find_next(chunk_span(), size_, pos);
+  }
+  /** The index of the last set bit at or before `pos < size()`, or `size()` if there is none. */
+  [[nodiscard]] std::size_t find_prev(std::size_t pos) const {
+    return detail::bitset::find_prev(chunk_span(), size_, pos);
+  }
+
   [[nodiscard]] std::size_t chunk_num() const {
     return chunks_.size();
   }
@@ -154,6 +165,10 @@ private:
     return Chunk(Chunk{1} << i);
   }
 
+  [[nodiscard]] std::span<const Chunk> chunk_span() const {
+    return {chunks_.data(), chunks_.size()};
+  }
+
   template<typename Counter>
   std::size_t count(Counter counter) const {
     if (size_ == 0) {
@@ -16,16 +16,27 @@
 #include "thesauros/iterator/state-facade.hpp"
 
 namespace thes::detail {
+// `Bitset::MutBitRef` is only looked up for mutable iterators, so that bitsets which cannot hand
+// out references to their bits can still use `BitsetIterator<Bitset, true>`.
+template<typename Bitset, bool IsConst>
+struct BitsetIteratorRef {
+  using Type = bool;
+};
+template<typename Bitset>
+struct BitsetIteratorRef<Bitset, false> {
+  using Type = Bitset::MutBitRef;
+};
+
 /**
  * An iterator over `Bitset`. If `IsConst` is `false`, dereferencing yields `Bitset::MutBitRef`,
  * allowing bits to be assigned to through the iterator; otherwise it yields `bool` by value.
  */
 template<typename Bitset, bool IsConst>
 struct BitsetIterator
-    : public StateIteratorFacade<iter::ValueTypes<
-        std::conditional_t<IsConst, bool, typename Bitset::MutBitRef>, std::ptrdiff_t>> {
-  using Facade = StateIteratorFacade<iter::ValueTypes<
-    std::conditional_t<IsConst, bool, typename Bitset::MutBitRef>, std::ptrdiff_t>>;
+    : public StateIteratorFacade<
+        iter::ValueTypes<typename BitsetIteratorRef<Bitset, IsConst>::Type, std::ptrdiff_t>> {
+  using Facade = StateIteratorFacade<
+    iter::ValueTypes<typename BitsetIteratorRef<Bitset, IsConst>::Type, std::ptrdiff_t>>;
   friend Facade;
 
   using Container = std::conditional_t<IsConst, const Bitset, Bitset>;
@@ -0,0 +1,73 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_CONTAINERS_BITSET_SET_BITS_HPP
+#define INCLUDE_THESAUROS_CONTAINERS_BITSET_SET_BITS_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+#include "thesauros/iterator/facade.hpp"
+
+namespace thes::ranges {
+/**
+ * The indices of the set bits in `Bitset`, in ascending order. Each step uses `find_next` or
+ * `find_prev`, so iterating takes time proportional to the number of set bits and zero chunks
+ * rather than the number of bits.
+ */
+template<typename Bitset>
+struct SetBitsRange {
+  struct const_iterator : public IteratorFacade<iter::ValueTypes<std::size_t, std::ptrdiff_t>> {
+    friend IteratorFacade<iter::ValueTypes<std::size_t, std::ptrdiff_t>>;
+
+    constexpr const_iterator() = default;
+    constexpr const_iterator(const Bitset& bitset, std::size_t index)
+        : bitset_(std::addressof(bitset)), index_(index) {}
+
+  private:
+    [[nodiscard]] constexpr std::size_t deref() const {
+      return index_;
+    }
+    constexpr void incr() {
+      index_ = bitset_->find_next(index_ + 1);
+    }
+    constexpr void decr() {
+      assert(index_ > 0);
+      index_ = bitset_->find_prev(index_ - 1);
+    }
+    [[nodiscard]] constexpr bool eq(const const_iterator& other) const {
+      assert(bitset_ == other.bitset_);
+      return index_ == other.index_;
+    }
+
+    const Bitset* bitset_{};
+    std::size_t index_{};
+  };
+
+  explicit constexpr SetBitsRange(const Bitset& bitset) : bitset_(std::addressof(bitset)) {}
+
+  [[nodiscard]] constexpr const_iterator begin() const {
+    return const_iterator{*bitset_, bitset_->find_next(0)};
+  }
+  [[nodiscard]] constexpr const_iterator end() const {
+    return const_iterator{*bitset_, bitset_->size()};
+  }
+
+private:
+  const Bitset* bitset_;
+};
+} // namespace thes::ranges
+
+namespace thes::views {
+/** The indices of the set bits in `bitset`, which has to outlive the range. */
+template<typename Bitset>
+constexpr auto set_bits(const Bitset& bitset) {
+  return ranges::SetBitsRange<Bitset>{bitset};
+}
+} // namespace thes::views
+
+#endif // INCLUDE_THESAUROS_CONTAINERS_BITSET_SET_BITS_HPP
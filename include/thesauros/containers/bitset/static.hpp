@@ -13,9 +13,11 @@
 #include <climits>
 #include <concepts>
 #include <cstddef>
+#include <span>
 #include <type_traits>
 #include <utility>
 
+#include "thesauros/containers/bitset/chunks.hpp"
 #include "thesauros/containers/bitset/iterator.hpp"
 #include "thesauros/math/arithmetic.hpp"
 #include "thesauros/ranges/indices.hpp"
@@ -102,6 +104,15 @@ struct StaticBitset {
     return countr([](const auto x) { return std::countr_one(x); });
   }
 
+  /** The index of the first set bit at or after `pos`, or `size()` if there is none. */
+  [[nodiscard]] constexpr std::size_t find_next(std::size_t pos) const {
+    return detail::bitset::find_next(std::span<const Chunk>{chunks_}, static_size, pos);
+  }
+  /** The index of the last set bit at or before `pos < size()`, or `size()` if there is none. */
+  [[nodiscard]] constexpr std::size_t find_prev(std::size_t pos) const {
+    return detail::bitset::find_prev(std::span<const Chunk>{chunks_}, static_size, pos);
+  }
+
   [[nodiscard]] constexpr std::size_t chunk_num() const {
     return static_chunk_num;
   }
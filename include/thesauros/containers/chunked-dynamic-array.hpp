@@ -283,8 +283,12 @@ private:
   template<typename Self>
   using SelfIterator = BaseIterator<std::is_const_v<std::remove_reference_t<Self>>>;
 
+  // The growth policy sees the values rather than the blocks, so that policies which depend on
+  // the value type or the allocator apply, and the result is rounded down to whole blocks.
   constexpr Size grown_size(Size new_size_lower_bound) const {
-    return GrowthPolicy::new_allocation_size(block_num_, new_size_lower_bound);
+    const auto value_num = growth_allocation_size<GrowthPolicy, Value>(
+      block_num_ * block_size_, new_size_lower_bound * block_size_, elements_.allocator());
+    return std::max(static_cast<Size>(value_num / block_size_), new_size_lower_bound);
   }
 
   Size block_size_;
@@ -8,10 +8,14 @@
 #define INCLUDE_THESAUROS_CONTAINERS_FLAT_MAP_HPP
 
 #include <algorithm>
+#include <concepts>
 #include <cstddef>
 #include <functional>
+#include <ranges>
+#include <type_traits>
 #include <utility>
 
+#include "thesauros/algorithms/stable-sort.hpp"
 #include "thesauros/containers/array/dynamic.hpp"
 #include "thesauros/containers/set-algorithms.hpp"
 
@@ -33,6 +37,23 @@ struct FlatMap {
 
   FlatMap() = default;
 
+  /**
+   * Builds the map from a range of key-value pairs by appending, sorting and deduplicating
+   * them in one go, which is much faster than inserting them one at a time.
+   * Of several entries with the same key, the first one is kept, as with `insert`.
+   */
+  template<std::ranges::input_range R>
+  requires(!std::same_as<std::remove_cvref_t<R>, FlatMap>)
+  explicit FlatMap(R&& range) {
+    insert_range(std::forward<R>(range));
+  }
+  /** Builds the map from a range of key-value pairs, sorting them in parallel using `expo`. */
+  template<std::ranges::input_range R, typename ExPo>
+  requires requires(const ExPo& expo) { expo.thread_num(); }
+  FlatMap(R&& range, const ExPo& expo) {
+    insert_range(std::forward<R>(range), expo);
+  }
+
   iterator begin() {
     return data_.begin();
   }
@@ -106,6 +127,34 @@ struct FlatMap {
     return true;
   }
 
+  /**
+   * Inserts all key-value pairs from `range` whose keys are not present yet, taking
+   * O(m log m + n) time for n entries in the map and m in `range`.
+   * Of several new entries with the same key, the first one is kept.
+   */
+  template<std::ranges::input_range R>
+  void insert_range(R&& range) {
+    bulk_insert(std::forward<R>(range), [this](iterator first, iterator last) {
+      std::stable_sort(first, last, PairCompare{compare_});
+    });
+  }
+  /** Inserts all key-value pairs from `range`, sorting them in parallel using `expo`. */
+  template<std::ranges::input_range R, typename ExPo>
+  requires requires(const ExPo& expo) { expo.thread_num(); }
+  void insert_range(R&& range, const ExPo& expo) {
+    bulk_insert(std::forward<R>(range), [this, &expo](iterator first, iterator last) {
+      thes::stable_sort(first, last, expo, PairCompare{compare_});
+    });
+  }
+
+  /**
+   * Inserts the entries of `other` whose keys are not present yet in linear time,
+   * making use of both maps being sorted.
+   */
+  void merge(const FlatMap& other) {
+    set_union(other.data_);
+  }
+
   Mapped& get_or_insert(const Key& key, Mapped&& value) {
     const auto iter = lower_bound(key);
     if (iter != end() && PairEqual{equal_}(*iter, key)) {
@@ -159,6 +208,19 @@ struct FlatMap {
   }
 
 private:
+  template<typename R>
+  void bulk_insert(R&& range, auto sort) {
+    const std::size_t old_size = data_.size();
+    if constexpr (std::ranges::sized_range<R>) {
+      data_.reserve(old_size + std::ranges::size(range));
+    }
+    for (auto&& value : range) {
+      data_.push_back(Value(std::forward<decltype(value)>(value)));
+    }
+    sort(data_.begin() + std::ptrdiff_t(old_size), data_.end());
+    thes::merge_unique(data_, old_size, PairCompare{compare_}, PairEqual{equal_});
+  }
+
   template<typename Op>
   struct PairOp {
     [[no_unique_address]] Op op_{};
@@ -8,9 +8,14 @@
 #define INCLUDE_THESAUROS_CONTAINERS_FLAT_SET_HPP
 
 #include <algorithm>
+#include <concepts>
 #include <cstddef>
 #include <functional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
 
+#include "thesauros/algorithms/stable-sort.hpp"
 #include "thesauros/containers/array/dynamic.hpp"
 #include "thesauros/containers/set-algorithms.hpp"
 
@@ -26,6 +31,22 @@ struct FlatSet {
 
   FlatSet() = default;
 
+  /**
+   * Builds the set from a range of values by appending, sorting and deduplicating them
+   * in one go, which is much faster than inserting them one at a time.
+   */
+  template<std::ranges::input_range R>
+  requires(!std::same_as<std::remove_cvref_t<R>, FlatSet>)
+  explicit FlatSet(R&& range) {
+    insert_range(std::forward<R>(range));
+  }
+  /** Builds the set from a range of values, sorting them in parallel using `expo`. */
+  template<std::ranges::input_range R, typename ExPo>
+  requires requires(const ExPo& expo) { expo.thread_num(); }
+  FlatSet(R&& range, const ExPo& expo) {
+    insert_range(std::forward<R>(range), expo);
+  }
+
   const_iterator begin() const {
     return data_.begin();
   }
@@ -79,6 +100,30 @@ struct FlatSet {
     data_.insert(it, value);
   }
 
+  /**
+   * Inserts all values from `range` which are not present yet, taking O(m log m + n) time
+   * for n values in the set and m in `range`.
+   */
+  template<std::ranges::input_range R>
+  void insert_range(R&& range) {
+    bulk_insert(std::forward<R>(range), [this](auto first, auto last) {
+      std::stable_sort(first, last, compare_);
+    });
+  }
+  /** Inserts all values from `range`, sorting them in parallel using `expo`. */
+  template<std::ranges::input_range R, typename ExPo>
+  requires requires(const ExPo& expo) { expo.thread_num(); }
+  void insert_range(R&& range, const ExPo& expo) {
+    bulk_insert(std::forward<R>(range), [this, &expo](auto first, auto last) {
+      thes::stable_sort(first, last, expo, compare_);
+    });
+  }
+
+  /** Inserts the values of `other` which are not present yet in linear time. */
+  void merge(const FlatSet& other) {
+    set_union(other.data_);
+  }
+
   bool erase(const auto& value) {
     const auto it{lower_bound(value)};
     if (it != end() && equal_(*it, value)) {
@@ -108,6 +153,19 @@ struct FlatSet {
   }
 
 private:
+  template<typename R>
+  void bulk_insert(R&& range, auto sort) {
+    const std::size_t old_size = data_.size();
+    if constexpr (std::ranges::sized_range<R>) {
+      data_.reserve(old_size + std::ranges::size(range));
+    }
+    for (auto&& value : range) {
+      data_.push_back(V(std::forward<decltype(value)>(value)));
+    }
+    sort(data_.begin() + std::ptrdiff_t(old_size), data_.end());
+    thes::merge_unique(data_, old_size, compare_, equal_);
+  }
+
   auto lower_bound(const auto& value) {
     return std::lower_bound(data_.begin(), data_.end(), value, compare_);
   }
@@ -255,6 +255,79 @@ struct NestedDynamicArray : public NestedDynamicArrayBase<
 
   using Parent::Parent;
 };
+
+/**
+ * A const view of a nested array whose offsets and values are stored elsewhere, e.g. in a
+ * memory-mapped file, with the same layout and read-only interface as `NestedDynamicArray`.
+ */
+template<typename T, typename S>
+struct NestedDynamicArrayView {
+  using Value = T;
+  using Size = S;
+
+  using value_type = Value;
+  using size_type = Size;
+
+  using const_iterator = NestedDynamicArray<T, S>::const_iterator;
+  using iterator = const_iterator;
+
+  NestedDynamicArrayView(std::span<const Size> offsets, std::span<const Value> values)
+      : offsets_(offsets), values_(values) {
+    assert(!offsets_.empty());
+    assert(offsets_.back() == values_.size());
+  }
+
+  const_iterator begin() const {
+    return const_iterator(offsets_.data(), values_.data(), 0);
+  }
+  const_iterator end() const {
+    return const_iterator(offsets_.data(), values_.data(), group_num());
+  }
+
+  std::span<const Value> operator[](Size index) const {
+    assert(index + 1 < offsets_.size());
+    assert(offsets_[index] <= offsets_[index + 1]);
+    return values_.subspan(offsets_[index], offsets_[index + 1] - offsets_[index]);
+  }
+  std::span<const value_type> front() const {
+    assert(!empty());
+    return (*this)[0];
+  }
+  std::span<const value_type> back() const {
+    assert(!empty());
+    return (*this)[size() - 1];
+  }
+
+  /** The group offsets, of which there is one more than there are groups. */
+  [[nodiscard]] std::span<const Size> offsets() const noexcept {
+    return offsets_;
+  }
+  /** The elements of all groups, stored contiguously. */
+  [[nodiscard]] std::span<const Value> values() const noexcept {
+    return values_;
+  }
+
+  [[nodiscard]] Size group_num() const {
+    return static_cast<Size>(offsets_.size() - 1);
+  }
+  [[nodiscard]] Size size() const noexcept {
+    return group_num();
+  }
+  [[nodiscard]] bool empty() const noexcept {
+    return size() == 0;
+  }
+
+  [[nodiscard]] Size element_num() const {
+    return static_cast<Size>(values_.size());
+  }
+  [[nodiscard]] Size flat_size() const noexcept {
+    return element_num();
+  }
+
+private:
+  std::span<const Size> offsets_;
+  std::span<const Value> values_;
+};
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_CONTAINERS_NESTED_DYNAMIC_ARRAY_HPP
@@ -45,8 +45,21 @@ inline void set_union_unsorted(MutRange& r1, const OtherRange& r2, Cmp cmp = Cmp
 template<typename MutRange, typename OtherRange, typename Cmp = std::less<>,
          typename Eq = std::equal_to<>>
 inline void set_union(MutRange& r1, const OtherRange& r2, Cmp cmp = Cmp{}, Eq eq = Eq{}) {
+  const auto size1 = std::ptrdiff_t(r1.size());
   set_union_unsorted(r1, r2, cmp, eq);
-  std::sort(r1.begin(), r1.end(), cmp);
+  // The appended elements are sorted as well, so merging the two parts takes linear time.
+  std::inplace_merge(r1.begin(), r1.begin() + size1, r1.end(), cmp);
+}
+
+/**
+ * Merges the sorted parts `[begin, begin + mid)` and `[begin + mid, end)` of `r` and keeps
+ * only the first of each run of equal elements, which prefers the first part on ties.
+ * Both steps take linear time if `std::inplace_merge` can allocate its buffer.
+ */
+template<typename MutRange, typename Cmp = std::less<>, typename Eq = std::equal_to<>>
+inline void merge_unique(MutRange& r, std::size_t mid, Cmp cmp = Cmp{}, Eq eq = Eq{}) {
+  std::inplace_merge(r.begin(), r.begin() + std::ptrdiff_t(mid), r.end(), cmp);
+  r.erase(std::unique(r.begin(), r.end(), eq), r.end());
 }
 
 template<typename MutRange, typename OtherRange, typename Cmp = std::less<>,
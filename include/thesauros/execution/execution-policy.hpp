@@ -3,6 +3,8 @@
 
 // IWYU pragma: begin_exports
 #include "execution-policy/linear.hpp"
+#include "execution-policy/self-scheduling.hpp"
+#include "execution-policy/work-stealing.hpp"
 // IWYU pragma: end_exports
 
 #endif // INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_HPP
@@ -8,6 +8,7 @@
 #define INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_LINEAR_HPP
 
 #include <cstddef>
+#include <utility>
 
 #include "thesauros/utility/index-segmentation.hpp"
 
@@ -27,6 +28,14 @@ struct LinearExecutionPolicy {
       f(thread_idx, begin, end);
     });
   }
+  /**
+   * Call `f(thread_idx, begin, end)` for disjoint chunks covering `[0, size)`, which is one
+   * segment per thread here, but may be many smaller chunks for dynamically scheduled policies.
+   */
+  template<typename S, typename F>
+  void execute_chunked(S size, F&& f) const {
+    execute_segmented(size, std::forward<F>(f));
+  }
   [[nodiscard]] std::size_t thread_num() const {
     return executor_.thread_num();
   }
@@ -0,0 +1,128 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_SELF_SCHEDULING_HPP
+#define INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_SELF_SCHEDULING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/memory/cache-line.hpp"
+#include "thesauros/types/primitives.hpp"
+#include "thesauros/utility/index-segmentation.hpp"
+
+namespace thes {
+/** The size of the chunks handed out by a `SelfSchedulingExecutionPolicy`. */
+enum struct ChunkSchedule : u8 {
+  /** Every chunk has the same number of blocks, like OpenMP’s `schedule(dynamic, n)`. */
+  dynamic,
+  /**
+   * Every chunk has the number of remaining blocks divided by the number of threads, but at least
+   * the given number of blocks, like OpenMP’s `schedule(guided, n)`.
+   */
+  guided,
+};
+
+/**
+ * An execution policy in which the threads of the executor repeatedly claim the next chunk of
+ * `[0, size)` from a shared cursor until none is left.
+ *
+ * The indices are grouped into blocks by a `BlockedIndexSegmenter`, whose boundaries are the only
+ * ones chunks can start or end at, and the cursor counts blocks. The cursor is a member on a cache
+ * line of its own, so that dispatching a region allocates nothing and the claims do not interfere
+ * with the data of the caller.
+ *
+ * This is cheaper than `WorkStealingExecutionPolicy` if the chunks are large enough for the
+ * contention on the cursor not to matter, but does not preserve locality.
+ */
+template<typename E>
+struct SelfSchedulingExecutionPolicy {
+  using Executor = E;
+
+  /**
+   * @param block_size  The number of indices per block.
+   * @param chunk_blocks The number of blocks per chunk for `ChunkSchedule::dynamic` or the minimum
+   *                     number of blocks per chunk for `ChunkSchedule::guided`.
+   */
+  explicit SelfSchedulingExecutionPolicy(const E& executor,
+                                         ChunkSchedule schedule = ChunkSchedule::guided,
+                                         std::size_t block_size = 1, std::size_t chunk_blocks = 1)
+      : executor_(executor), schedule_(schedule), block_size_(std::max(block_size, std::size_t{1})),
+        chunk_blocks_(std::max(chunk_blocks, std::size_t{1})) {}
+
+  /**
+   * Call `f(thread_idx, begin, end)` for disjoint chunks covering `[0, size)`, where `thread_idx`
+   * is the index of the thread running the chunk.
+   */
+  template<typename S, typename F>
+  void execute_chunked(S size, F&& f) const { // NOLINT(*-missing-std-forward)
+    const S block_size = S(block_size_);
+    const std::size_t block_num = std::size_t(div_ceil(size, block_size));
+    if (block_num == 0) {
+      return;
+    }
+    // Each block forms a segment of its own, so that the segmenter provides the block boundaries,
+    // including the truncation of the last block.
+    const BlockedIndexSegmenter<S, std::size_t> blocks(size, block_num, block_size);
+
+    cursor_.value.store(0, std::memory_order_relaxed);
+    executor_.execute([&](std::size_t thread_idx) {
+      while (const std::optional<std::pair<std::size_t, std::size_t>> chunk = claim(block_num)) {
+        f(thread_idx, blocks.segment_start(chunk->first), blocks.segment_start(chunk->second));
+      }
+    });
+  }
+
+  [[nodiscard]] std::size_t thread_num() const {
+    return executor_.thread_num();
+  }
+
+  [[nodiscard]] const Executor& executor() const {
+    return executor_;
+  }
+
+private:
+  /** Claim the next chunk of blocks, if any are left. */
+  std::optional<std::pair<std::size_t, std::size_t>> claim(std::size_t block_num) const {
+    std::atomic<std::size_t>& cursor = cursor_.value;
+
+    if (schedule_ == ChunkSchedule::dynamic) {
+      // Once the cursor has passed the end, it only ever grows by `chunk_blocks_` per thread.
+      const std::size_t first = cursor.fetch_add(chunk_blocks_, std::memory_order_relaxed);
+      if (first >= block_num) {
+        return std::nullopt;
+      }
+      return std::make_pair(first, std::min(first + chunk_blocks_, block_num));
+    }
+
+    const std::size_t thread_num = std::max(executor_.thread_num(), std::size_t{1});
+    std::size_t first = cursor.load(std::memory_order_relaxed);
+    while (true) {
+      if (first >= block_num) {
+        return std::nullopt;
+      }
+      const std::size_t remaining = block_num - first;
+      const std::size_t chunk =
+        std::min(std::max(remaining / thread_num, chunk_blocks_), remaining);
+      if (cursor.compare_exchange_weak(first, first + chunk, std::memory_order_relaxed)) {
+        return std::make_pair(first, first + chunk);
+      }
+    }
+  }
+
+  const Executor& executor_;
+  ChunkSchedule schedule_;
+  std::size_t block_size_;
+  std::size_t chunk_blocks_;
+  mutable CacheAligned<std::atomic<std::size_t>> cursor_{};
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_SELF_SCHEDULING_HPP
@@ -0,0 +1,167 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_WORK_STEALING_HPP
+#define INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_WORK_STEALING_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/memory/cache-line.hpp"
+#include "thesauros/types/primitives.hpp"
+#include "thesauros/utility/index-segmentation.hpp"
+
+namespace thes {
+/**
+ * An execution policy which splits `[0, size)` into chunks and balances them dynamically between
+ * the threads of the executor by work stealing.
+ *
+ * Each thread starts with a uniform share of the chunks in a deque of its own, from the front of
+ * which it takes chunks one by one. A thread whose deque has run dry steals the back half of the
+ * deque of another thread, runs its first chunk and publishes the rest in its own deque, where it
+ * can in turn be stolen from. Since the chunks in a deque are always contiguous, a deque is just a
+ * pair of chunk indices packed into a single atomic word, so that both taking and stealing are
+ * one compare-and-swap and nothing is allocated per region.
+ *
+ * In contrast to `LinearExecutionPolicy::execute_segmented`, each thread may process any number of
+ * chunks, which is why only `execute_chunked` is provided.
+ */
+template<typename E>
+struct WorkStealingExecutionPolicy {
+  using Executor = E;
+
+  /** The number of chunks per thread aimed for when no chunk size is given. */
+  static constexpr std::size_t default_chunks_per_thread = 16;
+
+  /**
+   * @param chunk_size The number of indices per chunk, or zero to derive it from the size of each
+   *                   region such that every thread starts out with `default_chunks_per_thread`.
+   */
+  explicit WorkStealingExecutionPolicy(const E& executor, std::size_t chunk_size = 0)
+      : executor_(executor), chunk_size_(chunk_size), deques_(executor.thread_num()) {}
+
+  /**
+   * Call `f(thread_idx, begin, end)` for disjoint chunks covering `[0, size)`, where `thread_idx`
+   * is the index of the thread running the chunk.
+   */
+  template<typename S, typename F>
+  void execute_chunked(S size, F&& f) const { // NOLINT(*-missing-std-forward)
+    const std::size_t thread_num = executor_.thread_num();
+    const S chunk_size = chunk_size_for(size);
+    const std::size_t chunk_num = (size == 0) ? 0 : std::size_t(div_ceil(size, chunk_size));
+
+    UniformIndexSegmenter<std::size_t, std::size_t> initial(chunk_num, thread_num);
+    for (std::size_t t = 0; t < thread_num; ++t) {
+      deques_[t].value.store(pack(initial.segment_start(t), initial.segment_end(t)),
+                             std::memory_order_relaxed);
+    }
+
+    executor_.execute([&](std::size_t thread_idx) {
+      auto run = [&](std::size_t chunk) {
+        const S begin = S(chunk * chunk_size);
+        const S end = std::min(S(begin + chunk_size), size);
+        f(thread_idx, begin, end);
+      };
+
+      Deque& own = deques_[thread_idx].value;
+      while (true) {
+        while (const std::optional<std::size_t> chunk = take(own)) {
+          run(*chunk);
+        }
+        const std::optional<std::pair<std::size_t, std::size_t>> stolen = steal(thread_idx);
+        if (!stolen.has_value()) {
+          break;
+        }
+        // The own deque is empty, in which case other threads never modify it.
+        own.store(pack(stolen->first + 1, stolen->second), std::memory_order_release);
+        run(stolen->first);
+      }
+    });
+  }
+
+  [[nodiscard]] std::size_t thread_num() const {
+    return executor_.thread_num();
+  }
+
+  [[nodiscard]] const Executor& executor() const {
+    return executor_;
+  }
+
+private:
+  // The front chunk index in the low half, the one-past-the-back chunk index in the high half.
+  using Deque = std::atomic<u64>;
+  static constexpr unsigned half_bits = 32;
+  static constexpr u64 half_mask = (u64{1} << half_bits) - 1;
+
+  static constexpr u64 pack(std::size_t front, std::size_t back) {
+    return u64{front} | (u64{back} << half_bits);
+  }
+  static constexpr std::pair<std::size_t, std::size_t> unpack(u64 deque) {
+    return {std::size_t(deque & half_mask), std::size_t(deque >> half_bits)};
+  }
+
+  template<typename S>
+  S chunk_size_for(S size) const {
+    // The chunk indices have to fit into one half of the deque word.
+    const S min_chunk_size = std::max(S(div_ceil(u64(size), half_mask)), S{1});
+    if (chunk_size_ > 0) {
+      return std::max(S(chunk_size_), min_chunk_size);
+    }
+    const std::size_t target = std::max(executor_.thread_num(), std::size_t{1}) *
+                               default_chunks_per_thread;
+    return std::max(S(size / target), min_chunk_size);
+  }
+
+  /** Take the chunk at the front of the calling thread’s own deque. */
+  static std::optional<std::size_t> take(Deque& deque) {
+    u64 current = deque.load(std::memory_order_acquire);
+    while (true) {
+      const auto [front, back] = unpack(current);
+      if (front >= back) {
+        return std::nullopt;
+      }
+      if (deque.compare_exchange_weak(current, pack(front + 1, back), std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return front;
+      }
+    }
+  }
+
+  /** Steal the back half of the first non-empty deque of another thread, starting after `own`. */
+  std::optional<std::pair<std::size_t, std::size_t>> steal(std::size_t own) const {
+    const std::size_t thread_num = executor_.thread_num();
+    for (std::size_t offset = 1; offset < thread_num; ++offset) {
+      Deque& victim = deques_[(own + offset) % thread_num].value;
+      u64 current = victim.load(std::memory_order_acquire);
+      while (true) {
+        const auto [front, back] = unpack(current);
+        if (front >= back) {
+          break;
+        }
+        // A stolen range is never returned to its previous deque, so the same non-empty word
+        // cannot reappear after being modified, which rules out ABA problems.
+        const std::size_t mid = back - (back - front + 1) / 2;
+        if (victim.compare_exchange_weak(current, pack(front, mid), std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+          return std::make_pair(mid, back);
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  const Executor& executor_;
+  std::size_t chunk_size_;
+  mutable FixedArray<CacheAligned<Deque>> deques_;
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_EXECUTION_EXECUTION_POLICY_WORK_STEALING_HPP
@@ -5,6 +5,7 @@
 #include "executor/fixed-omp-thread-pool.hpp"
 #include "executor/fixed-std-thread-pool.hpp"
 #include "executor/fixed-thread-pool.hpp"
+#include "executor/hierarchical-thread-pool.hpp"
 #include "executor/sequential.hpp"
 // IWYU pragma: end_exports
 
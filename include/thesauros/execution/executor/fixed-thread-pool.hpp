@@ -7,31 +7,52 @@
 #ifndef INCLUDE_THESAUROS_EXECUTION_EXECUTOR_FIXED_THREAD_POOL_HPP
 #define INCLUDE_THESAUROS_EXECUTION_EXECUTOR_FIXED_THREAD_POOL_HPP
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <concepts>
 #include <cstddef>
 #include <exception>
 #include <functional>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <ranges>
 #include <stdexcept>
 #include <thread>
+#include <type_traits>
 #include <utility>
 
 #include <pthread.h>
 
 #include "thesauros/charconv/concat.hpp"
 #include "thesauros/containers/array/fixed-alloc.hpp"
+#include "thesauros/containers/array/fixed.hpp"
 #include "thesauros/execution/system/affinity.hpp"
+#include "thesauros/execution/system/combining-tree.hpp"
+#include "thesauros/execution/system/region-profiler.hpp"
 #include "thesauros/execution/system/spin.hpp"
 #include "thesauros/math/integer-cast.hpp"
+#include "thesauros/memory/cache-line.hpp"
 #include "thesauros/ranges/index-type.hpp"
 #include "thesauros/ranges/indices.hpp"
 #include "thesauros/types/empty.hpp"
+#include "thesauros/types/primitives.hpp"
 
 namespace thes {
+/** How the threads of a `FixedThreadPool` report the completion of their index. */
+enum struct CompletionStrategy : u8 {
+  /** Every thread decrements one shared counter, which is cheapest for small pools. */
+  counter,
+  /**
+   * The threads arrive at a `CombiningTree`, which bounds the contention per cache line at the
+   * cost of a few more atomic operations, for pools with dozens of threads or more.
+   */
+  tree,
+};
+
 /**
  * A thread pool of a fixed size which aims to make the dispatch of a parallel region as cheap as
  * an OpenMP one while relying on nothing but the standard library.
@@ -43,13 +64,34 @@ namespace thes {
  *   caller’s stack for the duration of the blocking `execute`, so nothing is allocated or copied.
  * - Threads spin for `spin_count` iterations before parking on `std::atomic::wait`, which maps to
  *   `futex` on Linux, `__ulock_wait` on macOS and `WaitOnAddress` on Windows. Back-to-back regions
- *   therefore never enter the kernel, while a pool left idle stops consuming CPU time.
+ *   therefore never enter the kernel, while a pool left idle stops consuming CPU time. With
+ *   `adaptive_spin_count`, the workers derive how long to spin from the recent gaps between
+ *   regions instead, and `wakeup_counts` tells how often the threads actually had to park.
  *
  * Unlike an OpenMP parallel region, an exception escaping a task is not fatal: the first one is
  * captured and rethrown from `execute` on the calling thread.
  *
- * `execute` must only be called from the thread that created the pool and never from within a
- * task, which is checked by an assertion.
+ * Tasks can synchronize all indices of their region with `barrier`, which is built on a
+ * `CombiningTree` and owned by the pool, so that it costs nothing to set up per region. The
+ * completion of a region can be detected through the same kind of tree instead of a single counter
+ * by passing `CompletionStrategy::tree`.
+ *
+ * If `THES_PROFILE_EXECUTION` is true, the pool records the timings of each region it dispatches
+ * to the workers in a `RegionProfiler`, which includes those of the execution policies using it.
+ *
+ * `submit` dispatches a region to the worker threads alone and returns immediately, so that the
+ * calling thread can do something else, e.g. I/O, until it waits for the returned `Submission`.
+ *
+ * Recursive algorithms can use the pool through `fork_join`, which lets a task hand one of two
+ * callables to another thread of the pool while running the other one itself. In regions
+ * dispatched with `execute_fork_join`, threads done with their index pick up these forked jobs
+ * until all indices have finished, and so does a thread waiting for a job it forked. Each thread
+ * keeps the jobs it forks in a deque of its own, from which the other threads steal the oldest
+ * ones, so forking and helping take no locks, and idle helpers are only woken if any are parked.
+ *
+ * `execute`, `execute_fork_join` and `submit` must only be called from the thread that created the
+ * pool, never from within a task and never while a submitted region is pending, which is checked
+ * by assertions.
  */
 struct FixedThreadPool {
   /**
@@ -58,11 +100,72 @@ struct FixedThreadPool {
    * of microseconds, in the spirit of libgomp’s `GOMP_SPINCOUNT`; zero parks immediately.
    */
   static constexpr std::size_t default_spin_count = std::size_t{1} << 14U;
+  /**
+   * The spin count requesting adaptive spinning: The calling thread tracks a moving average of the
+   * time between the end of a region and the dispatch of the next one, and the workers spin for
+   * twice that long if it is at most `max_adaptive_spin`, and park immediately otherwise. The other
+   * waits of the pool use `default_spin_count`.
+   */
+  static constexpr std::size_t adaptive_spin_count = std::numeric_limits<std::size_t>::max();
+  /** The longest gap between regions for which adaptive spinning does not park immediately. */
+  static constexpr std::chrono::microseconds max_adaptive_spin{50};
   /** The largest supported pool size, imposed by the packing of the dispatch state. */
   static constexpr std::size_t max_thread_num = (std::size_t{1} << 16U) - 1;
 
   using Threads = FixedAllocArray<std::jthread>;
 
+  /** How often the threads of the pool have parked, i.e. gone through the futex to wake up. */
+  struct WakeupCounts {
+    /** The number of regions dispatched to the worker threads. */
+    std::size_t regions;
+    /** The number of times a worker thread parked while waiting for a region. */
+    std::size_t worker_parks;
+    /** The number of times the calling thread parked while waiting for a region to complete. */
+    std::size_t owner_parks;
+  };
+
+  /**
+   * The handle of a region dispatched by `submit`, which can be polled with `ready` and has to be
+   * waited for with `wait` before the pool is used again. If that has not happened by the time the
+   * handle is destroyed, the destructor waits, discarding any exception.
+   */
+  struct [[nodiscard]] Submission {
+    Submission(const Submission&) = delete;
+    Submission(Submission&& other) noexcept : pool_{std::exchange(other.pool_, nullptr)} {}
+    Submission& operator=(const Submission&) = delete;
+    Submission& operator=(Submission&&) = delete;
+
+    ~Submission() {
+      if (pool_ != nullptr) {
+        (void)pool_->finish_submission();
+      }
+    }
+
+    /** Whether all indices of the region have finished, in which case `wait` does not block. */
+    [[nodiscard]] bool ready() const {
+      return pool_ == nullptr || pool_->unfinished_.load(std::memory_order_acquire) == 0;
+    }
+
+    /**
+     * Block until all indices of the region have finished and rethrow the first exception any of
+     * them produced.
+     */
+    void wait() {
+      if (pool_ == nullptr) {
+        return;
+      }
+      if (std::exception_ptr exception = std::exchange(pool_, nullptr)->finish_submission()) {
+        std::rethrow_exception(std::move(exception));
+      }
+    }
+
+  private:
+    friend struct FixedThreadPool;
+    explicit Submission(const FixedThreadPool* pool) : pool_{pool} {}
+
+    const FixedThreadPool* pool_;
+  };
+
   /**
    * Create a pool of `size` threads, of which the calling thread is one.
    * @param cpu_sets The CPU sets to pin the threads to, with the first entry applying to the
@@ -70,8 +173,13 @@ struct FixedThreadPool {
    */
   template<typename CpuSets = Empty>
   explicit FixedThreadPool(std::size_t size, const CpuSets& cpu_sets = {},
-                           std::size_t spin_count = default_spin_count)
-      : thread_num_{size}, spin_count_{spin_count},
+                           std::size_t spin_count = default_spin_count,
+                           CompletionStrategy completion = CompletionStrategy::counter)
+      : thread_num_{size},
+        spin_count_{(spin_count == adaptive_spin_count) ? default_spin_count : spin_count},
+        adaptive_{spin_count == adaptive_spin_count}, completion_{completion},
+        completion_tree_{(completion == CompletionStrategy::tree) ? size : 0},
+        barrier_tree_{size}, profiler_{size}, deques_(size),
         threads_{Threads::create_with_capacity(worker_num(size))} {
     if constexpr (!std::same_as<CpuSets, Empty>) {
       if (size > cpu_sets.size()) {
@@ -98,16 +206,18 @@ struct FixedThreadPool {
 
   /** Create a pool pinning each thread to one of the CPUs described by `cpu_infos`. */
   template<typename CpuInfos = Empty>
-  static FixedThreadPool from_cpu_infos(std::size_t size, CpuInfos&& cpu_infos = {},
-                                        std::size_t spin_count = default_spin_count) {
+  static FixedThreadPool
+  from_cpu_infos(std::size_t size, CpuInfos&& cpu_infos = {},
+                 std::size_t spin_count = default_spin_count,
+                 CompletionStrategy completion = CompletionStrategy::counter) {
     if constexpr (std::same_as<CpuInfos, Empty>) {
-      return FixedThreadPool{size, Empty{}, spin_count};
+      return FixedThreadPool{size, Empty{}, spin_count, completion};
     } else {
       return FixedThreadPool{
         size,
         std::views::transform(std::forward<CpuInfos>(cpu_infos),
                               [](auto cpu) { return CpuSet::single_set(cpu.id); }),
-        spin_count};
+        spin_count, completion};
     }
   }
 
@@ -117,6 +227,7 @@ struct FixedThreadPool {
   FixedThreadPool& operator=(FixedThreadPool&&) = delete;
 
   ~FixedThreadPool() {
+    assert(!pending_);
     stop_.store(true, std::memory_order_relaxed);
     state_.fetch_add(epoch_step, std::memory_order_release);
     state_.notify_all();
@@ -126,6 +237,45 @@ struct FixedThreadPool {
     return thread_num_;
   }
 
+#if THES_PROFILE_EXECUTION
+  /** The profiles of the regions dispatched so far, which must only be queried by the owner. */
+  [[nodiscard]] RegionProfiler& profiler() const {
+    assert(std::this_thread::get_id() == owner_);
+    return profiler_;
+  }
+#endif
+
+  /** The number of regions and parks so far, which must only be queried by the owner. */
+  [[nodiscard]] WakeupCounts wakeup_counts() const {
+    assert(std::this_thread::get_id() == owner_);
+    return {
+      .regions = regions_,
+      .worker_parks = worker_parks_.load(std::memory_order_relaxed),
+      .owner_parks = owner_parks_,
+    };
+  }
+
+  /**
+   * The number of iterations the workers spin for while waiting for the next region, which is
+   * adapted before each region with `adaptive_spin_count` and fixed otherwise.
+   */
+  [[nodiscard]] std::size_t worker_spin_count() const {
+    return adaptive_ ? worker_spin_count_.load(std::memory_order_relaxed) : spin_count_;
+  }
+
+  /**
+   * The number of iterations the workers spin for with adaptive spinning if the regions are
+   * `mean_gap` apart on average: enough to cover twice the gap, or none if it exceeds
+   * `max_adaptive_spin`.
+   */
+  [[nodiscard]] static std::size_t
+  spin_count_for_gap(std::chrono::duration<double, std::nano> mean_gap) {
+    if (mean_gap > max_adaptive_spin) {
+      return 0;
+    }
+    return std::size_t(2.0 * mean_gap.count() / std::max(spin_pause_nanos(), 1e-3)) + 1;
+  }
+
   /**
    * Run `task` on the thread indices `[0, used_thread_num)`, blocking until all of them are done,
    * and rethrow the first exception any of them produced.
@@ -133,78 +283,316 @@ struct FixedThreadPool {
   template<typename Task>
   requires(std::invocable<const Task&, std::size_t>)
   void execute(const Task& task, std::optional<std::size_t> used_thread_num = {}) const {
-    const std::size_t used = used_thread_num.value_or(thread_num_);
-    assert(used <= thread_num_);
+    execute_region(task, used_thread_num, false);
+  }
+
+  /**
+   * Like `execute`, but the threads which are done with their index execute the jobs forked by
+   * `fork_join` until all indices are done, instead of waiting for the next region.
+   */
+  template<typename Task>
+  requires(std::invocable<const Task&, std::size_t>)
+  void execute_fork_join(const Task& task, std::optional<std::size_t> used_thread_num = {}) const {
+    execute_region(task, used_thread_num, true);
+  }
+
+  /**
+   * Run `f0` and `f1`, possibly in parallel, and return once both are done, rethrowing the first
+   * exception either of them produced.
+   *
+   * `f1` is offered to the other threads of the pool, while the calling thread runs `f0`. If no
+   * thread has taken `f1` by then, the calling thread runs it as well; otherwise, it executes other
+   * forked jobs until `f1` is done. This can be called from any task and recursively, but `f1` is
+   * only run in parallel within regions dispatched by `execute_fork_join`.
+   */
+  template<typename F0, typename F1>
+  requires(std::invocable<const F0&> && std::invocable<const F1&>)
+  void fork_join(const F0& f0, const F1& f1) const {
+    Job job{[](const void* data) { std::invoke(*static_cast<const F1*>(data)); },
+            std::addressof(f1)};
+    // Outside of the tasks of this pool or with a full deque, `f1` is run after `f0`.
+    const CurrentThread current = current_thread_;
+    JobDeque* deque = (current.pool == this) ? &deques_[current.index] : nullptr;
+    const bool pushed = deque != nullptr && push_job(*deque, job);
+    if (pushed) {
+      wake_helpers();
+    }
+
+    std::exception_ptr exception{};
+    try {
+      std::invoke(f0);
+    } catch (...) {
+      exception = std::current_exception();
+    }
+
+    // The jobs forked by `f0` have all been joined, so `job` is at the bottom unless stolen.
+    if (!pushed || take_job(*deque) != nullptr) {
+      run_job(job);
+    } else {
+      help(current.index, [&job] { return job.done.load(std::memory_order_acquire); });
+    }
+
+    if (exception == nullptr) {
+      exception = std::move(job.exception);
+    }
+    if (exception != nullptr) {
+      std::rethrow_exception(std::move(exception));
+    }
+  }
+
+  /**
+   * Block until all indices of the current region have called `barrier`, where `index` is the
+   * index the task has been called with.
+   *
+   * As with `std::barrier`, every index of the region has to call this the same number of times,
+   * and an index which leaves its task early, e.g. through an exception, leaves the others waiting.
+   */
+  void barrier(std::size_t index) const {
+    // The round cannot complete before this thread has arrived, so the epoch is still the old one.
+    const std::size_t epoch = barrier_epoch_.load(std::memory_order_acquire);
+    if (barrier_tree_.arrive(index, participants_)) {
+      barrier_epoch_.store(epoch + 1, std::memory_order_release);
+      barrier_epoch_.notify_all();
+      return;
+    }
+
+    for (std::size_t i = spin_count_; i > 0; --i) {
+      if (barrier_epoch_.load(std::memory_order_acquire) != epoch) {
+        return;
+      }
+      spin_pause();
+    }
+    while (barrier_epoch_.load(std::memory_order_acquire) == epoch) {
+      barrier_epoch_.wait(epoch, std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * Run `task` on the indices `[0, used_thread_num)` using only the worker threads, i.e. on at most
+   * `thread_num() - 1` indices, and return without waiting for them.
+   *
+   * As in `execute`, nothing is copied or allocated, so `task` has to stay alive until the returned
+   * `Submission` has been waited for. For a pool without worker threads, `task` runs on index 0 of
+   * the calling thread before `submit` returns.
+   */
+  template<typename Task>
+  requires(std::invocable<const Task&, std::size_t>)
+  Submission submit(const Task& task, std::optional<std::size_t> used_thread_num = {}) const {
+    const std::size_t workers = threads_.size();
+    const std::size_t used = used_thread_num.value_or(std::max(workers, std::size_t{1}));
+    assert(used <= std::max(workers, std::size_t{1}));
     assert(std::this_thread::get_id() == owner_);
+    assert(!pending_);
 
     if (used == 0) {
-      return;
+      return Submission{nullptr};
     }
-    if (used == 1) {
+    participants_ = used;
+    if (workers == 0) {
       std::invoke(task, std::size_t{0});
-      return;
+      return Submission{nullptr};
+    }
+
+    pending_ = true;
+    dispatch(task, used, true);
+    return Submission{this};
+  }
+  /** A temporary task would be destroyed before the workers are done with it. */
+  template<typename Task>
+  Submission submit(const Task&& task, std::optional<std::size_t> used_thread_num = {}) const =
+    delete;
+
+private:
+  // The dispatch state packs the number of participating indices into the low bits, followed by a
+  // flag set for regions in which the calling thread does not participate, and a counter of the
+  // regions dispatched so far into the high bits.
+  static constexpr std::size_t used_mask = max_thread_num;
+  static constexpr std::size_t detached_flag = max_thread_num + 1;
+  static constexpr std::size_t fork_join_flag = detached_flag << 1U;
+  static constexpr std::size_t epoch_step = fork_join_flag << 1U;
+
+  /** A callable forked by `fork_join`, which lives on the stack of the forking thread. */
+  struct Job {
+    void (*fun)(const void*);
+    const void* data;
+
+    std::atomic<bool> done{false};
+    std::exception_ptr exception{};
+  };
+
+  /**
+   * The jobs forked by one thread as a bounded Chase–Lev deque: The owning thread pushes and takes
+   * jobs at the bottom, while the other threads steal the oldest ones, which are the largest ones
+   * in divide-and-conquer algorithms, from the top. The capacity bounds the nesting depth of
+   * `fork_join` calls whose second callable is offered to other threads.
+   */
+  struct JobDeque {
+    static constexpr std::ptrdiff_t capacity = 256;
+
+    alignas(cache_line_bytes) std::atomic<std::ptrdiff_t> top{0};
+    alignas(cache_line_bytes) std::atomic<std::ptrdiff_t> bottom{0};
+    std::array<std::atomic<Job*>, capacity> slots{};
+
+    std::atomic<Job*>& slot(std::ptrdiff_t index) {
+      return slots[std::size_t(index % capacity)];
+    }
+  };
+
+  /** The pool and thread index of the calling thread, which is set while it runs a task. */
+  struct CurrentThread {
+    const FixedThreadPool* pool;
+    std::size_t index;
+  };
+  static inline thread_local CurrentThread current_thread_{nullptr, 0};
+
+  /** Makes the calling thread thread 0 of `pool` for the lifetime of the object. */
+  struct OwnerScope {
+    explicit OwnerScope(const FixedThreadPool* pool)
+        : outer{std::exchange(current_thread_, CurrentThread{pool, 0})} {}
+    OwnerScope(const OwnerScope&) = delete;
+    OwnerScope(OwnerScope&&) = delete;
+    OwnerScope& operator=(const OwnerScope&) = delete;
+    OwnerScope& operator=(OwnerScope&&) = delete;
+    ~OwnerScope() {
+      current_thread_ = outer;
     }
 
+    CurrentThread outer;
+  };
+
+  /**
+   * The number of threads to create, i.e. all but the calling one, validating `size` on the way.
+   */
+  static std::size_t worker_num(std::size_t size) {
+    if (size > max_thread_num) {
+      throw std::invalid_argument{
+        cat(size, " threads have been requested, but at most ", max_thread_num, " are supported!")};
+    }
+    return (size > 0) ? size - 1 : 0;
+  }
+
+  /**
+   * Publish `task` to the workers, which run the indices `[0, used)` after the calling thread, or
+   * all of them if `detached` is set.
+   */
+  template<typename Task>
+  void dispatch(const Task& task, std::size_t used, bool detached, bool fork_join = false) const {
     task_fun_ = [](const void* data, std::size_t index) {
       std::invoke(*static_cast<const Task*>(data), index);
     };
     task_data_ = std::addressof(task);
-    unfinished_.store(used - 1, std::memory_order_relaxed);
+    profiler_.begin_region(used);
+    ++regions_;
+    if (adaptive_) {
+      adapt_spin_count();
+    }
+    // With a combining tree, the counter only tells whether the region has completed.
+    const std::size_t unfinished = (completion_ == CompletionStrategy::tree) ? 1
+                                   : detached                             ? used
+                                                                          : used - 1;
+    unfinished_.store(unfinished, std::memory_order_relaxed);
+    active_.store(used, std::memory_order_relaxed);
 
     // The workers make their participation decision from this single load, so that those which are
     // not needed never touch the task, which the next region is free to overwrite.
     const std::size_t state = state_.load(std::memory_order_relaxed) + epoch_step;
-    state_.store((state & ~used_mask) | used, std::memory_order_release);
+    const std::size_t flags =
+      used | (detached ? detached_flag : 0) | (fork_join ? fork_join_flag : 0);
+    state_.store((state & ~(epoch_step - 1)) | flags, std::memory_order_release);
     state_.notify_all();
+  }
+
+  /** The implementation of `execute` and `execute_fork_join`. */
+  template<typename Task>
+  void execute_region(const Task& task, std::optional<std::size_t> used_thread_num,
+                      bool fork_join) const {
+    const std::size_t used = used_thread_num.value_or(thread_num_);
+    assert(used <= thread_num_);
+    assert(std::this_thread::get_id() == owner_);
+    assert(!pending_);
+
+    if (used == 0) {
+      return;
+    }
+    participants_ = used;
+    const OwnerScope scope{this};
+    if (used == 1) {
+      std::invoke(task, std::size_t{0});
+      return;
+    }
 
+    dispatch(task, used, false, fork_join);
     run(0);
+    if (fork_join) {
+      finish_fork_join_index(0);
+    }
+    // Only the combining tree has to know about the calling thread, as its leaf is part of it.
+    if (completion_ == CompletionStrategy::tree) {
+      report_completion(0);
+    }
     await_completion();
+    profiler_.end_region();
+    if (adaptive_) {
+      region_end_ = std::chrono::steady_clock::now();
+    }
 
     if (exception_stored_.exchange(false, std::memory_order_acquire)) {
       std::rethrow_exception(std::exchange(exception_, {}));
     }
   }
 
-private:
-  // The dispatch state packs the number of participating threads into the low bits and a counter
-  // of the regions dispatched so far into the high bits.
-  static constexpr std::size_t used_mask = max_thread_num;
-  static constexpr std::size_t epoch_step = max_thread_num + 1;
-  // Keeping the two hot atomics on separate cache lines prevents the completion counter, which
-  // every worker modifies, from invalidating the line the workers spin on.
-  static constexpr std::size_t cache_line_bytes = 128;
-
-  /**
-   * The number of threads to create, i.e. all but the calling one, validating `size` on the way.
-   */
-  static std::size_t worker_num(std::size_t size) {
-    if (size > max_thread_num) {
-      throw std::invalid_argument{
-        cat(size, " threads have been requested, but at most ", max_thread_num, " are supported!")};
+  /** Wait for the pending submitted region and return the first exception it produced, if any. */
+  std::exception_ptr finish_submission() const {
+    await_completion();
+    profiler_.end_region();
+    if (adaptive_) {
+      region_end_ = std::chrono::steady_clock::now();
     }
-    return (size > 0) ? size - 1 : 0;
+    pending_ = false;
+    if (exception_stored_.exchange(false, std::memory_order_acquire)) {
+      return std::exchange(exception_, {});
+    }
+    return {};
   }
 
   /** The loop run by every thread but the calling one. */
   void work(std::size_t index) const {
+    current_thread_ = CurrentThread{this, index};
     std::size_t last_state = 0;
     while (true) {
       last_state = await_state(last_state);
       if (stop_.load(std::memory_order_relaxed)) {
         break;
       }
-      if (index < (last_state & used_mask)) {
-        run(index);
-        if (unfinished_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-          unfinished_.notify_one();
+      // In a detached region, the worker with thread index 1 runs index 0 and so on.
+      const std::size_t shift = ((last_state & detached_flag) != 0) ? 1 : 0;
+      if (index < (last_state & used_mask) + shift) {
+        run(index - shift);
+        // Reporting completion only afterwards keeps the thread from helping in the next region.
+        if ((last_state & fork_join_flag) != 0) {
+          finish_fork_join_index(index);
         }
+        report_completion(index - shift);
       }
     }
   }
 
+  /**
+   * Update the number of iterations the workers spin for from the gap between the end of the last
+   * region and now, which the workers have just spent waiting.
+   */
+  void adapt_spin_count() const {
+    using Nanos = std::chrono::duration<double, std::nano>;
+    const double gap = Nanos(std::chrono::steady_clock::now() - region_end_).count();
+    // An exponential moving average, which follows a change of phase within a few regions.
+    mean_gap_nanos_ += (gap - mean_gap_nanos_) / 4.0;
+
+    worker_spin_count_.store(spin_count_for_gap(Nanos(mean_gap_nanos_)), std::memory_order_relaxed);
+  }
+
   /** Wait for a dispatch state other than `last`, spinning before parking. */
   std::size_t await_state(std::size_t last) const {
-    for (std::size_t i = spin_count_; i > 0; --i) {
+    for (std::size_t i = worker_spin_count(); i > 0; --i) {
       const std::size_t state = state_.load(std::memory_order_acquire);
       if (state != last) {
         return state;
@@ -212,6 +600,7 @@ private:
       spin_pause();
     }
     while (true) {
+      worker_parks_.fetch_add(1, std::memory_order_relaxed);
       state_.wait(last, std::memory_order_acquire);
       const std::size_t state = state_.load(std::memory_order_acquire);
       if (state != last) {
@@ -220,6 +609,19 @@ private:
     }
   }
 
+  /** Report that the task index `index` of the current region is done. */
+  void report_completion(std::size_t index) const {
+    if (completion_ == CompletionStrategy::tree) {
+      if (!completion_tree_.arrive(index, participants_)) {
+        return;
+      }
+      unfinished_.store(0, std::memory_order_release);
+    } else if (unfinished_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+      return;
+    }
+    unfinished_.notify_one();
+  }
+
   /** Wait for all participating workers to report completion, spinning before parking. */
   void await_completion() const {
     for (std::size_t i = spin_count_; i > 0; --i) {
@@ -233,12 +635,142 @@ private:
       if (left == 0) {
         return;
       }
+      ++owner_parks_;
       unfinished_.wait(left, std::memory_order_acquire);
     }
   }
 
+  /**
+   * Called by each participant of a fork-join region once its index is done, which helps with the
+   * forked jobs until all participants are done and no job can be forked any more.
+   */
+  void finish_fork_join_index(std::size_t thread_index) const {
+    if (active_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      wake_helpers();
+    }
+    help(thread_index, [this] { return active_.load(std::memory_order_acquire) == 0; });
+  }
+
+  /**
+   * Run jobs stolen from the other threads until `done` returns true, spinning before parking
+   * while there are none. The own deque of the thread with index `thread_index` is empty here.
+   */
+  void help(std::size_t thread_index, const auto& done) const {
+    std::size_t spins = 0;
+    while (!done()) {
+      if (Job* job = steal_job(thread_index)) {
+        run_job(*job);
+        wake_helpers();
+        spins = 0;
+        continue;
+      }
+      if (spins < spin_count_) {
+        ++spins;
+        spin_pause();
+        continue;
+      }
+
+      // Registering as a sleeper before checking again pairs with the fence in `wake_helpers`:
+      // Either the check sees the new job or state, or the waking thread sees the sleeper.
+      sleepers_.fetch_add(1, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      const std::size_t signal = job_signal_.load(std::memory_order_acquire);
+      if (!done() && !has_stealable_job(thread_index)) {
+        job_signal_.wait(signal, std::memory_order_acquire);
+      }
+      sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+
+  /** Wake the parked helpers, if there are any, after forking a job or changing their condition. */
+  void wake_helpers() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_relaxed) != 0) {
+      job_signal_.fetch_add(1, std::memory_order_release);
+      job_signal_.notify_all();
+    }
+  }
+
+  /** Push `job` to the bottom of the calling thread’s own `deque`, unless it is full. */
+  static bool push_job(JobDeque& deque, Job& job) {
+    const std::ptrdiff_t bottom = deque.bottom.load(std::memory_order_relaxed);
+    const std::ptrdiff_t top = deque.top.load(std::memory_order_acquire);
+    if (bottom - top >= JobDeque::capacity) {
+      return false;
+    }
+    deque.slot(bottom).store(&job, std::memory_order_relaxed);
+    deque.bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+  }
+  /** Take the job at the bottom of the calling thread’s own `deque`, if it has not been stolen. */
+  static Job* take_job(JobDeque& deque) {
+    const std::ptrdiff_t bottom = deque.bottom.load(std::memory_order_relaxed) - 1;
+    deque.bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::ptrdiff_t top = deque.top.load(std::memory_order_relaxed);
+
+    Job* job = nullptr;
+    if (top <= bottom) {
+      job = deque.slot(bottom).load(std::memory_order_relaxed);
+      if (top != bottom) {
+        return job;
+      }
+      // The last job, which a thief may be taking at the same time.
+      if (!deque.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                             std::memory_order_relaxed)) {
+        job = nullptr;
+      }
+    }
+    deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+    return job;
+  }
+  /** Steal the top job of `deque`, returning `nullptr` if it is empty or the race is lost. */
+  static Job* steal_from(JobDeque& deque) {
+    std::ptrdiff_t top = deque.top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const std::ptrdiff_t bottom = deque.bottom.load(std::memory_order_acquire);
+    if (top >= bottom) {
+      return nullptr;
+    }
+    Job* job = deque.slot(top).load(std::memory_order_relaxed);
+    if (!deque.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return job;
+  }
+  /** Steal a job from the first non-empty deque of another thread, starting after `own`. */
+  Job* steal_job(std::size_t own) const {
+    for (std::size_t offset = 1; offset < thread_num_; ++offset) {
+      if (Job* job = steal_from(deques_[(own + offset) % thread_num_])) {
+        return job;
+      }
+    }
+    return nullptr;
+  }
+  [[nodiscard]] bool has_stealable_job(std::size_t own) const {
+    for (std::size_t offset = 1; offset < thread_num_; ++offset) {
+      const JobDeque& deque = deques_[(own + offset) % thread_num_];
+      if (deque.top.load(std::memory_order_relaxed) <
+          deque.bottom.load(std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  static void run_job(Job& job) {
+    try {
+      job.fun(job.data);
+    } catch (...) {
+      job.exception = std::current_exception();
+    }
+    // The forking thread may destroy the job as soon as this store is visible.
+    job.done.store(true, std::memory_order_release);
+  }
+
   /** Run the current task, storing the exception it throws if it is the first one. */
   void run(std::size_t index) const {
+    profiler_.begin_task(index);
     try {
       task_fun_(task_data_, index);
     } catch (...) {
@@ -246,22 +778,53 @@ private:
         exception_ = std::current_exception();
       }
     }
+    profiler_.end_task(index);
   }
 
   std::size_t thread_num_;
   std::size_t spin_count_;
+  bool adaptive_;
+  CompletionStrategy completion_;
   std::thread::id owner_{std::this_thread::get_id()};
+  // Only accessed by the owner.
+  mutable bool pending_{false};
+  mutable std::size_t regions_{0};
+  mutable std::size_t owner_parks_{0};
+  mutable std::chrono::steady_clock::time_point region_end_{std::chrono::steady_clock::now()};
+  mutable double mean_gap_nanos_{0.0};
+  // The number of indices of the current region, written by the owner like the task.
+  mutable std::size_t participants_{0};
+
+  mutable CombiningTree completion_tree_;
+  mutable CombiningTree barrier_tree_;
+  [[no_unique_address]] mutable std::conditional_t<THES_PROFILE_EXECUTION, RegionProfiler,
+                                                   NullRegionProfiler> profiler_;
+  alignas(cache_line_bytes) mutable std::atomic<std::size_t> barrier_epoch_{0};
 
   // Written by the calling thread before the release store to `state_` and read by the workers
   // that the store makes participants, which the calling thread waits for before writing again.
+  // Keeping the two hot atomics on separate cache lines prevents the completion counter, which
+  // every worker modifies, from invalidating the line the workers spin on.
   alignas(cache_line_bytes) mutable std::atomic<std::size_t> state_{0};
   mutable std::atomic<bool> stop_{false};
   mutable void (*task_fun_)(const void*, std::size_t){nullptr};
   mutable const void* task_data_{nullptr};
+  // Written by the calling thread along with the dispatch state, so it shares its cache line.
+  mutable std::atomic<std::size_t> worker_spin_count_{default_spin_count};
 
   alignas(cache_line_bytes) mutable std::atomic<std::size_t> unfinished_{0};
 
-  mutable std::atomic<bool> exception_stored_{false};
+  // Only used by fork-join regions and `fork_join`.
+  alignas(cache_line_bytes) mutable std::atomic<std::size_t> active_{0};
+  // Only modified around parking, and to wake parked helpers.
+  alignas(cache_line_bytes) mutable std::atomic<std::size_t> sleepers_{0};
+  mutable std::atomic<std::size_t> job_signal_{0};
+  mutable FixedArray<JobDeque> deques_;
+
+  // Only modified by parked workers, which are in no hurry.
+  alignas(cache_line_bytes) mutable std::atomic<std::size_t> worker_parks_{0};
+
+  alignas(cache_line_bytes) mutable std::atomic<bool> exception_stored_{false};
   mutable std::exception_ptr exception_{};
 
   Threads threads_;
@@ -0,0 +1,200 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_EXECUTION_EXECUTOR_HIERARCHICAL_THREAD_POOL_HPP
+#define INCLUDE_THESAUROS_EXECUTION_EXECUTOR_HIERARCHICAL_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "thesauros/charconv/concat.hpp"
+#include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/execution/executor/fixed-thread-pool.hpp"
+#include "thesauros/execution/system/affinity.hpp"
+#include "thesauros/math/integer-cast.hpp"
+#include "thesauros/ranges/index-type.hpp"
+#include "thesauros/ranges/indices.hpp"
+#include "thesauros/types/empty.hpp"
+
+namespace thes {
+/**
+ * A thread pool whose threads are split into groups, typically one per NUMA node, with a
+ * two-level dispatch: the calling thread wakes one leader thread per group, and each leader wakes
+ * the other threads of its group.
+ *
+ * With a flat `FixedThreadPool`, every thread spins on and reports to the same cache lines, so
+ * each region moves O(threads) cache lines across sockets. Here, only the leaders touch the
+ * top-level cache lines, while the other threads only touch those of their group, which reduces
+ * the cross-socket traffic to O(groups).
+ *
+ * Each group is a `FixedThreadPool` led by the thread that runs the group’s index in the top-level
+ * `FixedThreadPool`, and its state is allocated by the leader as well, so that it is placed on the
+ * leader’s node by the first-touch policy. The thread indices are numbered consecutively within
+ * the groups, i.e. the indices of group `g` start at the sum of the sizes of the groups before it.
+ *
+ * As with `FixedThreadPool`, `execute` must only be called from the thread that created the pool.
+ */
+struct HierarchicalThreadPool {
+  /**
+   * Create a pool with groups of the given sizes, where the calling thread is the leader of the
+   * first group.
+   * @param cpu_sets The CPU sets to pin the threads to, indexed by thread index, or `Empty` to
+   *                 leave the affinities alone.
+   */
+  template<typename GroupSizes, typename CpuSets = Empty>
+  explicit HierarchicalThreadPool(const GroupSizes& group_sizes, const CpuSets& cpu_sets = {},
+                                  std::size_t spin_count = FixedThreadPool::default_spin_count)
+      : offsets_{group_offsets(group_sizes)}, group_num_{offsets_.size() - 1},
+        top_{group_num_, leader_cpu_sets(cpu_sets), spin_count}, groups_(group_num_) {
+    top_.execute([&](std::size_t group) {
+      const std::size_t offset = offsets_[group];
+      const std::size_t size = offsets_[group + 1] - offset;
+      if constexpr (std::same_as<CpuSets, Empty>) {
+        groups_[group] = std::make_unique<FixedThreadPool>(size, Empty{}, spin_count);
+      } else {
+        groups_[group] = std::make_unique<FixedThreadPool>(
+          size, cpu_sets | std::views::drop(offset) | std::views::take(size), spin_count);
+      }
+    });
+  }
+
+  /**
+   * Create a pool pinning each thread to one of the CPUs described by `cpu_infos`, with one group
+   * per NUMA node among them.
+   */
+  template<typename CpuInfos>
+  static HierarchicalThreadPool
+  from_cpu_infos(CpuInfos&& cpu_infos,
+                 std::size_t spin_count = FixedThreadPool::default_spin_count) {
+    using CpuInfo = std::ranges::range_value_t<CpuInfos>;
+
+    // Querying the node may involve the file system, so it happens once per CPU.
+    auto nodes = std::ranges::to<std::vector<std::pair<std::size_t, CpuInfo>>>(
+      std::forward<CpuInfos>(cpu_infos) | std::views::transform([](const CpuInfo& cpu) {
+        return std::make_pair(cpu.numa_node(), cpu);
+      }));
+    std::ranges::stable_sort(nodes, {}, [](const auto& pair) { return pair.first; });
+
+    std::vector<std::size_t> group_sizes{};
+    for (std::size_t i = 0; i < nodes.size();) {
+      std::size_t j = i + 1;
+      while (j < nodes.size() && nodes[j].first == nodes[i].first) {
+        ++j;
+      }
+      group_sizes.push_back(j - i);
+      i = j;
+    }
+
+    return HierarchicalThreadPool{
+      group_sizes,
+      std::views::transform(nodes,
+                            [](const auto& pair) { return CpuSet::single_set(pair.second.id); }),
+      spin_count};
+  }
+
+  HierarchicalThreadPool(const HierarchicalThreadPool&) = delete;
+  HierarchicalThreadPool(HierarchicalThreadPool&&) = delete;
+  HierarchicalThreadPool& operator=(const HierarchicalThreadPool&) = delete;
+  HierarchicalThreadPool& operator=(HierarchicalThreadPool&&) = delete;
+  ~HierarchicalThreadPool() = default;
+
+  [[nodiscard]] std::size_t thread_num() const noexcept {
+    return offsets_[group_num_];
+  }
+
+  [[nodiscard]] std::size_t group_num() const noexcept {
+    return group_num_;
+  }
+
+  /** The number of threads in the given group. */
+  [[nodiscard]] std::size_t group_thread_num(std::size_t group) const noexcept {
+    return offsets_[group + 1] - offsets_[group];
+  }
+
+  /**
+   * Run `task` on the thread indices `[0, used_thread_num)`, blocking until all of them are done,
+   * and rethrow the first exception any of them produced.
+   *
+   * Only the groups containing one of these indices are woken up.
+   */
+  template<typename Task>
+  requires(std::invocable<const Task&, std::size_t>)
+  void execute(const Task& task, std::optional<std::size_t> used_thread_num = {}) const {
+    const std::size_t used = used_thread_num.value_or(thread_num());
+    assert(used <= thread_num());
+
+    // The groups containing one of the indices are those starting before `used`.
+    const auto used_groups =
+      std::size_t(std::ranges::lower_bound(offsets_, used) - offsets_.begin());
+
+    top_.execute(
+      [&](std::size_t group) {
+        const std::size_t offset = offsets_[group];
+        const std::size_t group_used = std::min(used, offsets_[group + 1]) - offset;
+        groups_[group]->execute([&](std::size_t index) { std::invoke(task, offset + index); },
+                                group_used);
+      },
+      used_groups);
+  }
+
+private:
+  /** The first thread index of each group, followed by the total number of threads. */
+  template<typename GroupSizes>
+  static FixedArray<std::size_t> group_offsets(const GroupSizes& group_sizes) {
+    const auto size = std::ranges::distance(group_sizes);
+    FixedArray<std::size_t> offsets(*safe_cast<std::size_t>(size) + 1);
+    std::size_t offset = 0;
+    for (std::size_t i = 0; const auto group_size : group_sizes) {
+      if (group_size == 0) {
+        throw std::invalid_argument{cat("Group ", i, " is empty!")};
+      }
+      offsets[i++] = offset;
+      offset += std::size_t(group_size);
+    }
+    offsets[offsets.size() - 1] = offset;
+    return offsets;
+  }
+
+  /**
+   * The CPU sets of the first thread of each group, which leads the group, validating the number
+   * of CPU sets on the way.
+   */
+  template<typename CpuSets>
+  auto leader_cpu_sets(const CpuSets& cpu_sets) const {
+    if constexpr (std::same_as<CpuSets, Empty>) {
+      return Empty{};
+    } else {
+      if (thread_num() > cpu_sets.size()) {
+        throw std::invalid_argument{cat(thread_num(),
+                                        " threads have been requested, but there are only ",
+                                        cpu_sets.size(), " entries in the CPU set!")};
+      }
+      using Index = ranges::RangeIndex<CpuSets>;
+      return std::views::transform(views::indices(group_num_),
+                                   [this, &cpu_sets](std::size_t group) -> decltype(auto) {
+                                     return cpu_sets[*safe_cast<Index>(offsets_[group])];
+                                   });
+    }
+  }
+
+  FixedArray<std::size_t> offsets_;
+  std::size_t group_num_;
+  FixedThreadPool top_;
+  // Each group is allocated by its leader, see the constructor.
+  FixedArray<std::unique_ptr<FixedThreadPool>> groups_;
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_EXECUTION_EXECUTOR_HIERARCHICAL_THREAD_POOL_HPP
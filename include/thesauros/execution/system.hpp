@@ -3,6 +3,8 @@
 
 // IWYU pragma: begin_exports
 #include "system/affinity.hpp"
+#include "system/combining-tree.hpp"
+#include "system/region-profiler.hpp"
 #include "system/scheduler.hpp"
 #include "system/spin.hpp"
 // IWYU pragma: end_exports
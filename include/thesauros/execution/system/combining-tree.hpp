@@ -0,0 +1,92 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_EXECUTION_SYSTEM_COMBINING_TREE_HPP
+#define INCLUDE_THESAUROS_EXECUTION_SYSTEM_COMBINING_TREE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+#include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/memory/cache-line.hpp"
+
+namespace thes {
+/**
+ * A combining tree which determines the last of a number of participants to arrive, as used for
+ * barriers whose participants would contend on a single counter otherwise.
+ *
+ * The participants are the leaves of a tree with `arity` children per node, each of which counts
+ * the arrivals of its children on a cache line of its own. The last child to arrive at a node
+ * resets the counter and arrives at the parent in turn, so that each counter sees at most `arity`
+ * threads per round. The last participant overall is the one which arrives at the root last.
+ *
+ * The number of participants can change from round to round, as long as it does not exceed the
+ * number of leaves and a round only starts once the previous one has completed, i.e. once the
+ * last participant has returned from `arrive` and this has become visible to the others.
+ */
+struct CombiningTree {
+  static constexpr std::size_t arity = 4;
+
+  explicit CombiningTree(std::size_t leaf_num)
+      : level_offsets_(level_num(leaf_num) + 1), counters_(node_num(leaf_num)) {
+    std::size_t offset = 0;
+    std::size_t nodes = leaf_num;
+    for (std::size_t level = 0; level + 1 < level_offsets_.size(); ++level) {
+      level_offsets_[level] = offset;
+      nodes = div_ceil(nodes, arity);
+      offset += nodes;
+    }
+    level_offsets_[level_offsets_.size() - 1] = offset;
+  }
+
+  /**
+   * Register the arrival of the participant `position` of `[0, participants)` and return whether
+   * it was the last one, which completes the round.
+   */
+  bool arrive(std::size_t position, std::size_t participants) {
+    std::size_t unit = position;
+    std::size_t unit_num = participants;
+    for (std::size_t level = 0; unit_num > 1; ++level) {
+      const std::size_t node = unit / arity;
+      const std::size_t children = std::min(arity, unit_num - node * arity);
+      std::atomic<std::size_t>& counter = counters_[level_offsets_[level] + node].value;
+      if (counter.fetch_add(1, std::memory_order_acq_rel) + 1 != children) {
+        return false;
+      }
+      // All children have arrived, so nobody touches the counter before the next round.
+      counter.store(0, std::memory_order_relaxed);
+      unit = node;
+      unit_num = div_ceil(unit_num, arity);
+    }
+    return true;
+  }
+
+private:
+  static std::size_t level_num(std::size_t leaf_num) {
+    std::size_t levels = 0;
+    for (std::size_t nodes = leaf_num; nodes > 1; nodes = div_ceil(nodes, arity)) {
+      ++levels;
+    }
+    return levels;
+  }
+  static std::size_t node_num(std::size_t leaf_num) {
+    std::size_t total = 0;
+    for (std::size_t nodes = leaf_num; nodes > 1;) {
+      nodes = div_ceil(nodes, arity);
+      total += nodes;
+    }
+    return total;
+  }
+
+  // The index of the first node of each level in `counters_`, followed by the number of nodes.
+  FixedArray<std::size_t> level_offsets_;
+  FixedArray<CacheAligned<std::atomic<std::size_t>>> counters_;
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_EXECUTION_SYSTEM_COMBINING_TREE_HPP
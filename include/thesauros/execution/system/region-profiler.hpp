@@ -0,0 +1,152 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_EXECUTION_SYSTEM_REGION_PROFILER_HPP
+#define INCLUDE_THESAUROS_EXECUTION_SYSTEM_REGION_PROFILER_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <ratio>
+#include <utility>
+#include <vector>
+
+#include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/memory/cache-line.hpp"
+
+// Whether the executors record a `RegionProfile` per parallel region, which costs two clock reads
+// per thread and region. This changes the layout of the executors and therefore has to be the
+// same in all translation units.
+#ifndef THES_PROFILE_EXECUTION
+#define THES_PROFILE_EXECUTION false
+#endif
+
+namespace thes {
+/** The timings of a single parallel region in nanoseconds, as recorded by a `RegionProfiler`. */
+struct RegionProfile {
+  /** The time from the start of the dispatch until the last thread index has started. */
+  double dispatch_latency;
+  /** The time each thread index has spent running its task. */
+  std::vector<double> busy_times;
+  /** The time each thread index has spent waiting for the other ones after finishing its task. */
+  std::vector<double> wait_times;
+  /** The longest busy time divided by the mean one, which is 1 for perfectly balanced work. */
+  double imbalance;
+};
+
+/** The timings of a sequence of regions, accumulated over all of them. */
+struct RegionProfileSummary {
+  std::size_t regions;
+  double mean_dispatch_latency;
+  /** The total busy time of each thread index. */
+  std::vector<double> busy_times;
+  /** The total waiting time of each thread index. */
+  std::vector<double> wait_times;
+  double mean_imbalance;
+};
+
+/**
+ * Records a `RegionProfile` for each parallel region of an executor.
+ *
+ * The dispatching thread calls `begin_region` and `end_region`, while each thread index calls
+ * `begin_task` and `end_task`, which only write to a cache line of their own.
+ */
+struct RegionProfiler {
+  using Clock = std::chrono::steady_clock;
+
+  explicit RegionProfiler(std::size_t thread_num) : slots_(thread_num) {}
+
+  void begin_region(std::size_t used) {
+    used_ = used;
+    start_ = Clock::now();
+  }
+  void begin_task(std::size_t index) {
+    slots_[index].value.begin = Clock::now();
+  }
+  void end_task(std::size_t index) {
+    slots_[index].value.end = Clock::now();
+  }
+  void end_region() {
+    const Clock::time_point end = Clock::now();
+    RegionProfile profile{.dispatch_latency = 0.0, .busy_times = {}, .wait_times = {},
+                          .imbalance = 1.0};
+    profile.busy_times.reserve(used_);
+    profile.wait_times.reserve(used_);
+
+    double busy_sum = 0.0;
+    double busy_max = 0.0;
+    for (std::size_t i = 0; i < used_; ++i) {
+      const Slot& slot = slots_[i].value;
+      profile.dispatch_latency = std::max(profile.dispatch_latency, nanos(slot.begin - start_));
+      const double busy = nanos(slot.end - slot.begin);
+      profile.busy_times.push_back(busy);
+      profile.wait_times.push_back(nanos(end - slot.end));
+      busy_sum += busy;
+      busy_max = std::max(busy_max, busy);
+    }
+    if (busy_sum > 0.0) {
+      profile.imbalance = busy_max * double(used_) / busy_sum;
+    }
+    profiles_.push_back(std::move(profile));
+  }
+
+  [[nodiscard]] const std::vector<RegionProfile>& profiles() const {
+    return profiles_;
+  }
+  void clear() {
+    profiles_.clear();
+  }
+
+  /** Accumulate the profiles recorded so far. */
+  [[nodiscard]] RegionProfileSummary summary() const {
+    RegionProfileSummary summary{.regions = profiles_.size(), .mean_dispatch_latency = 0.0,
+                                 .busy_times = std::vector<double>(slots_.size(), 0.0),
+                                 .wait_times = std::vector<double>(slots_.size(), 0.0),
+                                 .mean_imbalance = 0.0};
+    if (profiles_.empty()) {
+      return summary;
+    }
+    for (const RegionProfile& profile : profiles_) {
+      summary.mean_dispatch_latency += profile.dispatch_latency;
+      summary.mean_imbalance += profile.imbalance;
+      for (std::size_t i = 0; i < profile.busy_times.size(); ++i) {
+        summary.busy_times[i] += profile.busy_times[i];
+        summary.wait_times[i] += profile.wait_times[i];
+      }
+    }
+    summary.mean_dispatch_latency /= double(profiles_.size());
+    summary.mean_imbalance /= double(profiles_.size());
+    return summary;
+  }
+
+private:
+  struct Slot {
+    Clock::time_point begin{};
+    Clock::time_point end{};
+  };
+
+  static double nanos(Clock::duration duration) {
+    return std::chrono::duration<double, std::nano>(duration).count();
+  }
+
+  FixedArray<CacheAligned<Slot>> slots_;
+  std::size_t used_{0};
+  Clock::time_point start_{};
+  std::vector<RegionProfile> profiles_{};
+};
+
+/** A stand-in for `RegionProfiler` which records nothing, used unless profiling is enabled. */
+struct NullRegionProfiler {
+  explicit NullRegionProfiler(std::size_t /*thread_num*/) {}
+
+  void begin_region(std::size_t /*used*/) {}
+  void begin_task(std::size_t /*index*/) {}
+  void end_task(std::size_t /*index*/) {}
+  void end_region() {}
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_EXECUTION_SYSTEM_REGION_PROFILER_HPP
@@ -7,6 +7,10 @@
 #ifndef INCLUDE_THESAUROS_EXECUTION_SYSTEM_SPIN_HPP
 #define INCLUDE_THESAUROS_EXECUTION_SYSTEM_SPIN_HPP
 
+#include <chrono>
+#include <cstddef>
+#include <ratio>
+
 #include "thesauros/macropolis/inlining.hpp"
 #include "thesauros/macropolis/platform.hpp"
 
@@ -33,6 +37,23 @@ THES_ALWAYS_INLINE inline void spin_pause() {
   std::this_thread::yield();
 #endif
 }
+
+/**
+ * The duration of a single `spin_pause` in nanoseconds, which varies by more than an order of
+ * magnitude between microarchitectures and is therefore measured once per process.
+ */
+inline double spin_pause_nanos() {
+  static const double nanos = [] {
+    constexpr std::size_t pauses = 4096;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < pauses; ++i) {
+      spin_pause();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / double(pauses);
+  }();
+  return nanos;
+}
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_EXECUTION_SYSTEM_SPIN_HPP
@@ -23,6 +23,13 @@ struct Minimum {
     return std::min(std::forward<T1>(v1), std::forward<T2>(v2));
   }
 };
+/** The bitwise AND of the first operand with the complement of the second. */
+struct BitAndNot {
+  template<typename T1, typename T2>
+  constexpr auto operator()(const T1& v1, const T2& v2) const {
+    return v1 & ~v2;
+  }
+};
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_FUNCTIONAL_BINARY_HPP
@@ -2,11 +2,15 @@
 #define INCLUDE_THESAUROS_IO_HPP
 
 // IWYU pragma: begin_exports
+#include "io/async-file-reader.hpp"
+#include "io/container-file.hpp"
 #include "io/delimiter.hpp"
 #include "io/file-reader.hpp"
 #include "io/file-writer.hpp"
 #include "io/file.hpp"
 #include "io/json.hpp"
+#include "io/mapped-file.hpp"
+#include "io/region-profile.hpp"
 #include "io/serialization.hpp"
 // IWYU pragma: end_exports
 
@@ -0,0 +1,375 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_IO_ASYNC_FILE_READER_HPP
+#define INCLUDE_THESAUROS_IO_ASYNC_FILE_READER_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "thesauros/charconv/concat.hpp"
+#include "thesauros/containers/dynamic-buffer.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/macropolis/platform.hpp"
+#include "thesauros/types/primitives.hpp"
+
+#if THES_LINUX
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif THES_APPLE
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include "thesauros/io/file-reader.hpp"
+#include "thesauros/math/integer-cast.hpp"
+#endif
+
+namespace thes {
+#if THES_LINUX
+namespace detail::uring {
+/** A minimal io_uring instance using the system calls directly, to avoid depending on liburing. */
+struct Ring {
+  /** The size up to which reads are submitted in one piece, as the length has 32 bits. */
+  static constexpr std::size_t max_read_size = std::size_t{1} << 30U;
+
+  explicit Ring(unsigned entries) {
+    io_uring_params params{};
+    fd_ = int(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd_ < 0) {
+      // io_uring is unavailable, e.g. disabled by the kernel or a seccomp filter.
+      fd_ = -1;
+      return;
+    }
+
+    sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_map = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_map) {
+      sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+    }
+    sq_map_ = map(sq_size_, IORING_OFF_SQ_RING);
+    cq_map_ = single_map ? sq_map_ : map(cq_size_, IORING_OFF_CQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+    if (sq_map_ == nullptr || cq_map_ == nullptr || sqes_ == nullptr || !supports_read()) {
+      release();
+      return;
+    }
+
+    entries_ = params.sq_entries;
+    sq_tail_ = at<unsigned>(sq_map_, params.sq_off.tail);
+    sq_mask_ = *at<unsigned>(sq_map_, params.sq_off.ring_mask);
+    sq_array_ = at<unsigned>(sq_map_, params.sq_off.array);
+    cq_head_ = at<unsigned>(cq_map_, params.cq_off.head);
+    cq_tail_ = at<unsigned>(cq_map_, params.cq_off.tail);
+    cq_mask_ = *at<unsigned>(cq_map_, params.cq_off.ring_mask);
+    cqes_ = at<io_uring_cqe>(cq_map_, params.cq_off.cqes);
+  }
+  Ring(const Ring&) = delete;
+  Ring(Ring&&) = delete;
+  Ring& operator=(const Ring&) = delete;
+  Ring& operator=(Ring&&) = delete;
+  ~Ring() {
+    release();
+  }
+
+  [[nodiscard]] bool valid() const {
+    return fd_ != -1;
+  }
+  [[nodiscard]] unsigned entries() const {
+    return entries_;
+  }
+
+  /** Queues a read, which requires a free entry in the submission queue. */
+  void push_read(int fd, std::byte* dst, std::size_t size, std::size_t offset, u64 user_data) {
+    const unsigned tail = *sq_tail_;
+    const unsigned index = tail & sq_mask_;
+    io_uring_sqe& sqe = sqes_[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = IORING_OP_READ;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(dst); // NOLINT(*-reinterpret-cast)
+    sqe.len = unsigned(std::min(size, max_read_size));
+    sqe.off = offset;
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    std::atomic_ref{*sq_tail_}.store(tail + 1, std::memory_order_release);
+    ++unsubmitted_;
+  }
+
+  /** Submits all queued entries and waits until at least `min_complete` have completed. */
+  void enter(unsigned min_complete) {
+    const unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0U;
+    while (true) {
+      const auto ret =
+        ::syscall(__NR_io_uring_enter, fd_, unsubmitted_, min_complete, flags, nullptr, 0);
+      if (ret >= 0) {
+        unsubmitted_ -= unsigned(ret);
+        return;
+      }
+      if (errno != EINTR) {
+        throw FileException{cat("io_uring_enter failed: ", errno)};
+      }
+    }
+  }
+
+  /** Calls `op` with the user data and result of each available completion. */
+  void reap(auto op) {
+    unsigned head = *cq_head_;
+    const unsigned tail = std::atomic_ref{*cq_tail_}.load(std::memory_order_acquire);
+    for (; head != tail; ++head) {
+      // Copy the entry before releasing it, as the kernel may reuse it from then on, and release
+      // it before handling it, as the handler may throw.
+      const io_uring_cqe cqe = cqes_[head & cq_mask_];
+      std::atomic_ref{*cq_head_}.store(head + 1, std::memory_order_release);
+      op(cqe.user_data, cqe.res);
+    }
+  }
+
+private:
+  /**
+   * Whether the kernel supports `IORING_OP_READ`, which was added together with the probe in
+   * Linux 5.6, so that older kernels, which only provide vectored reads, fail the probe.
+   */
+  [[nodiscard]] bool supports_read() const {
+    // The probe ends in a flexible array with one entry per operation.
+    static constexpr unsigned op_num = 256;
+    alignas(io_uring_probe) std::array<std::byte, sizeof(io_uring_probe) +
+                                                    op_num * sizeof(io_uring_probe_op)>
+      buffer{};
+    const auto* probe = at<io_uring_probe>(buffer.data(), 0);
+    if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, buffer.data(), op_num) < 0) {
+      return false;
+    }
+    return IORING_OP_READ <= probe->last_op &&
+           (probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED) != 0;
+  }
+
+  void* map(std::size_t size, off_t offset) const {
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_,
+                       offset);
+    return ptr == MAP_FAILED ? nullptr : ptr;
+  }
+  template<typename T>
+  static T* at(void* base, std::size_t offset) {
+    return reinterpret_cast<T*>(static_cast<std::byte*>(base) + offset); // NOLINT
+  }
+
+  void release() {
+    if (sqes_ != nullptr) {
+      ::munmap(sqes_, sqes_size_);
+    }
+    if (cq_map_ != nullptr && cq_map_ != sq_map_) {
+      ::munmap(cq_map_, cq_size_);
+    }
+    if (sq_map_ != nullptr) {
+      ::munmap(sq_map_, sq_size_);
+    }
+    if (fd_ != -1) {
+      ::close(fd_);
+    }
+    sqes_ = nullptr;
+    cq_map_ = sq_map_ = nullptr;
+    fd_ = -1;
+  }
+
+  int fd_{-1};
+  unsigned entries_{0};
+  unsigned unsubmitted_{0};
+
+  void* sq_map_{nullptr};
+  void* cq_map_{nullptr};
+  io_uring_sqe* sqes_{nullptr};
+  std::size_t sq_size_{0};
+  std::size_t cq_size_{0};
+  std::size_t sqes_size_{0};
+
+  unsigned* sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned* sq_array_{nullptr};
+  unsigned* cq_head_{nullptr};
+  unsigned* cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe* cqes_{nullptr};
+};
+} // namespace detail::uring
+#endif
+
+/**
+ * Reads many parts of a file asynchronously into `DynamicBuffer`s, so that a single thread can
+ * keep many reads in flight, e.g. to saturate an NVMe drive while loading many chunks.
+ *
+ * `read` queues a read, which is started at the latest when the submission queue is full or
+ * `submit` or `wait` is called, and `wait` blocks until all queued reads have completed. Like
+ * `FileReader::try_pread`, the buffers are resized to the number of bytes actually read, which is
+ * smaller than the requested size at the end of the file. The buffers must neither be accessed nor
+ * destroyed until `wait` has returned.
+ *
+ * On Linux, this uses io_uring with up to `queue_depth` reads in flight, if the kernel supports
+ * `IORING_OP_READ` (5.6 or newer), which is probed when constructing the reader. Otherwise, and
+ * on other systems, the reads are performed synchronously.
+ */
+struct AsyncFileReader {
+  explicit AsyncFileReader(const std::filesystem::path& path, unsigned queue_depth = 64)
+#if THES_LINUX
+      : ring_(queue_depth)
+#elif !THES_APPLE
+      : reader_(path)
+#endif
+  {
+#if THES_LINUX || THES_APPLE
+    fd_ = ::open(path_string(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ == -1) {
+      throw FileException{cat("open failed: ", errno)};
+    }
+#endif
+#if THES_LINUX
+    if (ring_.valid()) {
+      pending_.resize(ring_.entries());
+      for (unsigned i = 0; i < ring_.entries(); ++i) {
+        free_slots_.push_back(ring_.entries() - 1 - i);
+      }
+    }
+#else
+    (void)queue_depth;
+#endif
+  }
+  AsyncFileReader(const AsyncFileReader&) = delete;
+  AsyncFileReader(AsyncFileReader&&) = delete;
+  AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+  AsyncFileReader& operator=(AsyncFileReader&&) = delete;
+  ~AsyncFileReader() {
+#if THES_LINUX
+    // The kernel may still write into the buffers, so the outstanding reads have to complete.
+    try {
+      wait();
+    } catch (...) { // NOLINT(bugprone-empty-catch)
+    }
+#endif
+#if THES_LINUX || THES_APPLE
+    ::close(fd_);
+#endif
+  }
+
+  /** Whether the reads are performed asynchronously. */
+  [[nodiscard]] bool is_async() const {
+#if THES_LINUX
+    return ring_.valid();
+#else
+    return false;
+#endif
+  }
+
+  /** Queues a read of `size` bytes at `offset` into `buffer`, which is resized to `size`. */
+  void read(DynamicBuffer& buffer, std::size_t size, std::size_t offset) {
+    buffer.resize(size);
+#if THES_LINUX
+    if (ring_.valid()) {
+      if (free_slots_.empty()) {
+        // All entries are in flight, so wait for at least one of them to complete.
+        ring_.enter(1);
+        complete();
+      }
+      const unsigned slot = free_slots_.back();
+      free_slots_.pop_back();
+      pending_[slot] = Pending{.buffer = &buffer, .offset = offset};
+      ring_.push_read(fd_, buffer.data(), size, offset, slot);
+      return;
+    }
+#endif
+#if THES_LINUX || THES_APPLE
+    buffer.resize(pread_all(fd_, buffer.span(), offset));
+#else
+    reader_.try_pread(buffer, size, *safe_cast<long>(offset));
+#endif
+  }
+
+  /** Starts all queued reads without waiting for them. */
+  void submit() {
+#if THES_LINUX
+    if (ring_.valid()) {
+      ring_.enter(0);
+    }
+#endif
+  }
+
+  /** Starts all queued reads and waits until all reads have completed. */
+  void wait() {
+#if THES_LINUX
+    if (!ring_.valid()) {
+      return;
+    }
+    while (free_slots_.size() < pending_.size()) {
+      ring_.enter(1);
+      complete();
+    }
+    if (!error_.empty()) {
+      throw FileException{std::exchange(error_, {})};
+    }
+#endif
+  }
+
+private:
+#if THES_LINUX
+  struct Pending {
+    DynamicBuffer* buffer;
+    std::size_t offset;
+  };
+
+  void complete() {
+    ring_.reap([&](u64 slot, int result) {
+      const Pending pending = pending_[slot];
+      free_slots_.push_back(unsigned(slot));
+      DynamicBuffer& buffer = *pending.buffer;
+      if (result < 0) {
+        buffer.resize(0);
+        error_ = cat("io_uring read failed: ", -result);
+        return;
+      }
+      const auto done = std::size_t(result);
+      if (done == 0 || done == buffer.size()) {
+        buffer.resize(done);
+        return;
+      }
+      // Reads from regular files are only short at the end of the file, but the kernel may still
+      // split a read, and reads beyond `Ring::max_read_size` are split here, so the rest is read
+      // synchronously.
+      try {
+        buffer.resize(done + pread_all(fd_, buffer.span().subspan(done), pending.offset + done));
+      } catch (const FileException& e) {
+        buffer.resize(done);
+        error_ = e.what();
+      }
+    });
+  }
+
+  detail::uring::Ring ring_;
+  std::vector<Pending> pending_{};
+  std::vector<unsigned> free_slots_{};
+  std::string error_{};
+#endif
+#if THES_LINUX || THES_APPLE
+  int fd_{-1};
+#else
+  FileReader reader_;
+#endif
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_IO_ASYNC_FILE_READER_HPP
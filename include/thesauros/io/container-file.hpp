@@ -0,0 +1,326 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_IO_CONTAINER_FILE_HPP
+#define INCLUDE_THESAUROS_IO_CONTAINER_FILE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "thesauros/algorithms/crc32c.hpp"
+#include "thesauros/charconv/concat.hpp"
+#include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/containers/multi-byte-integers.hpp"
+#include "thesauros/containers/nested-dynamic-array.hpp"
+#include "thesauros/io/file-reader.hpp"
+#include "thesauros/io/file-writer.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/io/mapped-file.hpp"
+#include "thesauros/io/serialization.hpp"
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/math/integer-cast.hpp"
+#include "thesauros/types/primitives.hpp"
+#include "thesauros/types/type-name.hpp"
+#include "thesauros/types/type-tag.hpp"
+
+/**
+ * A self-describing binary format for the Thesauros containers, as an alternative to the raw
+ * `to_file`/`from_file` in `serialization.hpp`.
+ *
+ * Each flat array is stored as a section consisting of a `ContainerHeader`, the name of the
+ * element type and the payload, i.e. the raw element bytes, which starts at an offset from the
+ * beginning of the file that is a multiple of `ContainerFileOptions::alignment`. The header
+ * describes the element type, its size and the endianness, so that reading a file written with
+ * different ones throws a `FileException` instead of producing garbage, and optionally contains a
+ * CRC-32C checksum of the payload. The alignment allows the payload to be viewed in a `MappedFile`
+ * without copying. Containers consisting of several arrays are stored as consecutive sections.
+ */
+namespace thes {
+enum struct ContainerChecksum : u8 { none = 0, crc32c = 1 };
+
+struct ContainerFileOptions {
+  ContainerChecksum checksum = ContainerChecksum::crc32c;
+  /** The alignment of the payload relative to the beginning of the file. */
+  std::size_t alignment = 4096;
+};
+
+/** The header of each section of a container file, as it is stored in the file. */
+struct ContainerHeader {
+  static constexpr std::array<char, 8> expected_magic{'T', 'H', 'E', 'S', 'C', 'O', 'N', 'T'};
+  static constexpr u32 current_version = 1;
+  static constexpr u8 native_endianness = std::endian::native == std::endian::little ? 1 : 2;
+
+  std::array<char, 8> magic;
+  u32 version;
+  u8 endianness;
+  ContainerChecksum checksum_kind;
+  std::array<u8, 2> reserved;
+  u64 element_size;
+  u64 element_num;
+  /** The offset of the payload from the beginning of the file. */
+  u64 payload_offset;
+  u64 payload_size;
+  u32 checksum;
+  /** The size of the element type name, which directly follows the header. */
+  u32 type_name_size;
+};
+
+namespace detail::container_file {
+inline void check_header(const ContainerHeader& header, std::string_view type_name,
+                         std::size_t element_size) {
+  if (header.magic != ContainerHeader::expected_magic) {
+    throw FileException{"The file does not contain a Thesauros container!"};
+  }
+  // The endianness is a single byte, which can be read before knowing it, unlike the version.
+  if (header.endianness != ContainerHeader::native_endianness) {
+    throw FileException{"The container file has been written with a different endianness!"};
+  }
+  if (header.version != ContainerHeader::current_version) {
+    throw FileException{cat("The container file version ", header.version,
+                            " is not supported, only ", ContainerHeader::current_version, "!")};
+  }
+  if (header.element_size != element_size) {
+    throw FileException{cat("The container file has elements of size ", header.element_size,
+                            " instead of ", element_size, "!")};
+  }
+  if (header.payload_size % element_size != 0 ||
+      header.payload_size / element_size != header.element_num) {
+    throw FileException{cat("The payload of ", header.payload_size, " bytes does not fit ",
+                            header.element_num, " elements!")};
+  }
+  if (header.type_name_size != type_name.size()) {
+    throw FileException{cat("The container file has an element type name of size ",
+                            header.type_name_size, " instead of ", type_name.size(), "!")};
+  }
+}
+
+inline void check_type_name(std::string_view stored, std::string_view type_name) {
+  if (stored != type_name) {
+    throw FileException{cat("The container file has elements of type ", stored, " instead of ",
+                            type_name, "!")};
+  }
+}
+
+inline void check_payload(const ContainerHeader& header, std::span<const std::byte> payload) {
+  switch (header.checksum_kind) {
+    case ContainerChecksum::none: return;
+    case ContainerChecksum::crc32c: {
+      if (const u32 checksum = crc32c(payload); checksum != header.checksum) {
+        throw FileException{cat("The CRC-32C checksum ", checksum,
+                                " of the payload does not match ", header.checksum, "!")};
+      }
+      return;
+    }
+  }
+  throw FileException{cat("Unknown checksum kind ", int(header.checksum_kind), "!")};
+}
+
+/** Reads a section header and returns it if it describes `size`-byte elements of `type_name`. */
+inline ContainerHeader read_header(FileReader& reader, std::string_view type_name,
+                                   std::size_t element_size) {
+  const auto header = reader.read(type_tag<ContainerHeader>);
+  check_header(header, type_name, element_size);
+  std::string stored(header.type_name_size, '\0');
+  reader.read(std::span{stored.data(), stored.size()});
+  check_type_name(stored, type_name);
+  reader.seek(*safe_cast<long>(header.payload_offset), Seek::set);
+  return header;
+}
+inline ContainerHeader read_header(MappedReader& reader, std::string_view type_name,
+                                   std::size_t element_size) {
+  const auto header = reader.read(type_tag<ContainerHeader>);
+  check_header(header, type_name, element_size);
+  const auto stored = reader.view(header.type_name_size, type_tag<char>);
+  check_type_name(std::string_view{stored.data(), stored.size()}, type_name);
+  reader.seek(*safe_cast<std::size_t>(header.payload_offset));
+  return header;
+}
+
+/** Writes a section containing `element_num` elements of `type_name` with the given payload. */
+inline void write_section(FileWriter& writer, std::string_view type_name,
+                          std::size_t element_size, std::size_t element_num,
+                          std::span<const std::byte> payload, ContainerFileOptions options) {
+  if (options.alignment == 0) {
+    throw FileException{"The payload alignment has to be positive!"};
+  }
+  const auto header_offset = *safe_cast<std::size_t>(writer.tell());
+  const std::size_t name_end = header_offset + sizeof(ContainerHeader) + type_name.size();
+  const std::size_t payload_offset = div_ceil(name_end, options.alignment) * options.alignment;
+
+  ContainerHeader header{
+    .magic = ContainerHeader::expected_magic,
+    .version = ContainerHeader::current_version,
+    .endianness = ContainerHeader::native_endianness,
+    .checksum_kind = options.checksum,
+    .reserved = {},
+    .element_size = element_size,
+    .element_num = element_num,
+    .payload_offset = payload_offset,
+    .payload_size = payload.size(),
+    .checksum = options.checksum == ContainerChecksum::crc32c ? crc32c(payload) : 0,
+    .type_name_size = *safe_cast<u32>(type_name.size()),
+  };
+  writer.write(header);
+  writer.write(std::span{type_name.data(), type_name.size()});
+
+  static constexpr std::array<std::byte, 4096> zeros{};
+  for (std::size_t padding = payload_offset - name_end; padding > 0;) {
+    const std::size_t part = std::min(padding, zeros.size());
+    writer.write(std::span{zeros.data(), part});
+    padding -= part;
+  }
+  writer.write(payload);
+}
+} // namespace detail::container_file
+
+//--------------------------------------------------------------------------------------------------
+// TypedChunk
+//--------------------------------------------------------------------------------------------------
+
+/** Writes `chunk` as a section of a container file. */
+template<typename V, typename S, typename Alloc>
+inline void to_container_file(const TypedChunk<V, S, Alloc>& chunk, FileWriter& writer,
+                              ContainerFileOptions options = {}) {
+  detail::container_file::write_section(writer, type_name<V>(), sizeof(V), chunk.size(),
+                                        std::as_bytes(chunk.span()), options);
+}
+
+/**
+ * Reads a `TypedChunk` previously written by `to_container_file`, verifying the checksum
+ * if there is one and `verify` is `true`.
+ */
+template<typename V, typename S, typename Alloc>
+inline TypedChunk<V, S, Alloc> from_container_file(FileReader& reader,
+                                                   TypeTag<TypedChunk<V, S, Alloc>> /*tag*/,
+                                                   bool verify = true) {
+  const auto header = detail::container_file::read_header(reader, type_name<V>(), sizeof(V));
+  TypedChunk<V, S, Alloc> chunk(*safe_cast<S>(header.element_num));
+  reader.read(chunk.span());
+  if (verify) {
+    detail::container_file::check_payload(header, std::as_bytes(chunk.span()));
+  }
+  return chunk;
+}
+
+/**
+ * Returns a view of the elements of a `TypedChunk` previously written by `to_container_file`,
+ * verifying the checksum if there is one and `verify` is `true`, which requires reading all of
+ * the payload.
+ */
+template<typename V, typename S, typename Alloc>
+inline std::span<const V> view_from_container_file(MappedReader& reader,
+                                                   TypeTag<TypedChunk<V, S, Alloc>> /*tag*/,
+                                                   bool verify = true) {
+  const auto header = detail::container_file::read_header(reader, type_name<V>(), sizeof(V));
+  const auto values = reader.view(*safe_cast<std::size_t>(header.element_num), type_tag<V>);
+  if (verify) {
+    detail::container_file::check_payload(header, std::as_bytes(values));
+  }
+  return values;
+}
+
+//--------------------------------------------------------------------------------------------------
+// NestedDynamicArray
+//--------------------------------------------------------------------------------------------------
+
+/** Writes `array` as a section containing its offsets followed by one containing its values. */
+template<typename T, typename S, typename A>
+inline void to_container_file(const NestedDynamicArray<T, S, A>& array, FileWriter& writer,
+                              ContainerFileOptions options = {}) {
+  to_container_file(array.offsets(), writer, options);
+  to_container_file(array.values(), writer, options);
+}
+
+/**
+ * Reads a `NestedDynamicArray` previously written by `to_container_file`, which throws a
+ * `FileException` if the offsets do not delimit the values.
+ */
+template<typename T, typename S, typename A>
+inline NestedDynamicArray<T, S, A>
+from_container_file(FileReader& reader, TypeTag<NestedDynamicArray<T, S, A>> /*tag*/,
+                    bool verify = true) {
+  using Array = NestedDynamicArray<T, S, A>;
+  auto offsets = from_container_file(reader, type_tag<typename Array::SizeStorage>, verify);
+  auto values = from_container_file(reader, type_tag<typename Array::Storage>, verify);
+  detail::check_nested_offsets<S>(offsets.span(), values.size());
+  return Array{std::move(offsets), std::move(values)};
+}
+
+/**
+ * Returns a view of a `NestedDynamicArray` previously written by `to_container_file`, which throws
+ * a `FileException` if the offsets do not delimit the values.
+ */
+template<typename T, typename S, typename A>
+inline NestedDynamicArrayView<T, S>
+view_from_container_file(MappedReader& reader, TypeTag<NestedDynamicArray<T, S, A>> /*tag*/,
+                         bool verify = true) {
+  using Array = NestedDynamicArray<T, S, A>;
+  auto offsets = view_from_container_file(reader, type_tag<typename Array::SizeStorage>, verify);
+  auto values = view_from_container_file(reader, type_tag<typename Array::Storage>, verify);
+  detail::check_nested_offsets(offsets, values.size());
+  return NestedDynamicArrayView<T, S>{offsets, values};
+}
+
+//--------------------------------------------------------------------------------------------------
+// Multi-byte integers
+//--------------------------------------------------------------------------------------------------
+
+/** Writes `array` as a section containing its packed byte content. */
+template<typename D, typename ByteInt, std::size_t PaddingBytes, bool IsOptional, typename Storage>
+inline void
+to_container_file(const MultiByteIntegersBase<D, ByteInt, PaddingBytes, IsOptional, Storage>& array,
+                  FileWriter& writer, ContainerFileOptions options = {}) {
+  detail::container_file::write_section(writer, type_name<ByteInt>(), ByteInt::byte_num,
+                                        array.size(), std::as_bytes(array.byte_span()), options);
+}
+
+/** Reads a `MultiByteIntegerArray` previously written by `to_container_file`. */
+template<typename ByteInt, std::size_t PaddingBytes, bool IsOptional, typename ByteAlloc>
+inline MultiByteIntegerArray<ByteInt, PaddingBytes, IsOptional, ByteAlloc> from_container_file(
+  FileReader& reader,
+  TypeTag<MultiByteIntegerArray<ByteInt, PaddingBytes, IsOptional, ByteAlloc>> /*tag*/,
+  bool verify = true) {
+  const auto header =
+    detail::container_file::read_header(reader, type_name<ByteInt>(), ByteInt::byte_num);
+  MultiByteIntegerArray<ByteInt, PaddingBytes, IsOptional, ByteAlloc> out(
+    *safe_cast<std::size_t>(header.element_num));
+  reader.read(out.byte_span());
+  if (verify) {
+    detail::container_file::check_payload(header, std::as_bytes(out.byte_span()));
+  }
+  return out;
+}
+
+/**
+ * Returns a view of a `MultiByteIntegerArray` previously written by `to_container_file`.
+ *
+ * The padded loads may read up to `PaddingBytes` bytes before the elements, which are covered by
+ * the header or the alignment padding, and after them, which are either followed by other data or
+ * by the zeros that `MappedFile` places after the end of the file.
+ */
+template<typename ByteInt, std::size_t PaddingBytes, bool IsOptional, typename ByteAlloc>
+requires(PaddingBytes <= sizeof(ContainerHeader))
+inline MultiByteSubRange<true, ByteInt, PaddingBytes, IsOptional> view_from_container_file(
+  MappedReader& reader,
+  TypeTag<MultiByteIntegerArray<ByteInt, PaddingBytes, IsOptional, ByteAlloc>> /*tag*/,
+  bool verify = true) {
+  const auto header =
+    detail::container_file::read_header(reader, type_name<ByteInt>(), ByteInt::byte_num);
+  const auto bytes = reader.view(*safe_cast<std::size_t>(header.payload_size), type_tag<std::byte>);
+  if (verify) {
+    detail::container_file::check_payload(header, bytes);
+  }
+  return {bytes.data(), *safe_cast<std::size_t>(header.element_num)};
+}
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_IO_CONTAINER_FILE_HPP
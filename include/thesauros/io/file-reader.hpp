@@ -19,6 +19,7 @@
 #include "thesauros/containers/dynamic-buffer.hpp"
 #include "thesauros/io/file.hpp"
 #include "thesauros/macropolis/inlining.hpp"
+#include "thesauros/macropolis/platform.hpp"
 #include "thesauros/math/integer-cast.hpp"
 #include "thesauros/types/type-tag.hpp"
 
@@ -105,14 +106,24 @@ struct FileReader {
     return ret;
   }
 
+  /**
+   * Reads up to `span.size()` values at `offset` without changing the position of the stream.
+   * On POSIX systems, this uses `pread`, so that several threads can read from the same reader.
+   */
   template<typename T>
   requires std::is_trivial_v<T>
   std::size_t try_pread(std::span<T> span, long offset) {
+#if THES_LINUX || THES_APPLE
+    const std::size_t bytes =
+      pread_all(::fileno(handle_), std::as_writable_bytes(span), *safe_cast<std::size_t>(offset));
+    return bytes / sizeof(T);
+#else
     const auto pre = tell();
     seek(offset, Seek::set);
     const auto ret = try_read(span);
     seek(pre, Seek::set);
     return ret;
+#endif
   }
   std::size_t try_pread(DynamicBuffer& buf, std::size_t size, long offset) {
     buf.resize(size);
@@ -16,6 +16,8 @@
 
 #include "thesauros/charconv/concat.hpp"
 #include "thesauros/io/file.hpp"
+#include "thesauros/macropolis/platform.hpp"
+#include "thesauros/math/integer-cast.hpp"
 
 namespace thes {
 struct FileWriter {
@@ -53,6 +55,30 @@ struct FileWriter {
     write(std::span{&value, 1});
   }
 
+  /**
+   * Writes `span` at `offset` without changing the position of the stream, flushing the stream
+   * first. On POSIX systems, this uses `pwrite`.
+   */
+  template<typename T>
+  requires std::is_trivial_v<std::decay_t<T>>
+  void pwrite(std::span<T> span, long offset) {
+    if (std::fflush(handle_) != 0) {
+      throw FileException(cat("fflush failed: ", errno));
+    }
+#if THES_LINUX || THES_APPLE
+    pwrite_all(::fileno(handle_), std::as_bytes(span), *safe_cast<std::size_t>(offset));
+#else
+    const auto pre = tell();
+    seek(offset, Seek::set);
+    write(span);
+    seek(pre, Seek::set);
+#endif
+  }
+  template<typename T>
+  void pwrite(const T& value, long offset) {
+    pwrite(std::span{&value, 1}, offset);
+  }
+
   void seek(long offset, Seek whence) {
     const auto ret = std::fseek(handle_, offset, int(whence));
     if (ret != 0) {
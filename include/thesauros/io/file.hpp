@@ -7,20 +7,27 @@
 #ifndef INCLUDE_THESAUROS_IO_FILE_HPP
 #define INCLUDE_THESAUROS_IO_FILE_HPP
 
+#include <cerrno>
 #include <concepts>
 #include <cstddef>
 #include <cstdio>
 #include <exception>
 #include <filesystem>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
 
+#include "thesauros/charconv/concat.hpp"
 #include "thesauros/macropolis/platform.hpp"
 
 #if THES_WINDOWS
 #include <ranges>
 #endif
+#if THES_LINUX || THES_APPLE
+#include <sys/types.h>
+#include <unistd.h>
+#endif
 
 namespace thes {
 template<typename T>
@@ -58,6 +65,48 @@ inline decltype(auto) path_string(const std::filesystem::path& path) {
   return path;
 #endif
 }
+
+#if THES_LINUX || THES_APPLE
+/**
+ * Reads into `bytes` from `fd` at `offset` using `pread`, which neither uses nor changes the file
+ * position and can therefore be called concurrently. Short reads are continued until the end of
+ * the file is reached, and the number of bytes read is returned.
+ */
+inline std::size_t pread_all(int fd, std::span<std::byte> bytes, std::size_t offset) {
+  std::size_t done = 0;
+  while (done < bytes.size()) {
+    const auto ret =
+      ::pread(fd, bytes.data() + done, bytes.size() - done, static_cast<off_t>(offset + done));
+    if (ret == 0) {
+      break;
+    }
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw FileException{cat("pread failed: ", errno)};
+    }
+    done += static_cast<std::size_t>(ret);
+  }
+  return done;
+}
+
+/** Writes `bytes` to `fd` at `offset` using `pwrite`, continuing short writes. */
+inline void pwrite_all(int fd, std::span<const std::byte> bytes, std::size_t offset) {
+  std::size_t done = 0;
+  while (done < bytes.size()) {
+    const auto ret =
+      ::pwrite(fd, bytes.data() + done, bytes.size() - done, static_cast<off_t>(offset + done));
+    if (ret < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw FileException{cat("pwrite failed: ", errno)};
+    }
+    done += static_cast<std::size_t>(ret);
+  }
+}
+#endif
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_IO_FILE_HPP
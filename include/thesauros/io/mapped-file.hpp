@@ -0,0 +1,216 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_IO_MAPPED_FILE_HPP
+#define INCLUDE_THESAUROS_IO_MAPPED_FILE_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <span>
+#include <type_traits>
+
+#include "thesauros/charconv/concat.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/macropolis/platform.hpp"
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/types/primitives.hpp"
+#include "thesauros/types/type-tag.hpp"
+
+#if THES_LINUX || THES_APPLE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include "thesauros/containers/dynamic-buffer.hpp"
+#include "thesauros/io/file-reader.hpp"
+#endif
+
+namespace thes {
+/** The expected pattern of accesses to a `MappedFile`, which the system uses for read-ahead. */
+enum struct MapAccess : u8 { normal, sequential, random };
+
+/** Hints on how to map a file into memory. */
+struct MapOptions {
+  /** Read the whole file and map its pages right away, instead of on first access. */
+  bool populate = false;
+  /** Ask for the file to be backed by huge pages, if the file system supports this. */
+  bool huge_pages = false;
+  MapAccess access = MapAccess::normal;
+};
+
+/**
+ * A file mapped read-only into memory, so that its contents can be accessed without copying them
+ * and the page cache is shared between all processes which map the same file.
+ *
+ * The mapping is followed by at least one page of zeros, so that reading a few bytes beyond the
+ * end of the file is safe, as done by `MultiByteSubRange`. On systems without `mmap`, the file is
+ * read into memory instead.
+ */
+struct MappedFile {
+  explicit MappedFile(const std::filesystem::path& path, MapOptions options = {}) {
+#if THES_LINUX || THES_APPLE
+    const int fd = ::open(path_string(path).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+      throw FileException{cat("open failed: ", errno)};
+    }
+    try {
+      map(fd, options);
+    } catch (...) {
+      ::close(fd);
+      throw;
+    }
+    // The mapping remains valid after closing the file.
+    ::close(fd);
+#else
+    (void)options;
+    FileReader{path}.read_full(buffer_);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+#endif
+  }
+  MappedFile(const MappedFile&) = delete;
+  MappedFile(MappedFile&&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile& operator=(MappedFile&&) = delete;
+  ~MappedFile() {
+#if THES_LINUX || THES_APPLE
+    // NOLINTNEXTLINE(*-const-cast)
+    ::munmap(const_cast<std::byte*>(data_), mapping_size_);
+#endif
+  }
+
+  [[nodiscard]] std::span<const std::byte> bytes() const {
+    return {data_, size_};
+  }
+  [[nodiscard]] const std::byte* data() const {
+    return data_;
+  }
+  [[nodiscard]] std::size_t size() const {
+    return size_;
+  }
+
+private:
+#if THES_LINUX || THES_APPLE
+  void map(int fd, MapOptions options) {
+    struct stat status{};
+    if (::fstat(fd, &status) != 0) {
+      throw FileException{cat("fstat failed: ", errno)};
+    }
+    size_ = std::size_t(status.st_size);
+
+    // Reserve the address range including the trailing page of zeros, then map the file over it.
+    const auto page_size = std::size_t(::sysconf(_SC_PAGESIZE));
+    mapping_size_ = (div_ceil(size_, page_size) + 1) * page_size;
+    void* reserved =
+      ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reserved == MAP_FAILED) {
+      throw FileException{cat("mmap failed: ", errno)};
+    }
+    if (size_ > 0) {
+      int flags = MAP_SHARED | MAP_FIXED;
+#if THES_LINUX
+      if (options.populate) {
+        flags |= MAP_POPULATE;
+      }
+#endif
+      if (::mmap(reserved, size_, PROT_READ, flags, fd, 0) == MAP_FAILED) {
+        const int error = errno;
+        ::munmap(reserved, mapping_size_);
+        throw FileException{cat("mmap failed: ", error)};
+      }
+    }
+    data_ = static_cast<const std::byte*>(reserved);
+
+    // The hints are only hints, so failing to apply them is not an error.
+    if (size_ > 0) {
+      switch (options.access) {
+        case MapAccess::normal: break;
+        case MapAccess::sequential: ::madvise(reserved, size_, MADV_SEQUENTIAL); break;
+        case MapAccess::random: ::madvise(reserved, size_, MADV_RANDOM); break;
+      }
+#if THES_LINUX
+      if (options.huge_pages) {
+        ::madvise(reserved, size_, MADV_HUGEPAGE);
+      }
+#else
+      if (options.populate) {
+        ::madvise(reserved, size_, MADV_WILLNEED);
+      }
+#endif
+    }
+  }
+
+  std::size_t mapping_size_{0};
+#else
+  DynamicBuffer buffer_{};
+#endif
+  const std::byte* data_{nullptr};
+  std::size_t size_{0};
+};
+
+/**
+ * Reads from a `MappedFile` sequentially like `FileReader`, but can additionally provide views of
+ * the file’s contents instead of copies.
+ */
+struct MappedReader {
+  explicit MappedReader(const MappedFile& file) : bytes_(file.bytes()) {}
+
+  template<typename T>
+  requires std::is_trivial_v<T>
+  T read(TypeTag<T> /*tag*/) {
+    T value{};
+    std::memcpy(&value, take(sizeof(T), alignof(std::byte)), sizeof(T));
+    return value;
+  }
+
+  /**
+   * Returns a view of the next `size` values of type `T`, which have to be aligned as `T`
+   * requires. As with `std::span`, the view is only valid as long as the file is mapped.
+   */
+  template<typename T>
+  requires std::is_trivial_v<T>
+  std::span<const T> view(std::size_t size, TypeTag<T> /*tag*/ = {}) {
+    if (size > (bytes_.size() - offset_) / sizeof(T)) {
+      throw FileException{cat("view of ", size, " values exceeds the file at offset ", offset_)};
+    }
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    return {reinterpret_cast<const T*>(take(size * sizeof(T), alignof(T))), size};
+  }
+
+  [[nodiscard]] std::size_t tell() const {
+    return offset_;
+  }
+  void seek(std::size_t offset) {
+    if (offset > bytes_.size()) {
+      throw FileException{cat("seek to ", offset, " beyond the file size ", bytes_.size())};
+    }
+    offset_ = offset;
+  }
+
+private:
+  const std::byte* take(std::size_t size, std::size_t alignment) {
+    if (size > bytes_.size() - offset_) {
+      throw FileException{cat("reading ", size, " bytes exceeds the file at offset ", offset_)};
+    }
+    const std::byte* data = bytes_.data() + offset_;
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    if (reinterpret_cast<std::uintptr_t>(data) % alignment != 0) {
+      throw FileException{cat("offset ", offset_, " is not aligned to ", alignment, " bytes")};
+    }
+    offset_ += size;
+    return data;
+  }
+
+  std::span<const std::byte> bytes_;
+  std::size_t offset_{0};
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_IO_MAPPED_FILE_HPP
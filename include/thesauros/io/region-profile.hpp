@@ -0,0 +1,32 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_IO_REGION_PROFILE_HPP
+#define INCLUDE_THESAUROS_IO_REGION_PROFILE_HPP
+
+#include <cstddef>
+#include <vector>
+
+#include "thesauros/execution/system/region-profiler.hpp"
+#include "thesauros/reflection/helpers.hpp" // IWYU pragma: keep
+#include "thesauros/reflection/type.hpp"
+
+// The type information lives here rather than next to the profiles themselves, as the execution
+// headers cannot depend on Boost.Preprocessor. Including this header allows `json_print` and the
+// other reflection-based functions to be used on the profiles.
+namespace thes {
+THES_DEFINE_TYPE_INFO(SNAKE_CASE(RegionProfile),
+                      MEMBERS((KEEP(dispatch_latency), double),
+                              (KEEP(busy_times), std::vector<double>),
+                              (KEEP(wait_times), std::vector<double>), (KEEP(imbalance), double)))
+THES_DEFINE_TYPE_INFO(SNAKE_CASE(RegionProfileSummary),
+                      MEMBERS((KEEP(regions), std::size_t), (KEEP(mean_dispatch_latency), double),
+                              (KEEP(busy_times), std::vector<double>),
+                              (KEEP(wait_times), std::vector<double>),
+                              (KEEP(mean_imbalance), double)))
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_IO_REGION_PROFILE_HPP
@@ -7,15 +7,24 @@
 #ifndef INCLUDE_THESAUROS_IO_SERIALIZATION_HPP
 #define INCLUDE_THESAUROS_IO_SERIALIZATION_HPP
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
+#include <functional>
+#include <limits>
 #include <span>
 #include <utility>
 
+#include "thesauros/charconv/concat.hpp"
 #include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/containers/bitset/chunks.hpp"
+#include "thesauros/containers/bitset/compressed.hpp"
 #include "thesauros/containers/multi-byte-integers.hpp"
 #include "thesauros/containers/nested-dynamic-array.hpp"
 #include "thesauros/io/file-reader.hpp"
 #include "thesauros/io/file-writer.hpp"
+#include "thesauros/io/mapped-file.hpp"
+#include "thesauros/math/arithmetic.hpp"
 #include "thesauros/types/type-tag.hpp"
 
 /**
@@ -25,6 +34,9 @@
  * exist: the dependency runs from `io` to `containers` only. Every container is written as its
  * element count followed by its raw element bytes, so a `to_file`/`from_file` pair round-trips
  * only between runs that agree on element type and endianness.
+ *
+ * The `view_from_file` overloads read the same format from a `MappedFile` without copying: they
+ * return views of the mapped bytes, which remain valid as long as the file stays mapped.
  */
 namespace thes {
 //--------------------------------------------------------------------------------------------------
@@ -48,10 +60,35 @@ inline TypedChunk<V, S, Alloc> from_file(FileReader& reader,
   return chunk;
 }
 
+/**
+ * Returns a view of the elements of a `TypedChunk` previously written by `to_file`, which throws
+ * a `FileException` if they are not aligned as `V` requires within the mapping.
+ */
+template<typename V, typename S, typename Alloc>
+inline std::span<const V> view_from_file(MappedReader& reader,
+                                         TypeTag<TypedChunk<V, S, Alloc>> /*tag*/) {
+  const S size = reader.read(type_tag<S>);
+  return reader.view(size, type_tag<V>);
+}
+
 //--------------------------------------------------------------------------------------------------
 // NestedDynamicArray
 //--------------------------------------------------------------------------------------------------
 
+namespace detail {
+/**
+ * Throws a `FileException` unless `offsets` delimit the ranges of a nested array with `value_num`
+ * values, i.e. they start at zero, never decrease and end at `value_num`.
+ */
+template<typename S>
+inline void check_nested_offsets(std::span<const S> offsets, std::size_t value_num) {
+  if (offsets.empty() || offsets.front() != 0 || offsets.back() != value_num ||
+      !std::ranges::is_sorted(offsets)) {
+    throw FileException{"The offsets do not match the values of the nested array!"};
+  }
+}
+} // namespace detail
+
 /** Writes `array` as its offsets followed by its values. */
 template<typename T, typename S, typename A>
 inline void to_file(const NestedDynamicArray<T, S, A>& array, FileWriter& writer) {
@@ -59,16 +96,34 @@ inline void to_file(const NestedDynamicArray<T, S, A>& array, FileWriter& writer
   to_file(array.values(), writer);
 }
 
-/** Reads a `NestedDynamicArray` previously written by `to_file`. */
+/**
+ * Reads a `NestedDynamicArray` previously written by `to_file`, which throws a `FileException` if
+ * the offsets do not delimit the values.
+ */
 template<typename T, typename S, typename A>
 inline NestedDynamicArray<T, S, A> from_file(FileReader& reader,
                                              TypeTag<NestedDynamicArray<T, S, A>> /*tag*/) {
   using Array = NestedDynamicArray<T, S, A>;
   auto offsets = from_file(reader, type_tag<typename Array::SizeStorage>);
   auto values = from_file(reader, type_tag<typename Array::Storage>);
+  detail::check_nested_offsets<S>(offsets.span(), values.size());
   return Array{std::move(offsets), std::move(values)};
 }
 
+/**
+ * Returns a view of a `NestedDynamicArray` previously written by `to_file`, which throws a
+ * `FileException` if the offsets do not delimit the values.
+ */
+template<typename T, typename S, typename A>
+inline NestedDynamicArrayView<T, S> view_from_file(MappedReader& reader,
+                                                   TypeTag<NestedDynamicArray<T, S, A>> /*tag*/) {
+  using Array = NestedDynamicArray<T, S, A>;
+  auto offsets = view_from_file(reader, type_tag<typename Array::SizeStorage>);
+  auto values = view_from_file(reader, type_tag<typename Array::Storage>);
+  detail::check_nested_offsets(offsets, values.size());
+  return NestedDynamicArrayView<T, S>{offsets, values};
+}
+
 //--------------------------------------------------------------------------------------------------
 // Multi-byte integers
 //--------------------------------------------------------------------------------------------------
@@ -93,6 +148,141 @@ from_file(FileReader& reader,
   reader.read(out.byte_span());
   return out;
 }
+
+/**
+ * Returns a view of a `MultiByteIntegerArray` previously written by `to_file`.
+ *
+ * The padded loads may read up to `PaddingBytes` bytes before the elements, which are covered by
+ * the element count, and after them, which are either followed by other data or by the zeros that
+ * `MappedFile` places after the end of the file.
+ */
+template<typename ByteInt, std::size_t PaddingBytes, bool IsOptional, typename ByteAlloc>
+requires(PaddingBytes <= sizeof(std::size_t))
+inline MultiByteSubRange<true, ByteInt, PaddingBytes, IsOptional> view_from_file(
+  MappedReader& reader,
+  TypeTag<MultiByteIntegerArray<ByteInt, PaddingBytes, IsOptional, ByteAlloc>> /*tag*/) {
+  const auto size = reader.read(type_tag<std::size_t>);
+  if (size > std::numeric_limits<std::size_t>::max() / ByteInt::byte_num) {
+    throw FileException{cat("The size ", size, " of the multi-byte integers is too large!")};
+  }
+  const auto bytes = reader.view(size * ByteInt::byte_num, type_tag<std::byte>);
+  return {bytes.data(), size};
+}
+
+//--------------------------------------------------------------------------------------------------
+// CompressedBitset
+//--------------------------------------------------------------------------------------------------
+
+/**
+ * Writes `bitset` as its size and block count, followed by the key, kind, cardinality and
+ * payload length of each block and its offsets or words.
+ */
+inline void to_file(const CompressedBitset& bitset, FileWriter& writer) {
+  using Kind = CompressedBlockKind;
+  const std::array<std::size_t, 2> header{bitset.size(), bitset.blocks().size()};
+  writer.write(header);
+  for (const CompressedBitset::Block& block : bitset.blocks()) {
+    const std::size_t length =
+      block.kind == Kind::bitmap ? block.words.size() : block.offsets.size();
+    const std::array<std::size_t, 4> block_header{block.key, std::size_t(block.kind),
+                                                  block.cardinality, length};
+    writer.write(block_header);
+    if (block.kind == Kind::bitmap) {
+      writer.write(std::span{block.words.data(), block.words.size()});
+    } else {
+      writer.write(std::span{block.offsets.data(), block.offsets.size()});
+    }
+  }
+}
+
+/**
+ * Reads a `CompressedBitset` previously written by `to_file`, which throws a `FileException` if
+ * the blocks are not consistent with each other and the size: The keys have to increase, the
+ * offsets of an array have to increase, the runs have to be ordered and disjoint, no bit may lie
+ * at or beyond the size, and the cardinality of each block has to match its content and kind.
+ */
+inline CompressedBitset from_file(FileReader& reader, TypeTag<CompressedBitset> /*tag*/) {
+  using Bitset = CompressedBitset;
+  using Kind = CompressedBlockKind;
+  const auto [size, block_num] = reader.read(type_tag<std::array<std::size_t, 2>>);
+  const std::size_t key_end = div_ceil(size, Bitset::block_bit_num);
+  if (block_num > key_end) {
+    throw FileException{cat("There are ", block_num, " blocks for ", size, " bits!")};
+  }
+
+  Bitset::Blocks blocks{};
+  blocks.reserve(block_num);
+  for (std::size_t i = 0; i < block_num; ++i) {
+    const auto invalid = [i] {
+      return FileException{cat("The block ", i, " of the compressed bitset is invalid!")};
+    };
+
+    const auto [key, kind, cardinality, length] =
+      reader.read(type_tag<std::array<std::size_t, 4>>);
+    const bool key_valid = key < key_end && (blocks.empty() || blocks.back().key < key);
+    // Checked before allocating, so that a corrupt length cannot request arbitrary memory.
+    const bool length_valid =
+      (kind == std::size_t(Kind::array) && length > 0 && length <= Bitset::array_max_size) ||
+      (kind == std::size_t(Kind::bitmap) && length == Bitset::bitmap_word_num) ||
+      (kind == std::size_t(Kind::run) && length > 0 && length % 2 == 0 &&
+       length <= Bitset::block_bit_num);
+    if (!key_valid || !length_valid) {
+      throw invalid();
+    }
+    // The number of offsets in the last block which are below the size.
+    const std::size_t offset_end = std::min(size - key * Bitset::block_bit_num,
+                                            Bitset::block_bit_num);
+
+    Bitset::Block block{.key = key, .kind = Kind(kind), .cardinality = 0};
+    switch (block.kind) {
+      case Kind::array: {
+        block.offsets.resize(length);
+        reader.read(std::span{block.offsets.data(), length});
+        const auto& offsets = block.offsets;
+        if (std::ranges::adjacent_find(offsets, std::greater_equal{}) != offsets.end() ||
+            offsets.back() >= offset_end) {
+          throw invalid();
+        }
+        block.cardinality = length;
+        break;
+      }
+      case Kind::bitmap: {
+        block.words.resize(length);
+        reader.read(std::span{block.words.data(), length});
+        const std::span<const Bitset::Word> words{block.words.data(), length};
+        block.cardinality = detail::bitset::popcount(words.data(), words.data() + words.size());
+        if (block.cardinality <= Bitset::array_max_size ||
+            detail::bitset::find_next(words, Bitset::block_bit_num, offset_end) !=
+              Bitset::block_bit_num) {
+          throw invalid();
+        }
+        break;
+      }
+      case Kind::run: {
+        block.offsets.resize(length);
+        reader.read(std::span{block.offsets.data(), length});
+        const auto& offsets = block.offsets;
+        for (std::size_t j = 0; j < length; j += 2) {
+          const std::size_t first = offsets[j];
+          const std::size_t last = offsets[j + 1];
+          if (first > last || (j > 0 && first <= offsets[j - 1])) {
+            throw invalid();
+          }
+          block.cardinality += last - first + 1;
+        }
+        if (offsets.back() >= offset_end) {
+          throw invalid();
+        }
+        break;
+      }
+    }
+    if (block.cardinality != cardinality) {
+      throw invalid();
+    }
+    blocks.push_back(std::move(block));
+  }
+  return Bitset{size, std::move(blocks)};
+}
 } // namespace thes
 
 #endif // INCLUDE_THESAUROS_IO_SERIALIZATION_HPP
@@ -2,8 +2,14 @@
 #define INCLUDE_THESAUROS_MEMORY_HPP
 
 // IWYU pragma: begin_exports
+#include "memory/arena.hpp"
 #include "memory/byte-read.hpp"
+#include "memory/cache-line.hpp"
 #include "memory/huge-pages-allocator.hpp"
+#include "memory/malloc-allocator.hpp"
+#include "memory/non-temporal.hpp"
+#include "memory/numa-huge-pages-allocator.hpp"
+#include "memory/size-class-pool.hpp"
 // IWYU pragma: end_exports
 
 #endif // INCLUDE_THESAUROS_MEMORY_HPP
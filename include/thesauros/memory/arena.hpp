@@ -0,0 +1,244 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_MEMORY_ARENA_HPP
+#define INCLUDE_THESAUROS_MEMORY_ARENA_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "thesauros/memory/huge-pages-allocator.hpp"
+
+namespace thes {
+template<typename Arena>
+struct ArenaScope;
+
+/**
+ * A monotonic arena: memory is handed out by bumping a pointer through blocks obtained from the
+ * `Upstream` allocator, and individual deallocations are ignored.
+ *
+ * All allocations are discarded at once by `reset` or by rewinding to an earlier `Marker`, which
+ * is O(1) and keeps the blocks for reuse, so that an arena which is reset periodically stops
+ * allocating from `Upstream` once it has reached its peak size. `release` returns the blocks.
+ *
+ * Each new block is twice as large as the previous one, but at least large enough for the
+ * allocation that required it. With `HugePagesArena`, the blocks are allocated using huge pages.
+ *
+ * An arena is not thread-safe and is meant to be used by a single thread at a time.
+ */
+template<typename Upstream = std::allocator<std::byte>>
+struct MonotonicArena {
+  using UpstreamAllocator = Upstream;
+
+  // One huge page if the blocks are allocated using huge pages, 64 KiB otherwise.
+  static constexpr std::size_t default_block_size = [] {
+    if constexpr (requires { Upstream::huge_page_size; }) {
+      return std::size_t{Upstream::huge_page_size};
+    } else {
+      return std::size_t{1} << 16U;
+    }
+  }();
+
+  /** A position in the arena, which `rewind` returns to. */
+  struct Marker {
+    std::size_t block;
+    std::size_t offset;
+  };
+
+  explicit MonotonicArena(std::size_t initial_block_size = default_block_size,
+                          Upstream upstream = {})
+      : upstream_(std::move(upstream)),
+        next_block_size_(std::max(initial_block_size, std::size_t{1})) {}
+
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena(MonotonicArena&&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(MonotonicArena&&) = delete;
+
+  ~MonotonicArena() {
+    release();
+  }
+
+  /** Allocate `size` bytes aligned to `alignment`, which has to be a power of two. */
+  [[nodiscard]] void* allocate(std::size_t size, std::size_t alignment) {
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+    if (current_ < blocks_.size()) {
+      if (void* p = bump(blocks_[current_], size, alignment)) {
+        return p;
+      }
+    }
+    // Move on to the next retained block which is large enough, skipping the others until the
+    // next rewind, or to a new one.
+    while (++current_ < blocks_.size()) {
+      offset_ = 0;
+      if (void* p = bump(blocks_[current_], size, alignment)) {
+        return p;
+      }
+    }
+    if (size > std::numeric_limits<std::size_t>::max() - alignment) {
+      throw std::bad_alloc{};
+    }
+    const std::size_t block_size = std::max(next_block_size_, size + alignment - 1);
+    blocks_.push_back(Block{.data = upstream_.allocate(block_size), .size = block_size});
+    next_block_size_ = std::max(next_block_size_, block_size) * 2;
+    current_ = blocks_.size() - 1;
+    offset_ = 0;
+    return bump(blocks_[current_], size, alignment);
+  }
+
+  [[nodiscard]] Marker mark() const {
+    return {.block = current_, .offset = offset_};
+  }
+  /** Discard all allocations made since `marker` was obtained. */
+  void rewind(Marker marker) {
+    assert(marker.block < current_ || (marker.block == current_ && marker.offset <= offset_));
+    current_ = marker.block;
+    offset_ = marker.offset;
+  }
+  /** Discard all allocations, retaining the blocks. */
+  void reset() {
+    rewind({});
+  }
+  /** Discard all allocations and return the blocks to the upstream allocator. */
+  void release() {
+    for (const Block& block : blocks_) {
+      upstream_.deallocate(block.data, block.size);
+    }
+    blocks_.clear();
+    current_ = 0;
+    offset_ = 0;
+  }
+
+  /** The number of bytes allocated from the upstream allocator. */
+  [[nodiscard]] std::size_t capacity() const {
+    std::size_t sum = 0;
+    for (const Block& block : blocks_) {
+      sum += block.size;
+    }
+    return sum;
+  }
+  [[nodiscard]] std::size_t block_num() const {
+    return blocks_.size();
+  }
+
+  /** The innermost arena made current on this thread by an `ArenaScope`, if any. */
+  [[nodiscard]] static MonotonicArena* current() {
+    return current_arena;
+  }
+
+private:
+  friend struct ArenaScope<MonotonicArena>;
+
+  struct Block {
+    std::byte* data;
+    std::size_t size;
+  };
+
+  void* bump(const Block& block, std::size_t size, std::size_t alignment) {
+    const auto address =
+      reinterpret_cast<std::uintptr_t>(block.data) + offset_; // NOLINT(*-reinterpret-cast)
+    const std::size_t padding = (alignment - address % alignment) % alignment;
+    if (padding > block.size - offset_ || size > block.size - offset_ - padding) {
+      return nullptr;
+    }
+    std::byte* p = block.data + offset_ + padding;
+    offset_ += padding + size;
+    return p;
+  }
+
+  static inline thread_local MonotonicArena* current_arena = nullptr;
+
+  [[no_unique_address]] Upstream upstream_;
+  std::vector<Block> blocks_{};
+  std::size_t next_block_size_;
+  // The position of the next allocation, which is at the start of `blocks_[current_]` if there
+  // are no blocks yet.
+  std::size_t current_{0};
+  std::size_t offset_{0};
+};
+
+using HugePagesArena = MonotonicArena<HugePagesAllocator<std::byte>>;
+
+/**
+ * Makes `arena` the current arena of the calling thread for the lifetime of the scope and
+ * discards everything allocated from it in the meantime at the end, restoring the previously
+ * current arena. Scopes can be nested, even for the same arena.
+ *
+ * Containers using an `ArenaAllocator` bound to the arena must not outlive the scope.
+ */
+template<typename Arena = MonotonicArena<>>
+struct ArenaScope {
+  explicit ArenaScope(Arena& arena)
+      : arena_(arena), marker_(arena.mark()), previous_(Arena::current_arena) {
+    Arena::current_arena = &arena_;
+  }
+
+  ArenaScope(const ArenaScope&) = delete;
+  ArenaScope(ArenaScope&&) = delete;
+  ArenaScope& operator=(const ArenaScope&) = delete;
+  ArenaScope& operator=(ArenaScope&&) = delete;
+
+  ~ArenaScope() {
+    arena_.rewind(marker_);
+    Arena::current_arena = previous_;
+  }
+
+private:
+  Arena& arena_;
+  Arena::Marker marker_;
+  Arena* previous_;
+};
+
+/**
+ * An allocator for use as the `Alloc` parameter of containers such as `DynamicArray`, `TypedChunk`
+ * or `NestedDynamicArray`, which allocates from a `MonotonicArena` and ignores deallocations.
+ *
+ * A default-constructed allocator is bound to the current arena of the calling thread, as set by
+ * `ArenaScope`, which allows it to be used by containers that default-construct their allocators.
+ */
+template<typename T, typename Arena = MonotonicArena<>>
+struct ArenaAllocator {
+  using value_type = T;
+
+  ArenaAllocator() noexcept : arena_(Arena::current()) {}
+  explicit ArenaAllocator(Arena& arena) noexcept : arena_(&arena) {}
+  template<typename U>
+  ArenaAllocator(const ArenaAllocator<U, Arena>& other) noexcept // NOLINT(*-explicit-*)
+      : arena_(other.arena()) {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc{};
+    }
+    // Default-constructed outside of an `ArenaScope`.
+    if (arena_ == nullptr) {
+      throw std::bad_alloc{};
+    }
+    return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* /*p*/, std::size_t /*n*/) noexcept {}
+
+  [[nodiscard]] Arena* arena() const noexcept {
+    return arena_;
+  }
+
+  friend bool operator==(const ArenaAllocator& a1, const ArenaAllocator& a2) noexcept {
+    return a1.arena_ == a2.arena_;
+  }
+
+private:
+  Arena* arena_;
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_MEMORY_ARENA_HPP
@@ -0,0 +1,27 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_MEMORY_CACHE_LINE_HPP
+#define INCLUDE_THESAUROS_MEMORY_CACHE_LINE_HPP
+
+#include <cstddef>
+
+namespace thes {
+/**
+ * The distance that keeps data modified by different threads from sharing a cache line.
+ * This is two 64-byte lines, since the adjacent-line prefetcher of x86-64 CPUs transfers lines in
+ * pairs, and coincides with the line size of Apple’s ARM64 cores.
+ */
+inline constexpr std::size_t cache_line_bytes = 128;
+
+/** A value occupying cache lines of its own, for per-thread state stored contiguously. */
+template<typename T>
+struct alignas(cache_line_bytes) CacheAligned {
+  T value{};
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_MEMORY_CACHE_LINE_HPP
@@ -8,17 +8,29 @@
 #define INCLUDE_THESAUROS_MEMORY_HUGE_PAGES_ALLOCATOR_HPP
 
 #include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <limits>
 #include <new>
 
 #include "thesauros/macropolis/platform.hpp"
+#include "thesauros/math/arithmetic.hpp"
 
 #if THES_LINUX || THES_APPLE
 #include <sys/mman.h>
 #endif
 
 namespace thes {
+/**
+ * An allocator which aligns its allocations to huge pages and advises the system to back them
+ * with huge pages where possible.
+ *
+ * On Linux, allocations of at least one huge page are mapped directly, which allows `reallocate`
+ * to grow them using `mremap`, i.e. by remapping the pages instead of copying their contents.
+ * Since the number of elements decides how an allocation is freed, `deallocate` and `reallocate`
+ * have to be passed the exact number of elements of the allocation (as the allocator
+ * requirements demand anyway), which `TypedChunk` and thus all arrays do.
+ */
 template<typename T>
 struct HugePagesAllocator {
   static constexpr std::size_t huge_page_size = 1U << 21U; // 2 MiB
@@ -33,6 +45,15 @@ struct HugePagesAllocator {
     if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
       throw std::bad_alloc{};
     }
+#if THES_LINUX
+    if (is_mapped(n)) {
+      void* p = map(mapping_size(n));
+      if (p == nullptr) {
+        throw std::bad_alloc{};
+      }
+      return static_cast<T*>(p);
+    }
+#endif
     void* p = nullptr;
 #if THES_LINUX || THES_APPLE
     if (posix_memalign(&p, huge_page_size, n * sizeof(T)) != 0) {
@@ -50,13 +71,105 @@ struct HugePagesAllocator {
     return static_cast<T*>(p);
   }
 
-  void deallocate(T* p, std::size_t /*n*/) {
+  void deallocate(T* p, [[maybe_unused]] std::size_t n) {
+#if THES_LINUX
+    if (is_mapped(n)) {
+      munmap(p, mapping_size(n));
+      return;
+    }
+#endif
 #if THES_LINUX || THES_APPLE
     std::free(p);
 #elif THES_WINDOWS
     _aligned_free(p);
 #endif
   }
+
+  /** The number of elements that an allocation of `n` elements can actually hold. */
+  [[nodiscard]] std::size_t usable_size(std::size_t n) const noexcept {
+#if THES_LINUX
+    if (is_mapped(n) && n <= std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      return mapping_size(n) / sizeof(T);
+    }
+#endif
+    return n;
+  }
+
+  /**
+   * Grow an allocation of `old_n` elements to `new_n` elements, keeping the bytes of the old ones,
+   * by remapping its pages, which only works for allocations of at least one huge page on Linux.
+   * Returns `nullptr` and leaves the allocation untouched if this is not possible.
+   */
+  T* reallocate([[maybe_unused]] T* p, [[maybe_unused]] std::size_t old_n,
+                [[maybe_unused]] std::size_t new_n) {
+#if THES_LINUX
+    if (!is_mapped(old_n) || new_n < old_n ||
+        new_n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      return nullptr;
+    }
+    const std::size_t old_size = mapping_size(old_n);
+    const std::size_t new_size = mapping_size(new_n);
+    if (new_size == old_size) {
+      return p;
+    }
+    // Grow in place if the address range following the allocation is free.
+    if (mremap(p, old_size, new_size, 0) != MAP_FAILED) {
+      madvise(p, new_size, MADV_HUGEPAGE);
+      return p;
+    }
+    // Otherwise, move the pages to a new range aligned to a huge page.
+    void* target = map(new_size);
+    if (target == nullptr) {
+      return nullptr;
+    }
+    if (mremap(p, old_size, new_size, MREMAP_MAYMOVE | MREMAP_FIXED, target) == MAP_FAILED) {
+      munmap(target, new_size);
+      return nullptr;
+    }
+    madvise(target, new_size, MADV_HUGEPAGE);
+    return static_cast<T*>(target);
+#else
+    return nullptr;
+#endif
+  }
+
+private:
+#if THES_LINUX
+  static bool is_mapped(std::size_t n) {
+    return n >= div_ceil(huge_page_size, sizeof(T));
+  }
+  static std::size_t mapping_size(std::size_t n) {
+    return div_ceil(n * sizeof(T), huge_page_size) * huge_page_size;
+  }
+
+  /**
+   * Map `size` bytes aligned to a huge page by mapping more and unmapping the excess, returning
+   * `nullptr` on failure.
+   */
+  static void* map(std::size_t size) {
+    if (size > std::numeric_limits<std::size_t>::max() - huge_page_size) {
+      return nullptr;
+    }
+    const std::size_t padded_size = size + huge_page_size;
+    void* p =
+      mmap(nullptr, padded_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      return nullptr;
+    }
+    auto* const begin = static_cast<std::byte*>(p);
+    const auto address = reinterpret_cast<std::uintptr_t>(p); // NOLINT(*-reinterpret-cast)
+    const std::uintptr_t alignment = huge_page_size;
+    const std::size_t head = div_ceil(address, alignment) * alignment - address;
+    if (head > 0) {
+      munmap(begin, head);
+    }
+    if (head < huge_page_size) {
+      munmap(begin + head + size, huge_page_size - head);
+    }
+    madvise(begin + head, size, MADV_HUGEPAGE);
+    return begin + head;
+  }
+#endif
 };
 } // namespace thes
 
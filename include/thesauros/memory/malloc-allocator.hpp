@@ -0,0 +1,87 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_MEMORY_MALLOC_ALLOCATOR_HPP
+#define INCLUDE_THESAUROS_MEMORY_MALLOC_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+
+namespace thes {
+/**
+ * An allocator using `malloc` and `free`, which provides `reallocate` using `realloc`, so that
+ * containers of trivially relocatable elements can grow without copying them if the memory
+ * following an allocation is free, or, for large allocations, by remapping their pages.
+ */
+template<typename T>
+requires(alignof(T) <= alignof(std::max_align_t))
+struct MallocAllocator {
+  using value_type = T;
+  // The initial threshold above which glibc may map allocations directly.
+  static constexpr std::size_t mmap_threshold = std::size_t{1} << 17U;
+
+  MallocAllocator() = default;
+  template<typename U>
+  MallocAllocator(const MallocAllocator<U>& /*other*/) noexcept {} // NOLINT(*-explicit-*)
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc{};
+    }
+    void* p = std::malloc(n * sizeof(T)); // NOLINT(*-no-malloc,*-owning-memory)
+    if (p == nullptr) {
+      throw std::bad_alloc{};
+    }
+    return static_cast<T*>(p);
+  }
+  void deallocate(T* p, std::size_t /*n*/) noexcept {
+    std::free(p); // NOLINT(*-no-malloc,*-owning-memory)
+  }
+  /**
+   * The number of elements that an allocation of `n` elements can actually hold, i.e. what
+   * `malloc_usable_size` reports for such an allocation. With glibc, this mirrors its rounding of
+   * the chunk sizes below the initial threshold of 128 KiB above which it may map allocations
+   * directly, as that threshold only grows at runtime. Allocations of at least that size, which
+   * may or may not be mapped, are left at `n`, as are all allocations elsewhere.
+   *
+   * This is only a request size: Containers allocate all of the elements returned, so if another
+   * `malloc` is interposed (while `__GLIBC__` is still defined), the estimate may waste a little
+   * memory, but is never relied upon to hold more than was requested.
+   */
+  [[nodiscard]] std::size_t usable_size(std::size_t n) const noexcept {
+#ifdef __GLIBC__
+    // The chunks have a header of one word and are aligned to 16 bytes, with a minimum of 32.
+    constexpr std::size_t word = sizeof(std::size_t);
+    constexpr std::size_t alignment = 2 * word;
+    if (n >= mmap_threshold / sizeof(T)) {
+      return n;
+    }
+    const std::size_t bytes = n * sizeof(T);
+    const std::size_t chunk = std::max((bytes + word + alignment - 1) / alignment * alignment,
+                                       std::size_t{4} * word);
+    return (chunk - word) / sizeof(T);
+#else
+    return n;
+#endif
+  }
+  /** Resize an allocation using `realloc`, returning `nullptr` if that fails. */
+  T* reallocate(T* p, std::size_t /*old_n*/, std::size_t new_n) noexcept {
+    if (new_n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      return nullptr;
+    }
+    return static_cast<T*>(std::realloc(p, new_n * sizeof(T))); // NOLINT(*-no-malloc,*-owning-*)
+  }
+
+  friend bool operator==(const MallocAllocator& /*a1*/, const MallocAllocator& /*a2*/) {
+    return true;
+  }
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_MEMORY_MALLOC_ALLOCATOR_HPP
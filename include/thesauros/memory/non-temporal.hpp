@@ -0,0 +1,70 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_MEMORY_NON_TEMPORAL_HPP
+#define INCLUDE_THESAUROS_MEMORY_NON_TEMPORAL_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include "thesauros/macropolis/platform.hpp"
+
+#if THES_X86_64
+#include <emmintrin.h>
+#endif
+
+namespace thes {
+/**
+ * Fill the uninitialized range `[begin, end)` with copies of `value` using non-temporal stores
+ * where available, i.e. on x86-64 if the size of `T` divides 16 bytes.
+ *
+ * Non-temporal stores bypass the caches, which avoids reading each cache line before it is
+ * overwritten and evicting data that is still needed, but only pays off for ranges much larger
+ * than the caches. The stores are fenced before returning, so that they are ordered before any
+ * later store, such as the one signalling completion to another thread.
+ */
+template<typename T>
+requires(std::is_trivially_copyable_v<T>)
+inline void non_temporal_fill(T* begin, T* end, const T& value) {
+#if THES_X86_64
+  constexpr std::size_t vector_size = 16;
+  constexpr std::size_t per_vector = vector_size / sizeof(T);
+  const auto address = [](const T* p) {
+    return reinterpret_cast<std::uintptr_t>(p); // NOLINT(*-reinterpret-cast)
+  };
+  if constexpr (vector_size % sizeof(T) == 0) {
+    // Only elements aligned to their size can reach an address aligned to the vector size.
+    if (address(begin) % sizeof(T) == 0) {
+      T* it = begin;
+      while (it != end && address(it) % vector_size != 0) {
+        std::construct_at(it++, value);
+      }
+
+      std::array<std::byte, vector_size> pattern{};
+      for (std::size_t i = 0; i < per_vector; ++i) {
+        std::memcpy(pattern.data() + i * sizeof(T), &value, sizeof(T));
+      }
+      // NOLINTNEXTLINE(*-reinterpret-cast)
+      const __m128i vector = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern.data()));
+      for (; std::size_t(end - it) >= per_vector; it += per_vector) {
+        _mm_stream_si128(reinterpret_cast<__m128i*>(it), vector); // NOLINT(*-reinterpret-cast)
+      }
+      _mm_sfence();
+
+      std::uninitialized_fill(it, end, value);
+      return;
+    }
+  }
+#endif
+  std::uninitialized_fill(begin, end, value);
+}
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_MEMORY_NON_TEMPORAL_HPP
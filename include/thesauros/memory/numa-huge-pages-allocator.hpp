@@ -0,0 +1,138 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_MEMORY_NUMA_HUGE_PAGES_ALLOCATOR_HPP
+#define INCLUDE_THESAUROS_MEMORY_NUMA_HUGE_PAGES_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+
+#include "thesauros/macropolis/platform.hpp"
+#include "thesauros/math/arithmetic.hpp"
+#include "thesauros/memory/huge-pages-allocator.hpp"
+#include "thesauros/types/primitives.hpp"
+
+#if THES_LINUX
+#include <limits>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace thes {
+/** How `NumaHugePagesAllocator` places the pages of an allocation on the NUMA nodes. */
+enum struct NumaPlacement : u8 {
+  /** Each page is placed on the node of the thread that touches it first. */
+  first_touch,
+  /**
+   * Additionally, the pages are bound to that node using `mbind` before they are touched, so
+   * that they are not placed or migrated elsewhere later. This is only available on Linux and
+   * behaves like `first_touch` elsewhere.
+   */
+  bind,
+};
+
+/**
+ * An allocator which allocates like `HugePagesAllocator`, but faults the pages of each allocation
+ * in parallel using the execution policy `ExPo`, so that each page is placed on the NUMA node of
+ * the thread which is going to work on it.
+ *
+ * The pages are distributed over the threads by `execute_segmented` with the number of elements
+ * as the size, i.e. in the same way as a computation on the elements using the same execution
+ * policy, as long as the threads are pinned to their CPUs. Each huge page is touched by the
+ * thread whose segment contains the huge page’s first byte.
+ *
+ * Touching the pages writes to them, so that their previous contents are lost, which is of no
+ * concern for freshly allocated memory.
+ */
+template<typename T, typename ExPo>
+struct NumaHugePagesAllocator {
+  static constexpr std::size_t huge_page_size = HugePagesAllocator<T>::huge_page_size;
+  // The distance between touched addresses, so that each page is faulted in even if the system
+  // does not provide huge pages.
+  static constexpr std::size_t page_size = std::size_t{1} << 12U; // 4 KiB
+  using value_type = T;
+  using ExecutionPolicy = ExPo;
+
+  /** The allocator refers to `expo`, which therefore has to outlive it. */
+  explicit NumaHugePagesAllocator(const ExPo& expo,
+                                  NumaPlacement placement = NumaPlacement::first_touch)
+      : expo_(&expo), placement_(placement) {}
+  template<typename U>
+  NumaHugePagesAllocator(const NumaHugePagesAllocator<U, ExPo>& other) // NOLINT(*-explicit-*)
+      : expo_(&other.execution_policy()), placement_(other.placement()) {}
+
+  T* allocate(std::size_t n) {
+    T* p = HugePagesAllocator<T>{}.allocate(n);
+    if (p != nullptr) {
+      place(reinterpret_cast<std::byte*>(p), n); // NOLINT(*-reinterpret-cast)
+    }
+    return p;
+  }
+  void deallocate(T* p, std::size_t n) {
+    HugePagesAllocator<T>{}.deallocate(p, n);
+  }
+
+  [[nodiscard]] const ExPo& execution_policy() const {
+    return *expo_;
+  }
+  [[nodiscard]] NumaPlacement placement() const {
+    return placement_;
+  }
+
+  // All instances free memory in the same way, regardless of how it has been placed.
+  friend bool operator==(const NumaHugePagesAllocator& /*a1*/,
+                         const NumaHugePagesAllocator& /*a2*/) {
+    return true;
+  }
+
+private:
+  void place(std::byte* data, std::size_t n) const {
+    const std::size_t bytes = n * sizeof(T);
+    expo_->execute_segmented(n, [&](std::size_t /*thread_idx*/, auto begin, auto end) {
+      const std::size_t first = div_ceil(std::size_t(begin) * sizeof(T), huge_page_size);
+      const std::size_t last =
+        std::min(div_ceil(std::size_t(end) * sizeof(T), huge_page_size) * huge_page_size, bytes);
+      const std::size_t start = first * huge_page_size;
+      if (start >= last) {
+        return;
+      }
+#if THES_LINUX
+      if (placement_ == NumaPlacement::bind) {
+        bind_to_local_node(data + start, last - start);
+      }
+#endif
+      for (std::size_t offset = start; offset < last; offset += page_size) {
+        // `volatile` keeps the otherwise pointless store from being optimized away.
+        *static_cast<volatile std::byte*>(data + offset) = std::byte{0};
+      }
+    });
+  }
+
+#if THES_LINUX
+  /** Bind the given range to the NUMA node of the CPU the calling thread is running on. */
+  static void bind_to_local_node(std::byte* begin, std::size_t size) {
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+      return;
+    }
+    constexpr std::size_t bits = std::numeric_limits<unsigned long>::digits;
+    std::vector<unsigned long> mask(node / bits + 1, 0);
+    mask[node / bits] |= 1UL << (node % bits);
+    // As with `madvise` in `HugePagesAllocator`, failing only forgoes the optimization.
+    syscall(SYS_mbind, begin, size, MPOL_BIND, mask.data(), mask.size() * bits + 1, 0);
+  }
+#endif
+
+  const ExPo* expo_;
+  NumaPlacement placement_;
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_MEMORY_NUMA_HUGE_PAGES_ALLOCATOR_HPP
@@ -0,0 +1,368 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_MEMORY_SIZE_CLASS_POOL_HPP
+#define INCLUDE_THESAUROS_MEMORY_SIZE_CLASS_POOL_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "thesauros/containers/array/fixed.hpp"
+#include "thesauros/memory/cache-line.hpp"
+
+namespace thes {
+/** The allocation statistics of one size class of a `SizeClassPool`. */
+struct SizeClassStats {
+  std::size_t block_size;
+  /** The number of bytes in blocks handed out and not returned yet. */
+  std::size_t bytes_in_use;
+  std::size_t allocations;
+  /** The number of allocations served from a thread cache without new memory from the system. */
+  std::size_t cache_hits;
+  /** The number of blocks freed by a thread other than the one owning the cache. */
+  std::size_t remote_frees;
+
+  [[nodiscard]] double hit_rate() const {
+    return (allocations == 0) ? 1.0 : double(cache_hits) / double(allocations);
+  }
+};
+
+/**
+ * A thread-caching allocator for small blocks, with one cache per thread index of an executor,
+ * so that the tasks of a parallel region do not serialize on the global allocator.
+ *
+ * Requests are rounded up to a power-of-two size class between `min_block_size` and
+ * `max_block_size`, and each cache keeps one free list per size class, which is refilled from
+ * slabs of `slab_size` bytes. Larger requests are forwarded to `operator new`.
+ *
+ * Each cache belongs to the first thread that allocates from it, and only that thread ever
+ * allocates from it. The thread index passed to `allocate` is a hint: If its cache belongs to
+ * another thread, the calling thread uses the cache it owns already or claims one without an
+ * owner, and if all caches belong to other threads, `allocate` throws `std::logic_error`. A pool
+ * with one cache per thread that uses it therefore works regardless of which thread runs which
+ * index. Only then does each index keep its own cache, which is the case for the indices of
+ * `FixedThreadPool::execute` as long as it is always called from the same thread, but not for
+ * those of `FixedThreadPool::submit`, which runs index 0 on the first worker thread, nor for the
+ * jobs of `fork_join`, which may be stolen by a thread serving another index.
+ *
+ * As the owner never changes, a thread can tell from it whether a block it frees goes to its own
+ * cache, in which case it is pushed onto the free list directly. A block freed by any other thread
+ * is pushed onto a lock-free list of the cache, from which the owner reclaims it on its next
+ * refill. The slabs are only returned to the system when the pool is destroyed, which allows
+ * blocks to move freely between the caches.
+ *
+ * `SizeClassAllocator` provides the interface used by the containers, e.g. `DynamicArray`.
+ */
+struct SizeClassPool {
+  static constexpr std::size_t min_block_size = 16;
+  static constexpr std::size_t max_block_size = std::size_t{1} << 13U; // 8 KiB
+  static constexpr std::size_t class_num =
+    std::size_t(std::countr_zero(max_block_size) - std::countr_zero(min_block_size)) + 1;
+  static constexpr std::size_t slab_size = std::size_t{1} << 16U; // 64 KiB
+
+  using Stats = std::array<SizeClassStats, class_num>;
+
+  explicit SizeClassPool(std::size_t thread_num) : caches_(thread_num) {}
+
+  SizeClassPool(const SizeClassPool&) = delete;
+  SizeClassPool(SizeClassPool&&) = delete;
+  SizeClassPool& operator=(const SizeClassPool&) = delete;
+  SizeClassPool& operator=(SizeClassPool&&) = delete;
+
+  ~SizeClassPool() {
+    for (const CacheAligned<Cache>& cache : caches_) {
+      for (const Slab& slab : cache.value.slabs) {
+        ::operator delete(slab.data, std::align_val_t{slab.alignment});
+      }
+    }
+  }
+
+  [[nodiscard]] std::size_t thread_num() const {
+    return caches_.size();
+  }
+
+  /**
+   * Allocate `size` bytes aligned to `alignment` from the cache of the calling thread, which is
+   * that of `thread_index` unless it belongs to another thread.
+   *
+   * @throws std::logic_error if all caches belong to other threads.
+   */
+  [[nodiscard]] void* allocate(std::size_t thread_index, std::size_t size, std::size_t alignment) {
+    assert(thread_index < caches_.size());
+    const std::size_t cls = size_class(size, alignment);
+    if (cls == class_num) {
+      return ::operator new(size, std::align_val_t{alignment});
+    }
+
+    Cache& cache = own_cache(thread_index);
+    ClassCache& cc = cache.classes[cls];
+    if (cc.free == nullptr) {
+      reclaim(cache);
+    }
+    if (cc.free != nullptr) {
+      ++cc.cache_hits;
+    } else {
+      carve(cache, cls);
+    }
+    ++cc.allocations;
+    ++cc.in_use;
+    FreeNode* node = cc.free;
+    cc.free = node->next;
+    return node;
+  }
+
+  /**
+   * Return a block of `size` bytes aligned to `alignment` to the cache of `thread_index`, which
+   * may be called from any thread.
+   */
+  void deallocate(std::size_t thread_index, void* p, std::size_t size,
+                  std::size_t alignment) noexcept {
+    assert(thread_index < caches_.size());
+    const std::size_t cls = size_class(size, alignment);
+    if (cls == class_num) {
+      ::operator delete(p, std::align_val_t{alignment});
+      return;
+    }
+
+    Cache& cache = caches_[thread_index].value;
+    auto* node = static_cast<FreeNode*>(p);
+    // The owner is set by the first allocation and never changes, so this cannot race with it.
+    if (cache.owner.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+      ClassCache& cc = cache.classes[cls];
+      node->next = cc.free;
+      cc.free = node;
+      --cc.in_use;
+      return;
+    }
+
+    node->size_class = cls;
+    cache.remote_frees[cls].fetch_add(1, std::memory_order_relaxed);
+    FreeNode* head = cache.remote.load(std::memory_order_relaxed);
+    do {
+      node->next = head;
+    } while (!cache.remote.compare_exchange_weak(head, node, std::memory_order_release,
+                                                 std::memory_order_relaxed));
+  }
+
+  /**
+   * The statistics of the cache of `thread_index`, which must not be called while the owner of
+   * the cache allocates or deallocates.
+   *
+   * Blocks are counted as in use by the cache they are returned to, so that `bytes_in_use` wraps
+   * around if more blocks allocated by other caches have been returned to this one than it has
+   * handed out itself. The sum over all caches is exact.
+   */
+  [[nodiscard]] Stats stats(std::size_t thread_index) const {
+    Stats stats{};
+    const Cache& cache = caches_[thread_index].value;
+    for (std::size_t cls = 0; cls < class_num; ++cls) {
+      const ClassCache& cc = cache.classes[cls];
+      const std::size_t remote_frees = cache.remote_frees[cls].load(std::memory_order_relaxed);
+      stats[cls] = SizeClassStats{
+        .block_size = block_size(cls),
+        .bytes_in_use = (cc.in_use - remote_frees) * block_size(cls),
+        .allocations = cc.allocations,
+        .cache_hits = cc.cache_hits,
+        .remote_frees = remote_frees,
+      };
+    }
+    return stats;
+  }
+  /** The statistics of all caches combined, which must not be called while any of them is used. */
+  [[nodiscard]] Stats stats() const {
+    Stats stats{};
+    for (std::size_t cls = 0; cls < class_num; ++cls) {
+      stats[cls].block_size = block_size(cls);
+    }
+    for (std::size_t i = 0; i < caches_.size(); ++i) {
+      const Stats cache_stats = this->stats(i);
+      for (std::size_t cls = 0; cls < class_num; ++cls) {
+        stats[cls].bytes_in_use += cache_stats[cls].bytes_in_use;
+        stats[cls].allocations += cache_stats[cls].allocations;
+        stats[cls].cache_hits += cache_stats[cls].cache_hits;
+        stats[cls].remote_frees += cache_stats[cls].remote_frees;
+      }
+    }
+    return stats;
+  }
+
+  /** The size class of a request, which is `class_num` if it is forwarded to `operator new`. */
+  [[nodiscard]] static constexpr std::size_t size_class(std::size_t size, std::size_t alignment) {
+    // Blocks are aligned to their size, as the slabs are.
+    const std::size_t bytes = std::max({size, alignment, min_block_size});
+    if (bytes > max_block_size) {
+      return class_num;
+    }
+    return std::size_t(std::countr_zero(std::bit_ceil(bytes)) - std::countr_zero(min_block_size));
+  }
+  [[nodiscard]] static constexpr std::size_t block_size(std::size_t size_class) {
+    return min_block_size << size_class;
+  }
+
+private:
+  struct FreeNode {
+    FreeNode* next;
+    // Only set for blocks on the remote list, which holds blocks of all classes.
+    std::size_t size_class;
+  };
+  static_assert(sizeof(FreeNode) <= min_block_size);
+
+  struct ClassCache {
+    FreeNode* free{nullptr};
+    // The number of blocks allocated minus those returned to this cache by its owner, which wraps
+    // around if blocks allocated elsewhere are returned here.
+    std::size_t in_use{0};
+    std::size_t allocations{0};
+    std::size_t cache_hits{0};
+  };
+  struct Slab {
+    void* data;
+    std::size_t alignment;
+  };
+  struct Cache {
+    std::array<ClassCache, class_num> classes{};
+    std::vector<Slab> slabs{};
+    // Set by the first allocation and never changed afterwards.
+    std::atomic<std::thread::id> owner{};
+    // Written by other threads, so it is kept on a cache line of its own.
+    alignas(cache_line_bytes) std::atomic<FreeNode*> remote{nullptr};
+    std::array<std::atomic<std::size_t>, class_num> remote_frees{};
+  };
+
+  /** Whether `self` owns `cache`, making it the owner if the cache has none yet. */
+  static bool claim(Cache& cache, std::thread::id self) {
+    std::thread::id owner = cache.owner.load(std::memory_order_relaxed);
+    if (owner == std::thread::id{} &&
+        cache.owner.compare_exchange_strong(owner, self, std::memory_order_relaxed)) {
+      return true;
+    }
+    return owner == self;
+  }
+
+  /** The cache of the calling thread, preferring that of `thread_index`. */
+  Cache& own_cache(std::size_t thread_index) {
+    const std::thread::id self = std::this_thread::get_id();
+    if (Cache& cache = caches_[thread_index].value; claim(cache, self)) {
+      return cache;
+    }
+    // The index is served by another thread than before, e.g. in a submitted region.
+    for (CacheAligned<Cache>& cache : caches_) {
+      if (cache.value.owner.load(std::memory_order_relaxed) == self) {
+        return cache.value;
+      }
+    }
+    for (CacheAligned<Cache>& cache : caches_) {
+      if (claim(cache.value, self)) {
+        return cache.value;
+      }
+    }
+    throw std::logic_error{"All caches of the SizeClassPool belong to other threads!"};
+  }
+
+  /** Move the blocks freed by other threads to the free lists of `cache`. */
+  static void reclaim(Cache& cache) {
+    if (cache.remote.load(std::memory_order_relaxed) == nullptr) {
+      return;
+    }
+    FreeNode* node = cache.remote.exchange(nullptr, std::memory_order_acquire);
+    while (node != nullptr) {
+      FreeNode* next = node->next;
+      ClassCache& cc = cache.classes[node->size_class];
+      node->next = cc.free;
+      cc.free = node;
+      node = next;
+    }
+  }
+
+  /** Split a new slab into blocks of the given size class. */
+  static void carve(Cache& cache, std::size_t cls) {
+    const std::size_t size = block_size(cls);
+    void* data = ::operator new(slab_size, std::align_val_t{size});
+    cache.slabs.push_back(Slab{.data = data, .alignment = size});
+
+    ClassCache& cc = cache.classes[cls];
+    auto* bytes = static_cast<std::byte*>(data);
+    for (std::size_t offset = slab_size; offset >= size; offset -= size) {
+      auto* node = new (bytes + offset - size) FreeNode{.next = cc.free, .size_class = cls};
+      cc.free = node;
+    }
+  }
+
+  FixedArray<CacheAligned<Cache>> caches_;
+};
+
+/**
+ * An allocator for use as the `Alloc` parameter of containers such as `DynamicArray`, which
+ * allocates from the cache of the given thread index of a `SizeClassPool`.
+ *
+ * Within a parallel region, each task should use the thread index it has been passed by the
+ * executor, e.g. `SizeClassAllocator<T>{pool, thread_idx}`, which keeps the caches apart if each
+ * index is always served by the same thread. Containers may grow and be destroyed on any thread.
+ *
+ * A default-constructed allocator has no pool and forwards to `operator new`, which lets
+ * containers be default-constructed, e.g. those built internally by `NestedDynamicArray`, and
+ * receive an allocator with a pool by assignment later.
+ */
+template<typename T>
+struct SizeClassAllocator {
+  using value_type = T;
+
+  SizeClassAllocator() noexcept = default;
+  SizeClassAllocator(SizeClassPool& pool, std::size_t thread_index) noexcept
+      : pool_(&pool), thread_index_(thread_index) {}
+  template<typename U>
+  SizeClassAllocator(const SizeClassAllocator<U>& other) noexcept // NOLINT(*-explicit-*)
+      : pool_(other.pool_), thread_index_(other.thread_index_) {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc{};
+    }
+    if (pool_ == nullptr) {
+      return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{alignof(T)}));
+    }
+    return static_cast<T*>(pool_->allocate(thread_index_, n * sizeof(T), alignof(T)));
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    if (pool_ == nullptr) {
+      ::operator delete(p, std::align_val_t{alignof(T)});
+      return;
+    }
+    pool_->deallocate(thread_index_, p, n * sizeof(T), alignof(T));
+  }
+
+  /** The pool allocated from, which is `nullptr` for a default-constructed allocator. */
+  [[nodiscard]] SizeClassPool* pool() const noexcept {
+    return pool_;
+  }
+  [[nodiscard]] std::size_t thread_index() const noexcept {
+    return thread_index_;
+  }
+
+  // Blocks can be returned to any cache, so only the pool matters.
+  friend bool operator==(const SizeClassAllocator& a1, const SizeClassAllocator& a2) noexcept {
+    return a1.pool_ == a2.pool_;
+  }
+
+private:
+  template<typename U>
+  friend struct SizeClassAllocator;
+
+  SizeClassPool* pool_{nullptr};
+  std::size_t thread_index_{0};
+};
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_MEMORY_SIZE_CLASS_POOL_HPP
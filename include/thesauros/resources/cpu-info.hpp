@@ -21,7 +21,9 @@
 #include <algorithm>
 #include <filesystem>
 #include <stdexcept>
+#include <string>
 #include <string_view>
+#include <system_error>
 #include <utility>
 #include <vector>
 
@@ -41,6 +43,7 @@
 #elif THES_WINDOWS
 #include <memory>
 #include <set>
+#include <vector>
 
 #include <minwindef.h>
 #include <processthreadsapi.h>
@@ -83,6 +86,7 @@ struct CpuInfo {
   static constexpr auto cpu_path_cstr = "/sys/devices/system/cpu/";
   static constexpr auto cpu_atom_path_cstr = "/sys/devices/cpu_atom/cpus";
   static constexpr auto cpu_core_path_cstr = "/sys/devices/cpu_core/cpus";
+  static constexpr auto node_path_cstr = "/sys/devices/system/node/";
 
   static constexpr auto physical_filter =
     std::views::filter([](const auto& cpu) { return cpu.id == std::ranges::min(cpu.core_cpus()); });
@@ -99,6 +103,50 @@ struct CpuInfo {
     return cpu_range(read_file<DynamicArray<char>>(sys_folder() / "core_cpus_list"));
   }
 
+  /**
+   * The NUMA node this CPU belongs to, which sysfs exposes as a `nodeN` entry of the CPU’s folder,
+   * or 0 if the kernel has been built without NUMA support.
+   */
+  [[nodiscard]] std::size_t numa_node() const {
+    std::error_code ec{};
+    const auto cpu_folder = std::filesystem::path{cpu_path_cstr} / cat("cpu", id);
+    for (const auto& entry : std::filesystem::directory_iterator{cpu_folder, ec}) {
+      const std::string name = entry.path().filename().string();
+      if (!std::string_view{name}.starts_with("node")) {
+        continue;
+      }
+      if (const auto node = string_to_integral<std::size_t>(std::string_view{name}.substr(4))) {
+        return *node;
+      }
+    }
+    return 0;
+  }
+
+  /** The indices of the online NUMA nodes, which is just node 0 without NUMA support. */
+  static std::vector<std::size_t> numa_nodes() {
+    const auto online_path = std::filesystem::path{node_path_cstr} / "online";
+    if (!std::filesystem::exists(online_path)) {
+      return {0};
+    }
+    return std::ranges::to<std::vector<std::size_t>>(
+      cpu_range(read_file<DynamicArray<char>>(online_path)));
+  }
+
+  /** The number of online NUMA nodes. */
+  static std::size_t num_numa_nodes() {
+    return numa_nodes().size();
+  }
+
+  /** A view over the logical CPUs of the given NUMA node. */
+  static auto numa_node_cpus(std::size_t node) {
+    const auto node_path = std::filesystem::path{node_path_cstr} / cat("node", node) / "cpulist";
+    const auto cpus_path = (node == 0 && !std::filesystem::exists(node_path))
+                             ? std::filesystem::path{cpu_path_cstr} / "present"
+                             : node_path;
+    return cpu_range(read_file<DynamicArray<char>>(cpus_path)) |
+           std::views::transform([](std::size_t i) { return CpuInfo{.id = i}; });
+  }
+
   /** A view over all logical CPUs. */
   static auto logical() {
     const auto present_path = std::filesystem::path{cpu_path_cstr} / "present";
@@ -322,6 +370,26 @@ struct CpuInfo {
   std::size_t id;
   EfficiencyClass efficiency_class = EfficiencyClass::any;
 
+  /** The NUMA node of the CPU, which is always 0, as Apple systems have uniform memory access. */
+  [[nodiscard]] static std::size_t numa_node() {
+    return 0;
+  }
+
+  /** The indices of the NUMA nodes, of which there is only one. */
+  static std::vector<std::size_t> numa_nodes() {
+    return {0};
+  }
+
+  /** The number of NUMA nodes, which is always one. */
+  static std::size_t num_numa_nodes() {
+    return 1;
+  }
+
+  /** The logical CPUs of the given NUMA node, i.e. all of them for node 0 and none otherwise. */
+  static std::vector<CpuInfo> numa_node_cpus(std::size_t node) {
+    return (node == 0) ? logical() : std::vector<CpuInfo>{};
+  }
+
   /** All logical CPUs. */
   static std::vector<CpuInfo> logical() {
 #if THES_USE_IOKIT
@@ -496,6 +564,32 @@ struct CpuInfo {
   BYTE scheduling_class;
   DWORD64 allocation_tag;
 
+  /** The NUMA node this CPU belongs to. */
+  [[nodiscard]] std::size_t numa_node() const {
+    return numa_node_index;
+  }
+
+  /** The indices of the NUMA nodes with logical CPUs visible to the current process. */
+  static std::vector<std::size_t> numa_nodes() {
+    std::set<std::size_t> nodes{};
+    for (const CpuInfo& info : logical()) {
+      nodes.emplace(info.numa_node());
+    }
+    return {nodes.begin(), nodes.end()};
+  }
+
+  /** The number of NUMA nodes with logical CPUs visible to the current process. */
+  static std::size_t num_numa_nodes() {
+    return numa_nodes().size();
+  }
+
+  /** A view over the logical CPUs of the given NUMA node. */
+  static auto numa_node_cpus(std::size_t node) {
+    return logical() | std::views::filter([node](const CpuInfo& info) {
+             return info.numa_node() == node;
+           });
+  }
+
   /** All logical CPUs visible to the current process. */
   static std::vector<CpuInfo> logical() {
     // Based on https://github.com/GameTechDev/HybridDetect
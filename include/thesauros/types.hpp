@@ -7,6 +7,7 @@
 #include "types/numeric-info.hpp"
 #include "types/primitives.hpp"
 #include "types/signedness.hpp"
+#include "types/trivially-relocatable.hpp"
 #include "types/tuple.hpp"
 #include "types/type-name.hpp"
 #include "types/type-sequence.hpp"
@@ -0,0 +1,27 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#ifndef INCLUDE_THESAUROS_TYPES_TRIVIALLY_RELOCATABLE_HPP
+#define INCLUDE_THESAUROS_TYPES_TRIVIALLY_RELOCATABLE_HPP
+
+#include <type_traits>
+
+namespace thes {
+/**
+ * Whether an object of type `T` can be relocated, i.e. moved to another address while ending the
+ * lifetime of the original, by copying its bytes, which allows containers to grow without moving
+ * and destroying their elements one by one.
+ *
+ * This holds for all trivially copyable types. The trait can be specialized for other types that
+ * do not refer to their own address, e.g. ones owning heap memory through a pointer.
+ */
+template<typename T>
+struct IsTriviallyRelocatableTrait : public std::bool_constant<std::is_trivially_copyable_v<T>> {};
+template<typename T>
+concept TriviallyRelocatable = IsTriviallyRelocatableTrait<T>::value;
+} // namespace thes
+
+#endif // INCLUDE_THESAUROS_TYPES_TRIVIALLY_RELOCATABLE_HPP
@@ -0,0 +1,59 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "thesauros/algorithms/crc32c.hpp"
+#include "thesauros/test/test.hpp"
+
+namespace {
+constexpr auto to_bytes(std::string_view str) {
+  std::array<std::byte, 9> out{};
+  for (std::size_t i = 0; i < str.size(); ++i) {
+    out[i] = std::byte(str[i]);
+  }
+  return out;
+}
+
+// The check value of CRC-32C.
+static_assert(thes::crc32c(to_bytes("123456789")) == 0xE3069283U);
+
+THES_TEST_CASE("CRC-32C matches the reference values", "[algorithms][crc32c]") {
+  THES_CHECK(thes::crc32c(to_bytes("123456789")) == 0xE3069283U);
+  THES_CHECK(thes::crc32c({}) == 0);
+
+  // The test vectors from RFC 3720, section B.4.
+  const std::vector<std::byte> zeros(32, std::byte{0x00});
+  THES_CHECK(thes::crc32c(zeros) == 0x8A9136AAU);
+  const std::vector<std::byte> ones(32, std::byte{0xFF});
+  THES_CHECK(thes::crc32c(ones) == 0x62A8AB43U);
+  std::vector<std::byte> ascending(32);
+  for (std::size_t i = 0; i < ascending.size(); ++i) {
+    ascending[i] = std::byte(i);
+  }
+  THES_CHECK(thes::crc32c(ascending) == 0x46DD794EU);
+}
+
+THES_TEST_CASE("CRC-32C continues a previous checksum", "[algorithms][crc32c]") {
+  std::vector<std::byte> data(10007);
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i] = std::byte((i * 131) ^ (i >> 5U));
+  }
+  const std::span<const std::byte> span{data};
+
+  const auto full = thes::crc32c(span);
+  for (const std::size_t split : {0UZ, 1UZ, 7UZ, 4096UZ, 10007UZ}) {
+    const auto head = thes::crc32c(span.first(split));
+    THES_CHECK(thes::crc32c(span.subspan(split), head) == full);
+  }
+}
+} // namespace
+
+THES_TEST_MAIN()
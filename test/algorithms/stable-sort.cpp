@@ -0,0 +1,74 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "thesauros/algorithms/stable-sort.hpp"
+#include "thesauros/execution/execution-policy/linear.hpp"
+#include "thesauros/execution/execution-policy/work-stealing.hpp"
+#include "thesauros/execution/executor/fixed-thread-pool.hpp"
+#include "thesauros/test/test.hpp"
+
+namespace {
+// A key and the position it was generated at, which tells whether equal keys kept their order.
+using Entry = std::pair<int, std::size_t>;
+
+/** `size` entries with keys in `[0, key_num)`, so that many of them are equal. */
+[[nodiscard]] std::vector<Entry> random_entries(std::size_t size, int key_num) {
+  std::mt19937 rng{static_cast<std::mt19937::result_type>(size)};
+  std::uniform_int_distribution<int> dist{0, key_num - 1};
+  std::vector<Entry> entries{};
+  for (std::size_t i = 0; i < size; ++i) {
+    entries.emplace_back(dist(rng), i);
+  }
+  return entries;
+}
+
+/** Sorts random entries by key using `expo` and compares the result to `std::stable_sort`. */
+[[nodiscard]] bool sorts_like_std(const auto& expo, std::size_t size, int key_num) {
+  const auto by_key = [](const Entry& a, const Entry& b) { return a.first < b.first; };
+  std::vector<Entry> entries = random_entries(size, key_num);
+  std::vector<Entry> ref = entries;
+  std::stable_sort(ref.begin(), ref.end(), by_key);
+  thes::stable_sort(entries.begin(), entries.end(), expo, by_key);
+  return entries == ref;
+}
+
+//==================================================================================================
+// Execution policies
+//==================================================================================================
+
+/** Checks that equal keys keep their order with chunks of different sizes and counts. */
+THES_TEST_CASE("stable_sort matches std::stable_sort", "[algorithms][stable-sort]") {
+  for (const std::size_t thread_num : {1, 2, 3, 4, 7}) {
+    const thes::FixedThreadPool pool{thread_num};
+    for (const std::size_t size : {0, 1, 2, 5, 100, 1000, 40000}) {
+      THES_CHECK(sorts_like_std(thes::LinearExecutionPolicy{pool}, size, 10));
+      THES_CHECK(sorts_like_std(thes::WorkStealingExecutionPolicy{pool, 97}, size, 10));
+    }
+  }
+}
+
+/** Checks that a custom comparator is used for sorting and merging alike. */
+THES_TEST_CASE("stable_sort honours custom comparators", "[algorithms][stable-sort]") {
+  const thes::FixedThreadPool pool{3};
+  std::vector<int> values(5000);
+  std::iota(values.begin(), values.end(), 0);
+  std::shuffle(values.begin(), values.end(), std::mt19937{3});
+  thes::stable_sort(values.begin(), values.end(), thes::LinearExecutionPolicy{pool},
+                    std::greater<>{});
+  THES_CHECK(std::ranges::is_sorted(values, std::greater<>{}));
+  THES_CHECK(values.front() == 4999 && values.back() == 0);
+}
+} // namespace
+
+THES_TEST_MAIN()
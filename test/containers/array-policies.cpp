@@ -10,11 +10,18 @@
 #include <cstring>
 #include <memory>
 
+#include "thesauros/containers/array/dynamic.hpp"
 #include "thesauros/containers/array/growth-policy.hpp"
 #include "thesauros/containers/array/initialization-policy.hpp"
+#include "thesauros/memory/huge-pages-allocator.hpp"
+#include "thesauros/memory/malloc-allocator.hpp"
 #include "thesauros/test/test.hpp"
 #include "thesauros/types/numeric-info.hpp"
 
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#include <malloc.h>
+#endif
+
 namespace {
 //==================================================================================================
 // DoublingGrowth
@@ -59,6 +66,119 @@ THES_TEST_CASE("DoublingGrowth saturates near the maximum", "[containers][growth
   THES_CHECK(thes::DoublingGrowth::new_allocation_size(0, huge - 1) == huge);
 }
 
+//==================================================================================================
+// Other growth policies
+//==================================================================================================
+
+using Alloc = std::allocator<double>;
+
+/** An allocator which reports that each allocation holds a multiple of 10 elements. */
+struct TensAllocator : public std::allocator<double> {
+  [[nodiscard]] static std::size_t usable_size(std::size_t n) {
+    return (n + 9) / 10 * 10;
+  }
+};
+
+template<typename GP>
+constexpr std::size_t grown(std::size_t old_size, std::size_t new_size_lower_bound) {
+  return thes::growth_allocation_size<GP, double>(old_size, new_size_lower_bound, Alloc{});
+}
+
+static_assert(grown<thes::DoublingGrowth>(4, 5) == 8);
+static_assert(grown<thes::OneAndHalfGrowth>(100, 101) == 150);
+static_assert(grown<thes::OneAndHalfGrowth>(100, 200) == 200);
+static_assert(grown<thes::OneAndHalfGrowth>(1, 2) == 2);
+
+/** Checks that 1.5x growth saturates instead of overflowing. */
+THES_TEST_CASE("ProportionalGrowth saturates near the maximum", "[containers][growth-policy]") {
+  using Info = thes::NumericInfo<std::size_t>;
+  const std::size_t large = Info::max / 2;
+  THES_CHECK(grown<thes::OneAndHalfGrowth>(large, large + 1) == large / 2 * 3);
+  THES_CHECK(grown<thes::OneAndHalfGrowth>(Info::max - 1, Info::max) == Info::max);
+}
+
+/** Checks that the allocations are rounded up to whole pages of the element type. */
+THES_TEST_CASE("PageRoundedGrowth fills the last page", "[containers][growth-policy]") {
+  // 8 doubles become 16, which are rounded up to the 512 doubles in a page of 4 KiB.
+  THES_CHECK(grown<thes::PageRoundedGrowth<>>(8, 9) == 512);
+  THES_CHECK(grown<thes::PageRoundedGrowth<>>(512, 513) == 1024);
+  THES_CHECK(grown<thes::HugePageRoundedGrowth<thes::OneAndHalfGrowth>>(1, 2) == (1U << 18U));
+
+  // Elements that do not divide the page size leave a remainder.
+  constexpr std::size_t size = thes::growth_allocation_size<thes::PageRoundedGrowth<>,
+                                                            std::array<char, 3>>(
+    8, 9, std::allocator<std::array<char, 3>>{});
+  THES_CHECK(size == 4096 / 3);
+}
+
+/** Checks that the growth is capped once the cap is below the growth of the base policy. */
+THES_TEST_CASE("CappedGrowth limits the increment", "[containers][growth-policy]") {
+  using Capped = thes::CappedGrowth<thes::DoublingGrowth, std::size_t{1} << 20U>;
+  constexpr std::size_t cap = (std::size_t{1} << 20U) / sizeof(double);
+  THES_CHECK(grown<Capped>(1000, 1001) == 1024);
+  THES_CHECK(grown<Capped>(cap * 4, cap * 4 + 1) == cap * 5);
+  // Larger requests are honoured nonetheless.
+  THES_CHECK(grown<Capped>(cap * 4, cap * 6) == cap * 6);
+
+  // 40 GiB of doubles only grow by the default cap of 1 GiB.
+  constexpr std::size_t size = (std::size_t{40} << 30U) / sizeof(double);
+  THES_CHECK(grown<thes::CappedGrowth<>>(size, size + 1) == size + (std::size_t{1} << 27U));
+}
+
+/** Checks that the usable size reported by the allocator is used. */
+THES_TEST_CASE("UsableSizeGrowth asks the allocator", "[containers][growth-policy]") {
+  using Usable = thes::UsableSizeGrowth<thes::OneAndHalfGrowth>;
+  const auto grown_tens = [](std::size_t old_size, std::size_t new_size_lower_bound) {
+    return thes::growth_allocation_size<Usable, double>(old_size, new_size_lower_bound,
+                                                        TensAllocator{});
+  };
+  THES_CHECK(grown_tens(100, 101) == 150);
+  THES_CHECK(grown_tens(10, 11) == 20);
+  // Allocators which cannot tell are left alone.
+  THES_CHECK(grown<Usable>(10, 11) == 15);
+
+  const thes::HugePagesAllocator<double> huge{};
+  THES_CHECK(huge.usable_size(10) == 10);
+
+  // With glibc, the usable size is what `malloc_usable_size` reports below the mapping threshold,
+  // unless AddressSanitizer replaces `malloc`.
+  using MallocAlloc = thes::MallocAllocator<char>;
+  MallocAlloc malloc_alloc{};
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+  for (std::size_t n = 0; n < MallocAlloc::mmap_threshold; n += 97) {
+    char* p = malloc_alloc.allocate(n);
+    THES_CHECK(malloc_alloc.usable_size(n) == malloc_usable_size(p));
+    malloc_alloc.deallocate(p, n);
+  }
+#endif
+  // Allocations which may be mapped directly are left alone, as the threshold for that varies.
+  for (const std::size_t n : {MallocAlloc::mmap_threshold, MallocAlloc::mmap_threshold + 1,
+                              std::size_t{1} << 20U, std::size_t{1} << 25U}) {
+    THES_CHECK(malloc_alloc.usable_size(n) == n);
+  }
+  using Large = std::array<char, std::size_t{1} << 18U>;
+  THES_CHECK(thes::MallocAllocator<Large>{}.usable_size(1) == 1);
+
+  // An array growing across the threshold keeps its elements.
+  thes::DynamicArray<std::size_t, thes::ValueInit, thes::UsableSizeGrowth<>,
+                     thes::MallocAllocator<std::size_t>>
+    malloc_array{};
+  for (std::size_t i = 0; i < MallocAlloc::mmap_threshold; ++i) {
+    malloc_array.push_back(i);
+    THES_REQUIRE(malloc_array.allocation_size() >= malloc_array.size());
+  }
+  for (std::size_t i = 0; i < malloc_array.size(); ++i) {
+    THES_CHECK(malloc_array[i] == i);
+  }
+
+  // A DynamicArray growing this way uses all of its memory.
+  thes::DynamicArray<double, thes::ValueInit, thes::UsableSizeGrowth<>, TensAllocator> array{};
+  array.push_back(1.0);
+  THES_CHECK(array.allocation_size() == 10);
+  array.resize(11);
+  THES_CHECK(array.allocation_size() == 20);
+}
+
 //==================================================================================================
 // Initialization policies
 //==================================================================================================
@@ -8,15 +8,22 @@
 #include <array>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "thesauros/containers.hpp"
+#include "thesauros/execution.hpp"
 #include "thesauros/format.hpp"
+#include "thesauros/macropolis/platform.hpp"
+#include "thesauros/memory.hpp"
 #include "thesauros/ranges.hpp"
 #include "thesauros/test.hpp"
+#include "thesauros/types/primitives.hpp"
 
 namespace test = thes::test;
 
@@ -55,6 +62,29 @@ struct fmt::formatter<S> : public fmt::nested_formatter<int> {
   }
 };
 
+/** An element type which is trivially relocatable, but not trivially copyable. */
+struct Relocatable {
+  explicit Relocatable(int v) : value(std::make_unique<int>(v)) {}
+
+  Relocatable(const Relocatable&) = delete;
+  Relocatable(Relocatable&&) = default;
+  Relocatable& operator=(const Relocatable&) = delete;
+  Relocatable& operator=(Relocatable&&) = default;
+
+  ~Relocatable() {
+    ++destructions();
+  }
+
+  std::unique_ptr<int> value;
+
+  static int& destructions() {
+    static int ctr{0};
+    return ctr;
+  }
+};
+template<>
+struct thes::IsTriviallyRelocatableTrait<Relocatable> : public std::true_type {};
+
 namespace {
 //==================================================================================================
 // Const-correctness of deducing-this accessors
@@ -451,6 +481,183 @@ THES_TEST_CASE("FixedArray: ADL swap exchanges contents", "[containers][array][f
   THES_CHECK(test::range_eq(b, std::array{1, 2, 3}));
 }
 
+//==================================================================================================
+// Parallel initialization
+//==================================================================================================
+
+using ParallelExPo = thes::LinearExecutionPolicy<thes::FixedThreadPool>;
+template<typename Base>
+using ParallelInit = thes::ParallelInit<Base, ParallelExPo>;
+
+THES_TEST_CASE("DynamicArray: parallel value-init construction, resize and fill",
+               "[containers][array][dynamic][parallel]") {
+  const thes::FixedThreadPool pool{3};
+  const ParallelExPo expo{pool};
+  const ParallelInit<thes::ValueInit> init{expo};
+
+  // Large enough for non-temporal stores, with a size that is not a multiple of the vector size.
+  constexpr std::size_t size = (std::size_t{1} << 18U) + 3;
+  thes::DynamicArray<double, ParallelInit<thes::ValueInit>> darray(size, init);
+  THES_REQUIRE(darray.size() == size);
+  THES_CHECK(std::ranges::all_of(darray, [](double v) { return v == 0.0; }));
+  THES_CHECK(darray.initialization_policy().execution_policy() == &expo);
+
+  std::ranges::fill(darray, 1.0);
+  darray.resize(3 * size);
+  const auto middle = darray.begin() + std::ptrdiff_t(size);
+  THES_CHECK(std::all_of(darray.begin(), middle, [](double v) { return v == 1.0; }));
+  THES_CHECK(std::all_of(middle, darray.end(), [](double v) { return v == 0.0; }));
+
+  const thes::DynamicArray<thes::u16, ParallelInit<thes::ValueInit>> filled(size, thes::u16{7},
+                                                                            init);
+  THES_CHECK(std::ranges::all_of(filled, [](thes::u16 v) { return v == 7; }));
+
+  // The policy is copied along with the array.
+  const auto copy = darray;
+  THES_CHECK(copy.initialization_policy().execution_policy() == &expo);
+}
+
+THES_TEST_CASE("FixedArray: parallel initialization of class-typed elements",
+               "[containers][array][fixed][parallel]") {
+  const thes::FixedThreadPool pool{2};
+  const ParallelExPo expo{pool};
+
+  const thes::FixedArray<std::string, ParallelInit<thes::DefaultInit>> strings(
+    1000, ParallelInit<thes::DefaultInit>{expo});
+  THES_CHECK(std::ranges::all_of(strings, [](const std::string& str) { return str.empty(); }));
+
+  const thes::FixedArray<std::string, ParallelInit<thes::DefaultInit>> filled(
+    1000, std::string{"abc"}, ParallelInit<thes::DefaultInit>{expo});
+  THES_CHECK(std::ranges::all_of(filled, [](const std::string& str) { return str == "abc"; }));
+
+  // Without an execution policy, the initialization is sequential.
+  const thes::FixedArray<int, ParallelInit<thes::ValueInit>> sequential(100);
+  THES_CHECK(std::ranges::all_of(sequential, [](int v) { return v == 0; }));
+}
+
+//==================================================================================================
+// Growth by relocation
+//==================================================================================================
+
+THES_TEST_CASE("DynamicArray: trivially relocatable elements are not destroyed when growing",
+               "[containers][array][dynamic]") {
+  Relocatable::destructions() = 0;
+  {
+    thes::DynamicArray<Relocatable> darray{};
+    for (int i = 0; i < 1000; ++i) {
+      darray.emplace_back(i);
+    }
+    THES_CHECK(Relocatable::destructions() == 0);
+    for (int i = 0; i < 1000; ++i) {
+      THES_CHECK(*darray[std::size_t(i)].value == i);
+    }
+  }
+  THES_CHECK(Relocatable::destructions() == 1000);
+}
+
+THES_TEST_CASE("DynamicArray: growth using realloc", "[containers][array][dynamic]") {
+  thes::DynamicArray<int, thes::ValueInit, thes::DoublingGrowth, thes::MallocAllocator<int>>
+    darray{};
+  for (int i = 0; i < 100000; ++i) {
+    darray.push_back(i);
+  }
+  darray.resize(200000);
+  for (std::size_t i = 0; i < darray.size(); ++i) {
+    THES_CHECK(darray[i] == ((i < 100000) ? int(i) : 0));
+  }
+
+  // The pushed element may be part of the array, including when the memory is reallocated.
+  thes::DynamicArray<int, thes::ValueInit, thes::DoublingGrowth, thes::MallocAllocator<int>>
+    copies{42};
+  while (copies.size() < 1000) {
+    copies.push_back(copies.back());
+  }
+  THES_CHECK(std::ranges::all_of(copies, [](int v) { return v == 42; }));
+}
+
+THES_TEST_CASE("HugePagesAllocator: growth by remapping", "[containers][array][dynamic]") {
+  using Alloc = thes::HugePagesAllocator<std::uint64_t>;
+  constexpr std::size_t page_elements = Alloc::huge_page_size / sizeof(std::uint64_t);
+  const auto is_aligned = [](const void* p) {
+    // NOLINTNEXTLINE(*-reinterpret-cast)
+    return reinterpret_cast<std::uintptr_t>(p) % Alloc::huge_page_size == 0;
+  };
+
+  Alloc alloc{};
+  std::uint64_t* p = alloc.allocate(page_elements + 1);
+  THES_REQUIRE(is_aligned(p));
+  for (std::size_t i = 0; i <= page_elements; ++i) {
+    p[i] = i;
+  }
+  std::uint64_t* q = alloc.reallocate(p, page_elements + 1, 8 * page_elements);
+#if THES_LINUX
+  THES_REQUIRE(q != nullptr);
+  THES_CHECK(is_aligned(q));
+  for (std::size_t i = 0; i <= page_elements; ++i) {
+    THES_CHECK(q[i] == i);
+  }
+  // The new memory can be written.
+  q[(8 * page_elements) - 1] = 1;
+  alloc.deallocate(q, 8 * page_elements);
+#else
+  THES_CHECK(q == nullptr);
+  alloc.deallocate(p, page_elements + 1);
+#endif
+
+  thes::DynamicArray<std::uint64_t, thes::ValueInit, thes::DoublingGrowth, Alloc> darray{};
+  for (std::uint64_t i = 0; i < 4 * page_elements; ++i) {
+    darray.push_back(i);
+  }
+  THES_CHECK(is_aligned(darray.data()));
+  for (std::size_t i = 0; i < darray.size(); ++i) {
+    THES_CHECK(darray[i] == i);
+  }
+}
+
+THES_TEST_CASE("HugePagesAllocator: freeing across the mapping threshold",
+               "[containers][array][dynamic]") {
+  using Alloc = thes::HugePagesAllocator<std::uint64_t>;
+  using Array =
+    thes::DynamicArray<std::uint64_t, thes::ValueInit, thes::UsableSizeGrowth<>, Alloc>;
+  constexpr std::size_t page_elements = Alloc::huge_page_size / sizeof(std::uint64_t);
+  const auto is_iota = [](const Array& array) {
+    for (std::size_t i = 0; i < array.size(); ++i) {
+      if (array[i] != i) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  Array darray{};
+  for (int round = 0; round < 3; ++round) {
+    // Start below the threshold and grow beyond it, which frees the small allocation.
+    for (std::uint64_t i = 0; i < 16; ++i) {
+      darray.push_back(i);
+    }
+    for (std::uint64_t i = 16; i < 2 * page_elements; ++i) {
+      darray.push_back(i);
+    }
+    THES_CHECK(is_iota(darray));
+
+    // Shrinking keeps the mapped allocation, which a copy then has as well.
+    darray.shrink(10);
+    THES_CHECK(is_iota(darray));
+    Array copy{darray};
+    THES_CHECK(copy == darray);
+    copy = Array{};
+    darray.clear_memory();
+    THES_CHECK(darray.empty());
+
+    // A copy of a large array is mapped as well.
+    Array large{};
+    large.resize(page_elements + 3);
+    darray = large;
+    THES_CHECK(darray.size() == page_elements + 3);
+    darray.clear_memory();
+  }
+}
+
 //==================================================================================================
 // FixedAllocArray
 //==================================================================================================
@@ -516,6 +723,134 @@ THES_TEST_CASE("FixedAllocArray: equality and ADL swap", "[containers][array][fi
   THES_CHECK(test::range_eq(c, std::array{1, 2, 3}));
 }
 
+//==================================================================================================
+// SmallDynamicArray
+//==================================================================================================
+
+template<typename T, typename IP = thes::DefaultInit>
+using SmallArray = thes::SmallDynamicArray<T, 4, IP>;
+
+/** Whether the elements of `array` are stored within the object. */
+template<typename TArray>
+bool stores_inline(const TArray& array) {
+  const auto* object = reinterpret_cast<const std::byte*>(&array); // NOLINT(*-reinterpret-cast)
+  const auto* data = reinterpret_cast<const std::byte*>(array.data()); // NOLINT(*-reinterpret-cast)
+  return object <= data && data < object + sizeof(TArray);
+}
+
+THES_TEST_CASE("SmallDynamicArray: const object yields const_iterator/const_reference",
+               "[containers][array][small-dynamic][const-correctness]") {
+  const SmallArray<int> sarray{1, 2, 3};
+  static_assert(std::same_as<decltype(sarray.begin()), SmallArray<int>::const_iterator>);
+  static_assert(std::same_as<decltype(sarray.front()), const int&>);
+  static_assert(std::same_as<decltype(sarray[0]), const int&>);
+  THES_CHECK(sarray.back() == 3);
+}
+
+THES_TEST_CASE("SmallDynamicArray: spills to the heap beyond the inline capacity",
+               "[containers][array][small-dynamic]") {
+  SmallArray<int, thes::ValueInit> sarray(3);
+  THES_CHECK(sarray.is_inline());
+  THES_CHECK(stores_inline(sarray));
+  THES_CHECK(test::range_eq(sarray, std::array{0, 0, 0}));
+
+  sarray.push_back(4);
+  THES_CHECK(sarray.is_inline());
+  THES_CHECK(sarray.allocation_size() == 4);
+
+  sarray.push_back(5);
+  THES_CHECK(!sarray.is_inline());
+  THES_CHECK(!stores_inline(sarray));
+  THES_CHECK(sarray.allocation_size() == 8);
+  THES_CHECK(test::range_eq(sarray, std::array{0, 0, 0, 4, 5}));
+
+  // The memory is kept when shrinking, until it is freed explicitly.
+  sarray.resize(2);
+  THES_CHECK(!sarray.is_inline());
+  sarray.clear_memory();
+  THES_CHECK(sarray.is_inline());
+  THES_CHECK(sarray.empty());
+
+  // Elements of the array itself can be appended.
+  sarray = SmallArray<int, thes::ValueInit>{1, 2, 3, 4};
+  sarray.push_back(sarray.front());
+  THES_CHECK(test::range_eq(sarray, std::array{1, 2, 3, 4, 1}));
+
+  sarray.resize(20);
+  THES_CHECK(sarray.size() == 20);
+  THES_CHECK(sarray[19] == 0);
+}
+
+THES_TEST_CASE("SmallDynamicArray: copy, move and swap in both storage modes",
+               "[containers][array][small-dynamic]") {
+  using Array = SmallArray<std::string>;
+  const Array small{"a", "b"};
+  const Array large{"a", "b", "c", "d", "e", "f"};
+
+  Array small_copy(small);
+  Array large_copy(large);
+  THES_CHECK(small_copy == small);
+  THES_CHECK(small_copy.is_inline());
+  THES_CHECK(large_copy == large);
+
+  Array small_moved(std::move(small_copy));
+  Array large_moved(std::move(large_copy));
+  THES_CHECK(small_moved == small);
+  THES_CHECK(large_moved == large);
+  THES_CHECK(small_copy.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+  THES_CHECK(large_copy.empty()); // NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+
+  swap(small_moved, large_moved);
+  THES_CHECK(small_moved == large);
+  THES_CHECK(large_moved == small);
+  THES_CHECK(large_moved.is_inline());
+
+  // Assigning a small array releases the memory.
+  small_moved = large_moved;
+  THES_CHECK(small_moved == small);
+  THES_CHECK(small_moved.is_inline());
+}
+
+THES_TEST_CASE("SmallDynamicArray: insert and erase across the inline capacity",
+               "[containers][array][small-dynamic]") {
+  SmallArray<std::string, thes::ValueInit> sarray{"a", "c"};
+  sarray.insert(sarray.begin() + 1, "b");
+  sarray.insert(sarray.end(), "d");
+  THES_CHECK(sarray.is_inline());
+  sarray.insert(sarray.begin(), "0");
+  THES_CHECK(!sarray.is_inline());
+  THES_CHECK(test::range_eq(sarray, std::array<std::string, 5>{"0", "a", "b", "c", "d"}));
+
+  auto it = sarray.insert_any(sarray.begin() + 1, 2, 1);
+  THES_CHECK(it == sarray.begin() + 1);
+  THES_CHECK(test::range_eq(
+    sarray, std::array<std::string, 8>{"0", "", "", "a", "b", "c", "d", ""}));
+
+  it = sarray.erase(sarray.begin() + 1, sarray.begin() + 3);
+  THES_CHECK(*it == "a");
+  sarray.erase(sarray.end() - 1);
+  THES_CHECK(test::range_eq(sarray, std::array<std::string, 5>{"0", "a", "b", "c", "d"}));
+}
+
+THES_TEST_CASE("SmallDynamicArray: no-init manual construction and value filling",
+               "[containers][array][small-dynamic]") {
+  for (const std::size_t size : {std::size_t{3}, std::size_t{6}}) {
+    SmallArray<std::string, thes::NoInit> sarray(size);
+    for (const auto i : thes::views::indices(size)) {
+      sarray.initial_emplace(i, 1, char('a' + i));
+    }
+    THES_CHECK(sarray.is_inline() == (size <= 4));
+    THES_CHECK(sarray[0] == "a" && sarray.back() == std::string(1, char('a' + size - 1)));
+    sarray.emplace_back("z");
+    THES_CHECK(sarray.size() == size + 1 && sarray.back() == "z");
+  }
+
+  const SmallArray<int> small(3, 7, thes::DefaultInit{});
+  const SmallArray<int> large(9, 7);
+  THES_CHECK(test::range_eq(small, std::array{7, 7, 7}));
+  THES_CHECK(large.size() == 9 && std::ranges::all_of(large, [](int v) { return v == 7; }));
+}
+
 //==================================================================================================
 // LimitedArray
 //==================================================================================================
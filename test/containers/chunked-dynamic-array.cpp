@@ -7,6 +7,7 @@
 #include <array>
 #include <cstddef>
 #include <iterator>
+#include <memory>
 
 #include "thesauros/containers.hpp"
 #include "thesauros/format.hpp"
@@ -435,6 +436,38 @@ THES_TEST_CASE("custom allocator", "[chunked][allocator]") {
     THES_CHECK(test::range_eq(arr[1], std::array{1, 2}));
   }
 }
+
+/** An allocator which reports that each allocation holds a multiple of 100 elements. */
+struct HundredsAllocator : public std::allocator<int> {
+  [[nodiscard]] static std::size_t usable_size(std::size_t n) {
+    return (n + 99) / 100 * 100;
+  }
+};
+
+/**
+ * Checks that the growth policy sees the values and the allocator rather than only the number of
+ * blocks: the first allocation holds 100 values, i.e. 12 blocks of 8 values, so that no further
+ * reallocation is needed until the 13th block.
+ */
+THES_TEST_CASE("growth policy sees the allocator", "[chunked][allocator]") {
+  using UsableChunked =
+    thes::ChunkedDynamicArrayBase<int, std::size_t, HundredsAllocator, std::allocator<std::size_t>,
+                                  thes::UsableSizeGrowth<>>;
+
+  UsableChunked arr{8, HundredsAllocator{}, std::allocator<std::size_t>{}};
+  arr.push_block();
+  arr[0].emplace_back(42);
+  const int* data = arr[0].span().data();
+  for ([[maybe_unused]] const auto i : thes::views::indices<std::size_t>(11)) {
+    arr.push_block();
+  }
+  THES_REQUIRE(arr.block_num() == 12);
+  THES_CHECK(arr[0].span().data() == data);
+
+  arr.push_block();
+  THES_REQUIRE(arr.block_num() == 13);
+  THES_CHECK(arr[0][0] == 42);
+}
 } // namespace
 
 THES_TEST_MAIN()
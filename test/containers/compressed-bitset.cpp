@@ -0,0 +1,173 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include "thesauros/containers/bitset/compressed.hpp"
+#include "thesauros/containers/bitset/set-bits.hpp"
+#include "thesauros/test/equality.hpp"
+#include "thesauros/test/test.hpp"
+
+namespace test = thes::test;
+
+namespace {
+using Bitset = thes::CompressedBitset;
+using Kind = thes::CompressedBlockKind;
+constexpr std::size_t block_bit_num = Bitset::block_bit_num;
+
+static_assert(std::ranges::random_access_range<const Bitset>);
+static_assert(std::ranges::sized_range<const Bitset>);
+
+/** A bitset and a reference `std::vector<bool>` which are modified together. */
+struct Checked {
+  explicit Checked(std::size_t size) : bitset{size}, ref(size, false) {}
+
+  void set(std::size_t i) {
+    bitset.set(i);
+    ref[i] = true;
+  }
+  void unset(std::size_t i) {
+    bitset.unset(i);
+    ref[i] = false;
+  }
+
+  [[nodiscard]] std::vector<std::size_t> ref_set_bits() const {
+    std::vector<std::size_t> out{};
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+      if (ref[i]) {
+        out.push_back(i);
+      }
+    }
+    return out;
+  }
+
+  /** Whether the bitset matches the reference, in every way of reading it. */
+  [[nodiscard]] bool valid() const {
+    const auto set_bits = ref_set_bits();
+    return test::range_eq(bitset, ref) && bitset.count() == set_bits.size() &&
+           test::range_eq(thes::views::set_bits(bitset), set_bits) &&
+           test::range_eq(thes::views::set_bits(bitset) | std::views::reverse,
+                          set_bits | std::views::reverse);
+  }
+
+  Bitset bitset;
+  std::vector<bool> ref;
+};
+
+/** A bitset with a sparse block, a dense block, a block with long runs and a full block. */
+Checked make_mixed() {
+  Checked checked{4 * block_bit_num + 100};
+  std::mt19937_64 rng{42};
+  for (int i = 0; i < 100; ++i) {
+    checked.set(rng() % block_bit_num);
+  }
+  for (int i = 0; i < 20000; ++i) {
+    checked.set(block_bit_num + rng() % block_bit_num);
+  }
+  for (std::size_t run = 0; run < 20; ++run) {
+    for (std::size_t i = 0; i < 1000; ++i) {
+      checked.set(2 * block_bit_num + 3000 * run + i);
+    }
+  }
+  for (std::size_t i = 4 * block_bit_num; i < checked.ref.size(); ++i) {
+    checked.set(i);
+  }
+  return checked;
+}
+
+THES_TEST_CASE("blocks switch between arrays and bitmaps", "[containers][compressed-bitset]") {
+  Checked checked{2 * block_bit_num};
+  THES_CHECK(checked.bitset.none());
+  THES_CHECK(checked.bitset.find_next(0) == checked.bitset.size());
+
+  for (std::size_t i = 0; i <= Bitset::array_max_size; ++i) {
+    checked.set(2 * i + 1);
+  }
+  THES_REQUIRE(checked.bitset.blocks().size() == 1);
+  THES_CHECK(checked.bitset.blocks()[0].kind == Kind::bitmap);
+  THES_CHECK(checked.valid());
+
+  checked.unset(1);
+  THES_CHECK(checked.bitset.blocks()[0].kind == Kind::array);
+  THES_CHECK(checked.valid());
+
+  // Blocks without set bits are dropped.
+  checked.set(block_bit_num + 7);
+  THES_CHECK(checked.bitset.blocks().size() == 2);
+  checked.unset(block_bit_num + 7);
+  THES_CHECK(checked.bitset.blocks().size() == 1);
+  THES_CHECK(checked.valid());
+}
+
+THES_TEST_CASE("optimize uses runs where they are smaller", "[containers][compressed-bitset]") {
+  Checked checked = make_mixed();
+  THES_CHECK(checked.valid());
+
+  const std::size_t bytes = checked.bitset.byte_size();
+  checked.bitset.optimize();
+  THES_CHECK(checked.bitset.byte_size() < bytes);
+  THES_CHECK(checked.valid());
+
+  const auto& blocks = checked.bitset.blocks();
+  THES_REQUIRE(blocks.size() == 4);
+  THES_CHECK(blocks[0].kind == Kind::array);
+  THES_CHECK(blocks[1].kind == Kind::bitmap);
+  THES_CHECK(blocks[2].kind == Kind::run);
+  THES_CHECK(blocks[3].kind == Kind::run);
+
+  // Modifying a run block turns it into an array or a bitmap.
+  checked.unset(2 * block_bit_num + 500);
+  checked.set(2 * block_bit_num + 1500);
+  checked.unset(4 * block_bit_num + 50);
+  THES_CHECK(blocks[2].kind != Kind::run);
+  THES_CHECK(blocks[3].kind != Kind::run);
+  THES_CHECK(checked.valid());
+}
+
+THES_TEST_CASE("union and intersection", "[containers][compressed-bitset]") {
+  Checked lhs = make_mixed();
+  Checked rhs{lhs.ref.size()};
+  for (std::size_t i = 0; i < rhs.ref.size(); i += 7) {
+    rhs.set(i);
+  }
+  for (const bool optimize : {false, true}) {
+    if (optimize) {
+      lhs.bitset.optimize();
+      rhs.bitset.optimize();
+    }
+
+    Checked united{lhs.ref.size()};
+    Checked intersected{lhs.ref.size()};
+    united.bitset = lhs.bitset | rhs.bitset;
+    intersected.bitset = lhs.bitset & rhs.bitset;
+    for (std::size_t i = 0; i < lhs.ref.size(); ++i) {
+      united.ref[i] = lhs.ref[i] || rhs.ref[i];
+      intersected.ref[i] = lhs.ref[i] && rhs.ref[i];
+    }
+    THES_CHECK(united.valid());
+    THES_CHECK(intersected.valid());
+  }
+}
+
+THES_TEST_CASE("push_back and search", "[containers][compressed-bitset]") {
+  Bitset bitset{};
+  for (std::size_t i = 0; i < 3 * block_bit_num; ++i) {
+    bitset.push_back(i % block_bit_num == 17);
+  }
+  THES_CHECK(bitset.size() == 3 * block_bit_num && bitset.count() == 3);
+  THES_CHECK(bitset.find_next(18) == block_bit_num + 17);
+  THES_CHECK(bitset.find_prev(block_bit_num + 16) == 17);
+  THES_CHECK(bitset.find_prev(16) == bitset.size());
+
+  bitset.clear();
+  THES_CHECK(bitset.empty() && bitset.none());
+}
+} // namespace
+
+THES_TEST_MAIN()
@@ -9,12 +9,16 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iterator>
 #include <ranges>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "thesauros/containers.hpp"
+#include "thesauros/execution.hpp"
+#include "thesauros/functional.hpp"
 #include "thesauros/ranges.hpp"
 #include "thesauros/test.hpp"
 
@@ -347,6 +351,146 @@ void test_different_chunk_types() {
   }
 }
 
+//--------------------------------------------------------------------------------------------------
+// Bulk operations
+//--------------------------------------------------------------------------------------------------
+
+/** A bitset of `size` bits in which every bit whose index satisfies `pred` is set. */
+thes::DynamicBitset<std::uint64_t> make_bitset(std::size_t size, auto pred) {
+  thes::DynamicBitset<std::uint64_t> b{size, false};
+  for (const auto i : thes::views::indices(size)) {
+    if (pred(i)) {
+      b.set(i);
+    }
+  }
+  return b;
+}
+
+std::size_t count_ref(const auto& b, std::size_t begin, std::size_t end) {
+  std::size_t out = 0;
+  for (std::size_t i = begin; i < end; ++i) {
+    out += b.get(i) ? 1 : 0;
+  }
+  return out;
+}
+
+void test_count() {
+  // Large enough to cover the vectorized popcount, with a partial last chunk.
+  static constexpr std::size_t size = 5000;
+  const auto b = make_bitset(size, [](std::size_t i) { return i % 3 == 0 || i % 7 == 2; });
+  THES_ALWAYS_ASSERT(b.count() == count_ref(b, 0, size));
+
+  using Range = std::pair<std::size_t, std::size_t>;
+  for (const auto& [begin, end] : {Range{0, 0}, Range{3, 9}, Range{60, 70}, Range{64, 128},
+                                   Range{1, 4999}, Range{100, 4100}, Range{4990, 5000}}) {
+    THES_ALWAYS_ASSERT(b.count(begin, end) == count_ref(b, begin, end));
+  }
+
+  // The bits beyond the size are ignored, even though `fill` sets them.
+  thes::DynamicBitset<std::uint32_t> filled{40};
+  filled.fill(true);
+  THES_ALWAYS_ASSERT(filled.count() == 40);
+  filled.unset(39);
+  THES_ALWAYS_ASSERT(filled.count() == 39 && filled.count(32, 39) == 7);
+
+  const thes::FixedThreadPool pool{3};
+  const thes::LinearExecutionPolicy linear{pool};
+  THES_ALWAYS_ASSERT(b.count(linear) == b.count());
+  const thes::WorkStealingExecutionPolicy stealing{pool, 4};
+  THES_ALWAYS_ASSERT(b.count(stealing) == b.count());
+}
+
+void test_any_none_all() {
+  thes::DynamicBitset<std::uint32_t> b{100, false};
+  THES_ALWAYS_ASSERT(b.none() && !b.any() && !b.all());
+  b.set(70);
+  THES_ALWAYS_ASSERT(b.any() && b.any(64, 71) && b.none(0, 70) && b.none(71, 100));
+
+  b.fill(10, 90, true);
+  THES_ALWAYS_ASSERT(b.count() == 80 && b.all(10, 90) && !b.all(9, 90) && !b.all(10, 91));
+  THES_ALWAYS_ASSERT(b.none(0, 10) && b.none(90, 100));
+  b.fill(33, 35, false);
+  THES_ALWAYS_ASSERT(b.count() == 78 && b.none(33, 35) && b.get(32) && b.get(35));
+  THES_ALWAYS_ASSERT(b.all(0, 0) && b.none(50, 50));
+
+  b.fill(true);
+  THES_ALWAYS_ASSERT(b.all() && b.count() == 100);
+}
+
+void test_combine() {
+  static constexpr std::size_t size = 1000;
+  const auto lhs = make_bitset(size, [](std::size_t i) { return i % 2 == 0; });
+  const auto rhs = make_bitset(size, [](std::size_t i) { return i % 3 == 0; });
+
+  auto check = [&](const auto& b, auto op) {
+    for (const auto i : thes::views::indices(size)) {
+      THES_ALWAYS_ASSERT(b.get(i) == op(lhs.get(i), rhs.get(i)));
+    }
+  };
+
+  auto b_and = lhs;
+  b_and &= rhs;
+  check(b_and, [](bool a, bool b) { return a && b; });
+  auto b_or = lhs;
+  b_or |= rhs;
+  check(b_or, [](bool a, bool b) { return a || b; });
+  auto b_xor = lhs;
+  b_xor ^= rhs;
+  check(b_xor, [](bool a, bool b) { return a != b; });
+  auto b_and_not = lhs;
+  b_and_not.and_not(rhs);
+  check(b_and_not, [](bool a, bool b) { return a && !b; });
+
+  // Only the bits in the range are combined.
+  auto ranged = lhs;
+  ranged.combine(rhs, std::bit_or<>{}, 37, 555);
+  for (const auto i : thes::views::indices(size)) {
+    const bool in_range = i >= 37 && i < 555;
+    THES_ALWAYS_ASSERT(ranged.get(i) == (lhs.get(i) || (in_range && rhs.get(i))));
+  }
+
+  const thes::FixedThreadPool pool{3};
+  auto parallel = lhs;
+  parallel.combine(rhs, thes::BitAndNot{}, thes::LinearExecutionPolicy{pool});
+  check(parallel, [](bool a, bool b) { return a && !b; });
+}
+
+//--------------------------------------------------------------------------------------------------
+// Set-bit search and iteration
+//--------------------------------------------------------------------------------------------------
+
+void test_set_bits() {
+  // A sparse bitset with long runs of zero chunks, and a set bit in the partial last chunk.
+  static constexpr std::size_t size = 100000;
+  static constexpr std::array expected{std::size_t{0}, std::size_t{63}, std::size_t{64},
+                                       std::size_t{4097}, std::size_t{70000}, std::size_t{99999}};
+  thes::DynamicBitset<std::uint64_t> b{size, false};
+  for (const std::size_t i : expected) {
+    b.set(i);
+  }
+  THES_ALWAYS_ASSERT(std::ranges::equal(thes::views::set_bits(b), expected));
+  THES_ALWAYS_ASSERT(std::ranges::equal(std::views::reverse(thes::views::set_bits(b)),
+                                        std::views::reverse(expected)));
+
+  THES_ALWAYS_ASSERT(b.find_next(1) == 63 && b.find_next(65) == 4097);
+  THES_ALWAYS_ASSERT(b.find_next(4097) == 4097 && b.find_next(4098) == 70000);
+  THES_ALWAYS_ASSERT(b.find_prev(62) == 0 && b.find_prev(64) == 64 && b.find_prev(69999) == 4097);
+  THES_ALWAYS_ASSERT(b.find_prev(99998) == 70000 && b.find_prev(99999) == 99999);
+  b.unset(0);
+  b.unset(99999);
+  THES_ALWAYS_ASSERT(b.find_prev(62) == size && b.find_next(70001) == size);
+
+  // The bits beyond the size are ignored, even though `fill` sets them.
+  thes::DynamicBitset<std::uint32_t> filled{40};
+  filled.fill(true);
+  filled.fill(32, 40, false);
+  THES_ALWAYS_ASSERT(filled.find_next(32) == 40);
+  THES_ALWAYS_ASSERT(std::ranges::distance(thes::views::set_bits(filled)) == 32);
+
+  const thes::DynamicBitset<std::uint32_t> empty{};
+  THES_ALWAYS_ASSERT(std::ranges::empty(thes::views::set_bits(empty)) && empty.find_next(0) == 0);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Concurrent `set_if_unset`
 //--------------------------------------------------------------------------------------------------
@@ -404,6 +548,76 @@ void test_concurrent_set_if_unset_overlapping() {
   // Every bit must end up set, regardless of who claimed it.
   THES_ALWAYS_ASSERT(std::ranges::all_of(std::as_const(b), [](bool v) { return v; }));
 }
+
+void test_set_if_unset_synchronizes() {
+  // A thread finding a bit set already returns early, but still has to see what the thread that
+  // has set the bit wrote before, which ThreadSanitizer reports otherwise.
+  static constexpr std::size_t total = 1000;
+  thes::DynamicBitset<std::uint64_t> b{total, false};
+  std::vector<std::size_t> payload(total);
+
+  std::jthread producer{[&] {
+    for (std::size_t i = 0; i < total; ++i) {
+      payload[i] = i + 1;
+      THES_ALWAYS_ASSERT(b.set_if_unset(i, std::memory_order_acq_rel));
+    }
+  }};
+  for (std::size_t i = 0; i < total; ++i) {
+    while (!b.load(i, std::memory_order_relaxed)) {
+      std::this_thread::yield();
+    }
+    THES_ALWAYS_ASSERT(!b.set_if_unset(i, std::memory_order_acq_rel));
+    THES_ALWAYS_ASSERT(payload[i] == i + 1);
+  }
+}
+
+void test_atomic_operations() {
+  thes::DynamicBitset<std::uint32_t> b{70, false};
+  THES_ALWAYS_ASSERT(!b.unset_if_set(3));
+  b.set(3);
+  THES_ALWAYS_ASSERT(b.load(3, std::memory_order_relaxed) && !b.load(4, std::memory_order_relaxed));
+  THES_ALWAYS_ASSERT(b.unset_if_set(3) && !b.get(3));
+
+  // Indices in the same chunk are combined, and already set bits are not reported.
+  b.set(33);
+  std::vector<std::size_t> fresh{};
+  const std::array indices{std::size_t{1}, std::size_t{2}, std::size_t{33}, std::size_t{34},
+                           std::size_t{2}, std::size_t{69}, std::size_t{1}};
+  THES_ALWAYS_ASSERT(b.set_many(indices, [&](std::size_t i) { fresh.push_back(i); }) == 4);
+  THES_ALWAYS_ASSERT(test::range_eq(fresh, std::array{1, 2, 34, 69}));
+  THES_ALWAYS_ASSERT(b.set_many(indices) == 0);
+
+  // The bits beyond the size are ignored, even though `fill` sets them.
+  b.fill(true);
+  THES_ALWAYS_ASSERT(b.atomic_count() == 70);
+}
+
+void test_concurrent_set_many() {
+  // Each thread marks an overlapping, sorted slice of indices, as in a parallel graph traversal:
+  // every index is reported as newly set by exactly one thread.
+  static constexpr std::size_t total = 100000;
+  static constexpr std::size_t thread_num = 4;
+  thes::DynamicBitset<std::uint64_t> b{total, false};
+
+  const thes::FixedThreadPool pool{thread_num};
+  std::array<std::size_t, thread_num> claimed{};
+  std::array<std::size_t, thread_num> reported{};
+  pool.execute([&](std::size_t thread_idx) {
+    auto indices = thes::views::indices(thread_idx * total / (thread_num + 1),
+                                        std::min(total, (thread_idx + 2) * total / thread_num));
+    claimed[thread_idx] =
+      b.set_many(indices, [&](std::size_t /*index*/) { ++reported[thread_idx]; });
+    // A concurrent count sees at least the bits set by this thread.
+    THES_ALWAYS_ASSERT(b.atomic_count() >= reported[thread_idx]);
+  });
+
+  std::size_t claimed_sum = 0;
+  for (const auto i : thes::views::indices(thread_num)) {
+    THES_ALWAYS_ASSERT(claimed[i] == reported[i]);
+    claimed_sum += claimed[i];
+  }
+  THES_ALWAYS_ASSERT(claimed_sum == total && b.count() == total && b.atomic_count() == total);
+}
 } // namespace
 
 int main() {
@@ -420,6 +634,13 @@ int main() {
   test_mutable_iteration();
   test_random_access_iterator();
   test_different_chunk_types();
+  test_count();
+  test_any_none_all();
+  test_combine();
+  test_set_bits();
   test_concurrent_set_if_unset_disjoint();
   test_concurrent_set_if_unset_overlapping();
+  test_set_if_unset_synchronizes();
+  test_atomic_operations();
+  test_concurrent_set_many();
 }
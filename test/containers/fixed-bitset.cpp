@@ -4,6 +4,7 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <ranges>
@@ -135,6 +136,31 @@ void test_countr(const Bitset& bitset) {
   THES_ALWAYS_ASSERT(bitset.countr_one() == naive(true));
 }
 
+//--------------------------------------------------------------------------------------------------
+// `find_next`/`find_prev` and `views::set_bits`, checked against a naive scan
+//--------------------------------------------------------------------------------------------------
+
+template<std::size_t ChunkByteNum>
+void test_set_bits(std::size_t size) {
+  thes::FixedBitset<ChunkByteNum> bitset{size, false};
+  std::vector<std::size_t> ref{};
+  for (std::size_t i = 0; i < size; ++i) {
+    if (i % 5 == 1 || i + 1 == size) {
+      bitset.set(i);
+      ref.push_back(i);
+    }
+  }
+  THES_ALWAYS_ASSERT(test::range_eq(thes::views::set_bits(bitset), ref));
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const auto next = std::ranges::lower_bound(ref, i);
+    THES_ALWAYS_ASSERT(bitset.find_next(i) == (next == ref.end() ? size : *next));
+    const auto prev = std::ranges::upper_bound(ref, i);
+    THES_ALWAYS_ASSERT(bitset.find_prev(i) == (prev == ref.begin() ? size : *(prev - 1)));
+  }
+  THES_ALWAYS_ASSERT(bitset.find_next(size) == size);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Sizes around chunk boundaries, including the empty bitset
 //--------------------------------------------------------------------------------------------------
@@ -147,6 +173,7 @@ void test_edge_cases() {
     test_set_unset_get<ChunkByteNum>(size);
     test_fill<ChunkByteNum>(size);
     test_mutable_range<ChunkByteNum>(size);
+    test_set_bits<ChunkByteNum>(size);
   }
 }
 } // namespace
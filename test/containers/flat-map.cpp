@@ -5,12 +5,18 @@
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
+#include <map>
+#include <random>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "thesauros/containers/flat-map.hpp"
+#include "thesauros/execution/execution-policy/linear.hpp"
+#include "thesauros/execution/execution-policy/work-stealing.hpp"
+#include "thesauros/execution/executor/fixed-thread-pool.hpp"
 #include "thesauros/test/equality.hpp"
 #include "thesauros/test/test.hpp"
 
@@ -185,6 +191,79 @@ THES_TEST_CASE("transform_or_create updates or creates", "[containers][flat-map]
   THES_CHECK(test::range_eq(map, Entries{{1, 11}, {2, 101}}));
 }
 
+//==================================================================================================
+// Bulk insertion
+//==================================================================================================
+
+/** Checks that building from a range sorts and deduplicates, keeping the first entry per key. */
+THES_TEST_CASE("bulk construction keeps the first entry per key", "[containers][flat-map]") {
+  const Map map{Entries{{5, 50}, {1, 10}, {5, 51}, {3, 30}, {1, 11}}};
+  THES_CHECK(test::range_eq(map, Entries{{1, 10}, {3, 30}, {5, 50}}));
+
+  const Map empty{Entries{}};
+  THES_CHECK(empty.empty());
+}
+
+/** Checks that `insert_range` never overwrites entries which are already present. */
+THES_TEST_CASE("insert_range does not overwrite", "[containers][flat-map]") {
+  Map map = make_map({{2, 20}, {4, 40}});
+
+  map.insert_range(Entries{{4, 99}, {1, 10}, {3, 30}, {1, 99}, {6, 60}});
+  THES_CHECK(test::range_eq(map, Entries{{1, 10}, {2, 20}, {3, 30}, {4, 40}, {6, 60}}));
+
+  map.insert_range(Entries{});
+  THES_CHECK(map.size() == 5);
+}
+
+/** Checks that `merge` adds the missing keys of another map and prefers its own values. */
+THES_TEST_CASE("merge unites two maps", "[containers][flat-map]") {
+  Map map = make_map({{1, 10}, {3, 30}, {5, 50}});
+
+  map.merge(make_map({{0, 0}, {3, 99}, {4, 40}, {9, 90}}));
+  THES_CHECK(test::range_eq(map, Entries{{0, 0}, {1, 10}, {3, 30}, {4, 40}, {5, 50}, {9, 90}}));
+
+  map.merge(Map{});
+  THES_CHECK(map.size() == 6);
+  Map empty{};
+  empty.merge(map);
+  THES_CHECK(test::range_eq(empty, map));
+}
+
+/** Checks bulk insertion with parallel sorting against a `std::map` built one entry at a time. */
+THES_TEST_CASE("parallel bulk insertion matches std::map", "[containers][flat-map]") {
+  std::mt19937 rng{7};
+  std::uniform_int_distribution<int> dist{0, 20000};
+  Entries first{};
+  Entries second{};
+  for (int i = 0; i < 30000; ++i) {
+    first.emplace_back(dist(rng), i);
+    second.emplace_back(dist(rng), -i);
+  }
+
+  std::map<int, int> ref{};
+  for (const auto& [key, value] : first) {
+    ref.emplace(key, value);
+  }
+  const std::map<int, int> ref_first = ref;
+  for (const auto& [key, value] : second) {
+    ref.emplace(key, value);
+  }
+
+  const thes::FixedThreadPool pool{3};
+  const auto check = [&](const auto& expo) {
+    Map map{first, expo};
+    THES_CHECK(test::range_eq(map, ref_first));
+    map.insert_range(second, expo);
+    THES_CHECK(test::range_eq(map, ref));
+  };
+  check(thes::LinearExecutionPolicy{pool});
+  check(thes::WorkStealingExecutionPolicy{pool, 1000});
+
+  Map map{first};
+  map.insert_range(second);
+  THES_CHECK(test::range_eq(map, ref));
+}
+
 //==================================================================================================
 // Removal
 //==================================================================================================
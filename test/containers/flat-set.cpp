@@ -6,10 +6,14 @@
 
 #include <functional>
 #include <initializer_list>
+#include <random>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "thesauros/containers/flat-set.hpp"
+#include "thesauros/execution/execution-policy/work-stealing.hpp"
+#include "thesauros/execution/executor/fixed-thread-pool.hpp"
 #include "thesauros/test/equality.hpp"
 #include "thesauros/test/test.hpp"
 
@@ -183,6 +187,49 @@ THES_TEST_CASE("set_difference removes shared values", "[containers][flat-set]")
   THES_CHECK(set.empty());
 }
 
+/** Checks that `merge` adds the values of another set. */
+THES_TEST_CASE("merge unites two sets", "[containers][flat-set]") {
+  Set set = make_set({1, 3, 5});
+
+  set.merge(make_set({0, 3, 4, 9}));
+  THES_CHECK(test::range_eq(set, Vec{0, 1, 3, 4, 5, 9}));
+
+  set.merge(Set{});
+  THES_CHECK(set.size() == 6);
+}
+
+//==================================================================================================
+// Bulk insertion
+//==================================================================================================
+
+/** Checks that building from a range and `insert_range` sort and deduplicate. */
+THES_TEST_CASE("bulk insertion sorts and deduplicates", "[containers][flat-set]") {
+  Set set{Vec{5, 1, 3, 1, 5, 2}};
+  THES_CHECK(test::range_eq(set, Vec{1, 2, 3, 5}));
+
+  set.insert_range(Vec{4, 2, 0, 4});
+  THES_CHECK(test::range_eq(set, Vec{0, 1, 2, 3, 4, 5}));
+
+  set.insert_range(Vec{});
+  THES_CHECK(set.size() == 6);
+}
+
+/** Checks bulk insertion with parallel sorting against a `std::set`. */
+THES_TEST_CASE("parallel bulk insertion matches std::set", "[containers][flat-set]") {
+  std::mt19937 rng{11};
+  std::uniform_int_distribution<int> dist{0, 50000};
+  Vec values{};
+  for (int i = 0; i < 40000; ++i) {
+    values.push_back(dist(rng));
+  }
+  const std::set<int> ref(values.begin(), values.end());
+
+  const thes::FixedThreadPool pool{4};
+  const thes::WorkStealingExecutionPolicy expo{pool, 777};
+  const Set set{values, expo};
+  THES_CHECK(test::range_eq(set, ref));
+}
+
 //==================================================================================================
 // Custom comparators
 //==================================================================================================
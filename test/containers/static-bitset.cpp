@@ -149,6 +149,33 @@ constexpr void test_countr() {
   }
 }
 
+//--------------------------------------------------------------------------------------------------
+// `find_next`/`find_prev` and `views::set_bits`, checked against a naive scan
+//--------------------------------------------------------------------------------------------------
+
+template<std::size_t Size, std::size_t ChunkByteNum>
+constexpr void test_set_bits() {
+  using Bitset = thes::StaticBitset<Size, ChunkByteNum>;
+
+  Bitset bitset{false};
+  std::array<std::size_t, Size> ref{};
+  std::size_t ref_num = 0;
+  for (std::size_t i = 0; i < Size; i += 3) {
+    bitset.set(i);
+    ref[ref_num++] = i;
+  }
+  THES_ALWAYS_ASSERT(
+    std::ranges::equal(thes::views::set_bits(bitset), ref | std::views::take(ref_num)));
+
+  for (std::size_t i = 0; i < Size; ++i) {
+    // `i - i % 3` is the last set bit at or before `i`, and the next one follows three bits later.
+    const std::size_t next = i % 3 == 0 ? i : i - i % 3 + 3;
+    THES_ALWAYS_ASSERT(bitset.find_next(i) == std::min(next, Size));
+    THES_ALWAYS_ASSERT(bitset.find_prev(i) == i - i % 3);
+  }
+  THES_ALWAYS_ASSERT(bitset.find_next(Size) == Size);
+}
+
 //--------------------------------------------------------------------------------------------------
 // Full suite for one `(Size, ChunkByteNum)` combination
 //--------------------------------------------------------------------------------------------------
@@ -159,6 +186,7 @@ constexpr void test_bitset() {
   test_construction<Bitset>();
   test_range_behavior<Size, ChunkByteNum>();
   test_countr<Size, ChunkByteNum>();
+  test_set_bits<Size, ChunkByteNum>();
 }
 
 //--------------------------------------------------------------------------------------------------
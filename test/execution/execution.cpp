@@ -4,16 +4,21 @@
 // License, v. 2.0. If a copy of the MPL was not distributed with this
 // file, You can obtain one at https://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdio>
 #include <exception>
 #include <functional>
+#include <numeric>
 #include <ranges>
+#include <thread>
 #include <vector>
 
 #include "thesauros/algorithms.hpp"
 #include "thesauros/execution.hpp"
 #include "thesauros/format.hpp"
 #include "thesauros/macropolis/platform.hpp"
+#include "thesauros/ranges/indices.hpp"
 #include "thesauros/resources.hpp"
 #include "thesauros/test.hpp"
 #include "thesauros/types/type-name.hpp"
@@ -21,7 +26,6 @@
 #if THES_LINUX || THES_WINDOWS
 #include <chrono>
 #include <set>
-#include <thread>
 #endif
 
 int main() try {
@@ -52,12 +56,76 @@ int main() try {
       Type{0});
 
     THES_ALWAYS_ASSERT(scanned == scanned_ref);
+
+    // Tiles smaller than the input, so that the look-back crosses several of them.
+    for (const std::size_t tile_size : {std::size_t{1}, std::size_t{3}}) {
+      thes::transform_inclusive_scan(
+        expo, values.begin(), values.end(), scanned.begin(), std::plus<>{},
+        [](Type v) { return v; }, Type{0}, tile_size);
+      THES_ALWAYS_ASSERT(scanned == scanned_ref);
+
+      thes::transform_exclusive_scan(
+        expo, values.begin(), values.end(), scanned.begin(), Type{1}, std::plus<>{},
+        [](Type v) { return v; }, tile_size);
+      for (const std::size_t i : thes::views::indices(values.size())) {
+        THES_ALWAYS_ASSERT(scanned[i] == 1 + scanned_ref[i] - values[i]);
+      }
+    }
   };
 
   run_scan(thes::FixedStdThreadPool{2});
   run_scan(thes::FixedOpenMpThreadPool{2});
   run_scan(thes::FixedThreadPool{2});
 
+  // Every index is visited exactly once, however the chunks are balanced between the threads.
+  auto check_chunked = [](const auto& expo) {
+    for (const std::size_t size : {std::size_t{0}, std::size_t{1}, std::size_t{10007}}) {
+      std::vector<int> visits(size, 0);
+      expo.execute_chunked(size, [&](std::size_t /*thread_idx*/, std::size_t begin,
+                                     std::size_t end) {
+        THES_ALWAYS_ASSERT(begin < end && end <= size);
+        for (std::size_t i = begin; i < end; ++i) {
+          // Skew the work towards the first segment to provoke rebalancing.
+          if (i < size / 4) {
+            std::this_thread::yield();
+          }
+          ++visits[i];
+        }
+      });
+      THES_ALWAYS_ASSERT(std::ranges::all_of(visits, [](int v) { return v == 1; }));
+
+      // Reductions combine every element exactly once, on top of the initial value.
+      std::vector<std::size_t> indices(size);
+      std::iota(indices.begin(), indices.end(), std::size_t{1});
+      const std::size_t sum = thes::reduce(expo, indices.begin(), indices.end(), std::size_t{3});
+      THES_ALWAYS_ASSERT(sum == 3 + size * (size + 1) / 2);
+      const std::size_t max = thes::transform_reduce(
+        expo, indices.begin(), indices.end(), std::size_t{0},
+        [](std::size_t a, std::size_t b) { return std::max(a, b); },
+        [](std::size_t i) { return 2 * i; });
+      THES_ALWAYS_ASSERT(max == 2 * size);
+    }
+  };
+  auto run_chunked = [&](const auto& pool) {
+    check_chunked(thes::LinearExecutionPolicy{pool});
+    for (const std::size_t chunk_size : {std::size_t{0}, std::size_t{1}, std::size_t{7}}) {
+      check_chunked(thes::WorkStealingExecutionPolicy{pool, chunk_size});
+    }
+    for (const auto schedule : {thes::ChunkSchedule::dynamic, thes::ChunkSchedule::guided}) {
+      for (const std::size_t block_size : {std::size_t{1}, std::size_t{64}}) {
+        for (const std::size_t chunk_blocks : {std::size_t{1}, std::size_t{3}}) {
+          check_chunked(
+            thes::SelfSchedulingExecutionPolicy{pool, schedule, block_size, chunk_blocks});
+        }
+      }
+    }
+  };
+
+  run_chunked(thes::FixedStdThreadPool{3});
+  run_chunked(thes::FixedOpenMpThreadPool{2});
+  run_chunked(thes::FixedThreadPool{3});
+  run_chunked(thes::SequentialExecutor{});
+
   const auto logical = std::ranges::to<std::vector<thes::CpuInfo>>(thes::CpuInfo::logical());
   fmt::print("{}× logical: {}\n", logical.size(), logical);
   // E cores
@@ -105,6 +173,17 @@ int main() try {
   const auto physical_part_perf = std::ranges::to<std::vector<thes::CpuInfo>>(
     thes::CpuInfo::physical_part(thes::EfficiencyClass::performance, 0, 2));
   fmt::print("{}× physical performance 0/2: {}\n", physical_part_perf.size(), physical_part_perf);
+  fmt::print("\n");
+
+  const auto numa_nodes = thes::CpuInfo::numa_nodes();
+  fmt::print("{}× NUMA node: {}\n", numa_nodes.size(), numa_nodes);
+  for (const std::size_t node : numa_nodes) {
+    const auto node_cpus =
+      std::ranges::to<std::vector<thes::CpuInfo>>(thes::CpuInfo::numa_node_cpus(node));
+    fmt::print("{}× logical on node {}: {}\n", node_cpus.size(), node, node_cpus);
+    THES_ALWAYS_ASSERT(std::ranges::all_of(
+      node_cpus, [node](const thes::CpuInfo& info) { return info.numa_node() == node; }));
+  }
 
 #if THES_LINUX || THES_WINDOWS
   {
@@ -0,0 +1,72 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#define THES_PROFILE_EXECUTION true
+
+#include <chrono>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <thread>
+
+#include "thesauros/execution.hpp"
+#include "thesauros/io.hpp"
+#include "thesauros/test.hpp"
+
+int main() {
+  constexpr std::size_t size = 4;
+  constexpr std::size_t region_num = 8;
+
+  thes::FixedThreadPool pool{size};
+
+  // The last index sleeps much longer than the others, which has to show up as imbalance.
+  for (std::size_t r = 0; r < region_num; ++r) {
+    pool.execute([](std::size_t i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{i + 1 == size ? 20 : 1});
+    });
+  }
+  {
+    const auto& profiles = pool.profiler().profiles();
+    THES_ALWAYS_ASSERT(profiles.size() == region_num);
+    for (const thes::RegionProfile& profile : profiles) {
+      THES_ALWAYS_ASSERT(profile.busy_times.size() == size);
+      THES_ALWAYS_ASSERT(profile.wait_times.size() == size);
+      THES_ALWAYS_ASSERT(profile.dispatch_latency >= 0.0);
+      THES_ALWAYS_ASSERT(profile.imbalance > 2.0);
+      // The slow index is the last one to finish and does not wait for the others.
+      THES_ALWAYS_ASSERT(profile.wait_times[0] > profile.wait_times[size - 1]);
+    }
+
+    const thes::RegionProfileSummary summary = pool.profiler().summary();
+    THES_ALWAYS_ASSERT(summary.regions == region_num);
+    THES_ALWAYS_ASSERT(summary.busy_times.size() == size);
+    THES_ALWAYS_ASSERT(summary.busy_times[size - 1] > summary.busy_times[0]);
+    THES_ALWAYS_ASSERT(summary.mean_imbalance > 2.0);
+
+    std::string json{};
+    thes::write_json(std::back_inserter(json), summary);
+    THES_ALWAYS_ASSERT(json.find("\"mean_dispatch_latency\"") != std::string::npos);
+    json.clear();
+    thes::write_json(std::back_inserter(json), profiles);
+    THES_ALWAYS_ASSERT(json.find("\"imbalance\"") != std::string::npos);
+  }
+
+  // Regions using only some of the threads record only those.
+  pool.profiler().clear();
+  pool.execute([](std::size_t /*i*/) {}, 2);
+  THES_ALWAYS_ASSERT(pool.profiler().profiles().size() == 1);
+  THES_ALWAYS_ASSERT(pool.profiler().profiles()[0].busy_times.size() == 2);
+
+  // Execution policies are covered, as they dispatch their regions through the pool.
+  pool.profiler().clear();
+  thes::LinearExecutionPolicy expo{pool};
+  expo.execute_segmented(std::size_t{1000}, [](std::size_t /*thread_idx*/, std::size_t begin,
+                                               std::size_t end) {
+    THES_ALWAYS_ASSERT(begin <= end);
+  });
+  THES_ALWAYS_ASSERT(pool.profiler().profiles().size() == 1);
+  THES_ALWAYS_ASSERT(pool.profiler().profiles()[0].busy_times.size() == size);
+}
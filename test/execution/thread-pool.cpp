@@ -9,6 +9,7 @@
 #include <cstddef>
 #include <cstdio>
 #include <exception>
+#include <numeric>
 #include <ranges>
 #include <ratio>
 #include <stdexcept>
@@ -41,26 +42,28 @@ int main() try {
   //================================================================================================
 
   // Every thread index runs exactly once per region, both when the threads spin and when they park
-  // immediately.
-  for (const std::size_t spin : {std::size_t{0}, thes::FixedThreadPool::default_spin_count}) {
-    for (const std::size_t size : thes::views::indices(std::size_t{1}, max_threads + 1)) {
-      const thes::FixedThreadPool pool{size, thes::Empty{}, spin};
-      THES_ALWAYS_ASSERT(pool.thread_num() == size);
+  // immediately, and however they report completion.
+  for (const auto completion : {thes::CompletionStrategy::counter, thes::CompletionStrategy::tree}) {
+    for (const std::size_t spin : {std::size_t{0}, thes::FixedThreadPool::default_spin_count}) {
+      for (const std::size_t size : thes::views::indices(std::size_t{1}, max_threads + 1)) {
+        const thes::FixedThreadPool pool{size, thes::Empty{}, spin, completion};
+        THES_ALWAYS_ASSERT(pool.thread_num() == size);
 
-      std::vector<std::size_t> counts(size * stride, 0);
-      for ([[maybe_unused]] const std::size_t r : thes::views::indices(regions)) {
-        pool.execute([&counts](std::size_t index) { counts[index * stride] += 1; });
-      }
-      for (const std::size_t index : thes::views::indices(size)) {
-        THES_ALWAYS_ASSERT(counts[index * stride] == regions);
-      }
-
-      // Only the requested prefix of the thread indices participates.
-      for (const std::size_t used : thes::views::indices(size + 1)) {
-        std::vector<std::size_t> partial(size * stride, 0);
-        pool.execute([&partial](std::size_t index) { partial[index * stride] += 1; }, used);
+        std::vector<std::size_t> counts(size * stride, 0);
+        for ([[maybe_unused]] const std::size_t r : thes::views::indices(regions)) {
+          pool.execute([&counts](std::size_t index) { counts[index * stride] += 1; });
+        }
         for (const std::size_t index : thes::views::indices(size)) {
-          THES_ALWAYS_ASSERT(partial[index * stride] == std::size_t{index < used});
+          THES_ALWAYS_ASSERT(counts[index * stride] == regions);
+        }
+
+        // Only the requested prefix of the thread indices participates.
+        for (const std::size_t used : thes::views::indices(size + 1)) {
+          std::vector<std::size_t> partial(size * stride, 0);
+          pool.execute([&partial](std::size_t index) { partial[index * stride] += 1; }, used);
+          for (const std::size_t index : thes::views::indices(size)) {
+            THES_ALWAYS_ASSERT(partial[index * stride] == std::size_t{index < used});
+          }
         }
       }
     }
@@ -101,6 +104,202 @@ int main() try {
     }
   }
 
+  // With adaptive spinning, the workers spin through short gaps between regions and not at all
+  // through long ones. Unlike the pool below, this mapping does not depend on timing.
+  {
+    using Pool = thes::FixedThreadPool;
+    using Nanos = std::chrono::duration<double, std::nano>;
+    const std::size_t short_spins = Pool::spin_count_for_gap(std::chrono::microseconds{1});
+    THES_ALWAYS_ASSERT(Pool::spin_count_for_gap(Nanos{0}) > 0);
+    THES_ALWAYS_ASSERT(short_spins > 0);
+    THES_ALWAYS_ASSERT(Pool::spin_count_for_gap(std::chrono::microseconds{20}) >= short_spins);
+    THES_ALWAYS_ASSERT(Pool::spin_count_for_gap(Pool::max_adaptive_spin) > 0);
+    THES_ALWAYS_ASSERT(Pool::spin_count_for_gap(Pool::max_adaptive_spin + Nanos{1}) == 0);
+    THES_ALWAYS_ASSERT(Pool::spin_count_for_gap(std::chrono::milliseconds{5}) == 0);
+  }
+
+  // Workers stop spinning through long gaps between regions and park. Each gap is at least 5 ms,
+  // however the threads are scheduled, which keeps the moving average far above
+  // `max_adaptive_spin` even if the preceding regions were back to back.
+  {
+    const std::size_t size = std::max(max_threads, std::size_t{2});
+    const thes::FixedThreadPool pool{size, thes::Empty{},
+                                     thes::FixedThreadPool::adaptive_spin_count};
+    std::vector<std::size_t> counts(size * stride, 0);
+    auto task = [&counts](std::size_t index) { counts[index * stride] += 1; };
+    for ([[maybe_unused]] const std::size_t r : thes::views::indices(regions)) {
+      pool.execute(task);
+    }
+
+    constexpr std::size_t idle_regions = 8;
+    const auto before = pool.wakeup_counts();
+    for ([[maybe_unused]] const std::size_t r : thes::views::indices(idle_regions)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds{5});
+      pool.execute(task);
+    }
+    const auto after = pool.wakeup_counts();
+    THES_ALWAYS_ASSERT(pool.worker_spin_count() == 0);
+    THES_ALWAYS_ASSERT(after.regions == before.regions + idle_regions);
+    THES_ALWAYS_ASSERT(after.worker_parks - before.worker_parks >= idle_regions * (size - 1));
+    for (const std::size_t index : thes::views::indices(size)) {
+      THES_ALWAYS_ASSERT(counts[index * stride] == regions + idle_regions);
+    }
+
+    // Without adaptive spinning, the count stays fixed.
+    const thes::FixedThreadPool fixed_pool{size};
+    fixed_pool.execute([](std::size_t /*index*/) {});
+    THES_ALWAYS_ASSERT(fixed_pool.worker_spin_count() ==
+                       thes::FixedThreadPool::default_spin_count);
+  }
+
+  // No index passes a barrier before all indices of the region have reached it, including in regions
+  // using only some of the threads.
+  for (const auto completion : {thes::CompletionStrategy::counter, thes::CompletionStrategy::tree}) {
+    const thes::FixedThreadPool pool{max_threads, thes::Empty{},
+                                     thes::FixedThreadPool::default_spin_count, completion};
+    for (const std::size_t used : thes::views::indices(std::size_t{1}, max_threads + 1)) {
+      std::vector<std::size_t> phases(max_threads * stride, 0);
+      std::vector<std::size_t> behind(max_threads * stride, 0);
+      pool.execute(
+        [&](std::size_t index) {
+          for (const std::size_t phase : thes::views::indices(std::size_t{1}, std::size_t{9})) {
+            phases[index * stride] = phase;
+            pool.barrier(index);
+            for (const std::size_t other : thes::views::indices(used)) {
+              behind[index * stride] += std::size_t{phases[other * stride] < phase};
+            }
+            pool.barrier(index);
+          }
+        },
+        used);
+      for (const std::size_t index : thes::views::indices(max_threads)) {
+        THES_ALWAYS_ASSERT(behind[index * stride] == 0);
+      }
+    }
+  }
+
+  // A submitted region runs on the workers alone while the calling thread is free, and can be
+  // polled, waited for and followed by regular regions.
+  for (const std::size_t size : thes::views::indices(std::size_t{1}, max_threads + 1)) {
+    const thes::FixedThreadPool pool{size};
+    const std::size_t used = std::max(size - 1, std::size_t{1});
+
+    std::vector<std::size_t> counts(size * stride, 0);
+    std::vector<std::thread::id> ids(size * stride);
+    auto task = [&](std::size_t index) {
+      counts[index * stride] += 1;
+      ids[index * stride] = std::this_thread::get_id();
+    };
+    auto submission = pool.submit(task);
+    while (!submission.ready()) {
+      std::this_thread::yield();
+    }
+    submission.wait();
+    for (const std::size_t index : thes::views::indices(size)) {
+      THES_ALWAYS_ASSERT(counts[index * stride] == std::size_t{index < used});
+    }
+    if (size > 1) {
+      THES_ALWAYS_ASSERT(ids[0] != std::this_thread::get_id());
+    }
+
+    pool.execute(task);
+    for (const std::size_t index : thes::views::indices(size)) {
+      THES_ALWAYS_ASSERT(counts[index * stride] == std::size_t{index < used} + 1);
+    }
+
+    if (size > 1) {
+      auto thrower = [](std::size_t /*index*/) { throw std::runtime_error{"submitted"}; };
+      bool caught = false;
+      auto failing = pool.submit(thrower);
+      try {
+        failing.wait();
+      } catch (const std::runtime_error& ex) {
+        caught = std::string_view{ex.what()} == "submitted";
+      }
+      THES_ALWAYS_ASSERT(caught);
+
+      // A handle which is not waited for waits on destruction and discards the exception.
+      { auto discarded = pool.submit(thrower); }
+      pool.execute([](std::size_t /*index*/) {});
+    }
+  }
+
+  // Recursive tasks fork onto the pool, both in fork-join regions, where idle threads help, and in
+  // regular ones, where the forking thread runs both halves itself.
+  {
+    const thes::FixedThreadPool pool{max_threads};
+    auto fib = [&pool](this const auto& self, std::size_t n) -> std::size_t {
+      if (n < 2) {
+        return n;
+      }
+      std::size_t lhs = 0;
+      std::size_t rhs = 0;
+      pool.fork_join([&] { lhs = self(n - 1); }, [&] { rhs = self(n - 2); });
+      return lhs + rhs;
+    };
+
+    std::vector<std::size_t> results(max_threads * stride, 0);
+    auto task = [&](std::size_t index) { results[index * stride] = fib(15 + index % 3); };
+    for ([[maybe_unused]] const std::size_t r : thes::views::indices(std::size_t{16})) {
+      pool.execute_fork_join(task);
+      for (const std::size_t index : thes::views::indices(max_threads)) {
+        THES_ALWAYS_ASSERT(results[index * stride] == fib(15 + index % 3));
+      }
+    }
+    pool.execute(task);
+    for (const std::size_t index : thes::views::indices(max_threads)) {
+      THES_ALWAYS_ASSERT(results[index * stride] == fib(15 + index % 3));
+    }
+
+    // An exception thrown by a forked job escapes the `fork_join` that forked it.
+    bool caught = false;
+    try {
+      pool.execute_fork_join([&](std::size_t index) {
+        if (index == 0) {
+          pool.fork_join([] {}, [] { throw std::runtime_error{"forked"}; });
+        } else {
+          (void)fib(10);
+        }
+      });
+    } catch (const std::runtime_error& ex) {
+      caught = std::string_view{ex.what()} == "forked";
+    }
+    THES_ALWAYS_ASSERT(caught);
+  }
+
+  // A hierarchical pool numbers the threads consecutively across its groups and only involves the
+  // groups which contain one of the requested indices.
+  for (const std::vector<std::size_t>& group_sizes :
+       {std::vector<std::size_t>{1}, std::vector<std::size_t>{3}, std::vector<std::size_t>{1, 2},
+        std::vector<std::size_t>{2, 1, 3}}) {
+    const thes::HierarchicalThreadPool pool{group_sizes};
+    const std::size_t size = pool.thread_num();
+    THES_ALWAYS_ASSERT(pool.group_num() == group_sizes.size());
+    THES_ALWAYS_ASSERT(size == std::accumulate(group_sizes.begin(), group_sizes.end(), 0UZ));
+
+    for (const std::size_t used : thes::views::indices(size + 1)) {
+      std::vector<std::size_t> counts(size * stride, 0);
+      for ([[maybe_unused]] const std::size_t r : thes::views::indices(regions)) {
+        pool.execute([&counts](std::size_t index) { counts[index * stride] += 1; }, used);
+      }
+      for (const std::size_t index : thes::views::indices(size)) {
+        THES_ALWAYS_ASSERT(counts[index * stride] == (index < used ? regions : 0));
+      }
+    }
+
+    bool caught = false;
+    try {
+      pool.execute([size](std::size_t index) {
+        if (index + 1 == size) {
+          throw std::runtime_error{"last"};
+        }
+      });
+    } catch (const std::runtime_error& ex) {
+      caught = std::string_view{ex.what()} == "last";
+    }
+    THES_ALWAYS_ASSERT(caught);
+  }
+
   //================================================================================================
   // The latency of an empty parallel region
   //================================================================================================
@@ -139,6 +338,16 @@ int main() try {
     };
 
     bench("FixedThreadPool", thes::FixedThreadPool{size});
+    bench("FixedThreadPool (adapt)",
+          thes::FixedThreadPool{size, thes::Empty{}, thes::FixedThreadPool::adaptive_spin_count});
+    bench("FixedThreadPool (tree)",
+          thes::FixedThreadPool{size, thes::Empty{}, thes::FixedThreadPool::default_spin_count,
+                                thes::CompletionStrategy::tree});
+    // Each group needs at least one thread.
+    if (size >= 2) {
+      bench("HierarchicalThreadPool",
+            thes::HierarchicalThreadPool{std::vector{size / 2, size - size / 2}});
+    }
     bench("FixedStdThreadPool", thes::FixedStdThreadPool{size});
     try {
       bench("FixedOpenMpThreadPool", thes::FixedOpenMpThreadPool{size});
@@ -166,6 +375,17 @@ int main() try {
       fmt::print("pinned to {} of the {} physical CPUs\n", size, cpus.size());
     }
   }
+
+  // One group per NUMA node among the physical CPUs.
+  {
+    const auto pool = thes::HierarchicalThreadPool::from_cpu_infos(thes::CpuInfo::physical());
+    std::vector<std::size_t> counts(pool.thread_num() * stride, 0);
+    pool.execute([&counts](std::size_t index) { counts[index * stride] += 1; });
+    for (const std::size_t index : thes::views::indices(pool.thread_num())) {
+      THES_ALWAYS_ASSERT(counts[index * stride] == 1);
+    }
+    fmt::print("{} threads in {} NUMA groups\n", pool.thread_num(), pool.group_num());
+  }
 } catch (const std::exception& ex) {
   fmt::print(stderr, "Unhandled std::exception: type={}; what={}\n",
              thes::demangle(typeid(ex).name()), ex.what());
@@ -0,0 +1,104 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+#include "thesauros/containers/dynamic-buffer.hpp"
+#include "thesauros/filesystem/tempfile.hpp"
+#include "thesauros/io/async-file-reader.hpp"
+#include "thesauros/io/file-writer.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/test/test.hpp"
+
+namespace {
+constexpr std::size_t file_size = 1 << 20;
+
+std::byte byte_at(std::size_t index) {
+  return std::byte((index * 7) ^ (index >> 8U));
+}
+
+/** Writes a file of `file_size` bytes with a known pattern and returns its path. */
+std::filesystem::path write_pattern(const thes::fs::TemporaryDirectory& dir) {
+  auto path = dir.path() / "pattern.bin";
+  std::vector<std::byte> bytes(file_size);
+  for (std::size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = byte_at(i);
+  }
+  thes::FileWriter writer{path};
+  writer.write(std::span{bytes.data(), bytes.size()});
+  return path;
+}
+
+/** Whether `buffer` contains the pattern starting at `offset`. */
+bool matches(const thes::DynamicBuffer& buffer, std::size_t offset) {
+  for (std::size_t i = 0; i < buffer.size(); ++i) {
+    if (buffer[i] != byte_at(offset + i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+THES_TEST_CASE("AsyncFileReader keeps many reads in flight", "[io][async-file-reader]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = write_pattern(dir);
+
+  // A small queue, so that queueing more reads has to wait for earlier ones.
+  thes::AsyncFileReader reader{path, 8};
+  constexpr std::size_t chunk_size = 4096 + 17;
+  std::vector<thes::DynamicBuffer> buffers(file_size / chunk_size + 1);
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    reader.read(buffers[i], chunk_size, i * chunk_size);
+    if (i % 16 == 0) {
+      reader.submit();
+    }
+  }
+  reader.wait();
+
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < buffers.size(); ++i) {
+    THES_CHECK(matches(buffers[i], i * chunk_size));
+    total += buffers[i].size();
+  }
+  // The last read is cut short by the end of the file.
+  THES_CHECK(total == file_size);
+  THES_CHECK(buffers.back().size() == file_size % chunk_size);
+}
+
+THES_TEST_CASE("AsyncFileReader reads at and beyond the end", "[io][async-file-reader]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = write_pattern(dir);
+
+  thes::AsyncFileReader reader{path};
+  thes::DynamicBuffer whole{};
+  thes::DynamicBuffer beyond{};
+  thes::DynamicBuffer empty{};
+  reader.read(whole, file_size, 0);
+  reader.read(beyond, 100, file_size + 5);
+  reader.read(empty, 0, 10);
+  reader.wait();
+  THES_CHECK(whole.size() == file_size);
+  THES_CHECK(matches(whole, 0));
+  THES_CHECK(beyond.size() == 0);
+  THES_CHECK(empty.size() == 0);
+
+  // The reader can be reused after waiting.
+  reader.read(whole, 10, 1000);
+  reader.wait();
+  THES_CHECK(whole.size() == 10);
+  THES_CHECK(matches(whole, 1000));
+}
+
+THES_TEST_CASE("AsyncFileReader reports missing files", "[io][async-file-reader]") {
+  const thes::fs::TemporaryDirectory dir{};
+  THES_CHECK_THROWS_AS(thes::AsyncFileReader{dir.path() / "missing.bin"}, thes::FileException);
+}
+} // namespace
+
+THES_TEST_MAIN()
@@ -0,0 +1,225 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string_view>
+
+#include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/containers/multi-byte-integers.hpp"
+#include "thesauros/containers/nested-dynamic-array.hpp"
+#include "thesauros/filesystem/tempfile.hpp"
+#include "thesauros/io/container-file.hpp"
+#include "thesauros/io/file-reader.hpp"
+#include "thesauros/io/file-writer.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/io/mapped-file.hpp"
+#include "thesauros/test/equality.hpp"
+#include "thesauros/test/test.hpp"
+#include "thesauros/types/primitives.hpp"
+#include "thesauros/types/type-tag.hpp"
+#include "thesauros/utility/byte-integer.hpp"
+
+namespace {
+using Chunk = thes::TypedChunk<int, std::size_t, std::allocator<int>>;
+using FloatChunk = thes::TypedChunk<float, std::size_t, std::allocator<float>>;
+using Nested = thes::NestedDynamicArray<int, std::size_t>;
+using Integers = thes::MultiByteIntegers<thes::ByteInteger<3>, 1>;
+
+Chunk make_chunk() {
+  Chunk chunk{6};
+  const std::array<int, 6> values{3, 1, 4, 1, 5, 9};
+  std::ranges::copy(values, chunk.span().begin());
+  return chunk;
+}
+
+/** Writes each of `values` as a container file under `dir` and returns its path. */
+std::filesystem::path write(const std::filesystem::path& dir, thes::ContainerFileOptions options,
+                            const auto&... values) {
+  auto path = dir / "data.thes";
+  thes::FileWriter writer{path};
+  (thes::to_container_file(values, writer, options), ...);
+  return path;
+}
+
+THES_TEST_CASE("TypedChunk round-trips through a container file", "[io][container-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const Chunk chunk = make_chunk();
+
+  for (const auto checksum : {thes::ContainerChecksum::none, thes::ContainerChecksum::crc32c}) {
+    const auto path = write(dir.path(), {.checksum = checksum}, chunk, chunk);
+
+    thes::FileReader reader{path};
+    const auto first = thes::from_container_file(reader, thes::type_tag<Chunk>);
+    const auto second = thes::from_container_file(reader, thes::type_tag<Chunk>);
+    THES_CHECK(thes::test::range_eq(first.span(), chunk.span()));
+    THES_CHECK(thes::test::range_eq(second.span(), chunk.span()));
+
+    // Both payloads are aligned to pages, so that they can be viewed in a mapped file.
+    const thes::MappedFile file{path};
+    thes::MappedReader mapped{file};
+    const auto view1 = thes::view_from_container_file(mapped, thes::type_tag<Chunk>);
+    const auto view2 = thes::view_from_container_file(mapped, thes::type_tag<Chunk>);
+    THES_CHECK(thes::test::range_eq(view1, chunk.span()));
+    THES_CHECK(thes::test::range_eq(view2, chunk.span()));
+    THES_CHECK(std::uintptr_t(view1.data()) % 4096 == 0);
+    THES_CHECK(std::uintptr_t(view2.data()) % 4096 == 0);
+  }
+}
+
+THES_TEST_CASE("Container files respect the payload alignment", "[io][container-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const Chunk chunk = make_chunk();
+  const auto path = write(dir.path(), {.alignment = 64}, chunk, Chunk{0}, chunk);
+
+  thes::FileReader reader{path};
+  const auto header = reader.read(thes::type_tag<thes::ContainerHeader>);
+  THES_CHECK(header.payload_offset == 64);
+  THES_CHECK(header.element_num == 6);
+  THES_CHECK(header.payload_size == 6 * sizeof(int));
+
+  const thes::MappedFile file{path};
+  thes::MappedReader mapped{file};
+  THES_CHECK(thes::view_from_container_file(mapped, thes::type_tag<Chunk>).size() == 6);
+  THES_CHECK(thes::view_from_container_file(mapped, thes::type_tag<Chunk>).empty());
+  THES_CHECK(thes::view_from_container_file(mapped, thes::type_tag<Chunk>).size() == 6);
+  THES_CHECK(mapped.tell() == file.size());
+}
+
+THES_TEST_CASE("Container files reject mismatched reads", "[io][container-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = write(dir.path(), {}, make_chunk());
+
+  // A different element type of the same size.
+  {
+    thes::FileReader reader{path};
+    THES_CHECK_THROWS_AS(thes::from_container_file(reader, thes::type_tag<FloatChunk>),
+                         thes::FileException);
+  }
+  // A file with corrupted contents.
+  {
+    thes::FileWriter writer{path};
+    thes::to_container_file(make_chunk(), writer);
+    writer.seek(-1, thes::Seek::end);
+    writer.write(std::byte{0x42});
+  }
+  {
+    thes::FileReader reader{path};
+    THES_CHECK_THROWS_AS(thes::from_container_file(reader, thes::type_tag<Chunk>),
+                         thes::FileException);
+  }
+  {
+    thes::FileReader reader{path};
+    const auto chunk = thes::from_container_file(reader, thes::type_tag<Chunk>, false);
+    THES_CHECK(chunk[5] != 9);
+  }
+  // A file written with the other endianness, whose version is byte-swapped as well.
+  {
+    thes::FileWriter writer{path};
+    thes::to_container_file(make_chunk(), writer);
+    writer.pwrite(std::byteswap(thes::ContainerHeader::current_version),
+                  long{offsetof(thes::ContainerHeader, version)});
+    writer.pwrite(thes::u8(3 - thes::ContainerHeader::native_endianness),
+                  long{offsetof(thes::ContainerHeader, endianness)});
+  }
+  {
+    thes::FileReader reader{path};
+    bool endianness = false;
+    try {
+      (void)thes::from_container_file(reader, thes::type_tag<Chunk>);
+    } catch (const thes::FileException& ex) {
+      endianness = std::string_view{ex.what()}.find("endianness") != std::string_view::npos;
+    }
+    THES_CHECK(endianness);
+  }
+  // A file in a different format.
+  {
+    thes::FileWriter writer{path};
+    writer.write(std::array<char, 64>{'n', 'o', 'p', 'e'});
+  }
+  {
+    const thes::MappedFile file{path};
+    thes::MappedReader mapped{file};
+    THES_CHECK_THROWS_AS(thes::view_from_container_file(mapped, thes::type_tag<Chunk>),
+                         thes::FileException);
+  }
+}
+
+THES_TEST_CASE("NestedDynamicArray round-trips through a container file",
+               "[io][container-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+
+  Nested::NestedBuilder builder{};
+  builder.initialize(2, 3);
+  {
+    auto part = builder.part_builder(0, 0);
+    part.advance_group();
+    part.emplace(7);
+    part.emplace(8);
+    part.emplace(9);
+    part.advance_group();
+  }
+  const Nested array = builder.build();
+  const auto path = write(dir.path(), {}, array);
+
+  thes::FileReader reader{path};
+  const auto restored = thes::from_container_file(reader, thes::type_tag<Nested>);
+  THES_REQUIRE(restored.size() == 2);
+  THES_CHECK(restored[0].empty());
+  THES_CHECK(thes::test::range_eq(restored[1], std::array{7, 8, 9}));
+
+  const thes::MappedFile file{path};
+  thes::MappedReader mapped{file};
+  const auto view = thes::view_from_container_file(mapped, thes::type_tag<Nested>);
+  THES_REQUIRE(view.size() == 2);
+  THES_CHECK(view[0].empty());
+  THES_CHECK(thes::test::range_eq(view[1], std::array{7, 8, 9}));
+}
+
+THES_TEST_CASE("Container files reject inconsistent nested offsets", "[io][container-file]") {
+  using Offsets = thes::TypedChunk<std::size_t, std::size_t, std::allocator<std::size_t>>;
+  const thes::fs::TemporaryDirectory dir{};
+  const Chunk values{3};
+
+  // The offsets have to start at zero, never decrease and end at the number of values.
+  using Stored = std::array<std::size_t, 3>;
+  for (const Stored& stored : {Stored{1, 2, 3}, Stored{0, 2, 1}, Stored{0, 2, 2}}) {
+    Offsets offsets{stored.size()};
+    std::ranges::copy(stored, offsets.span().begin());
+    const auto path = write(dir.path(), {}, offsets, values);
+
+    thes::FileReader reader{path};
+    THES_CHECK_THROWS_AS(thes::from_container_file(reader, thes::type_tag<Nested>),
+                         thes::FileException);
+    const thes::MappedFile file{path};
+    thes::MappedReader mapped{file};
+    THES_CHECK_THROWS_AS(thes::view_from_container_file(mapped, thes::type_tag<Nested>),
+                         thes::FileException);
+  }
+}
+
+THES_TEST_CASE("MultiByteIntegers round-trip through a container file", "[io][container-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const Integers integers{5U, 0xFEDCBAU, 0U, 0x010203U};
+  const auto path = write(dir.path(), {}, integers);
+
+  thes::FileReader reader{path};
+  const auto restored = thes::from_container_file(reader, thes::type_tag<Integers>);
+  THES_CHECK(thes::test::range_eq(restored, integers));
+
+  const thes::MappedFile file{path};
+  thes::MappedReader mapped{file};
+  const auto view = thes::view_from_container_file(mapped, thes::type_tag<Integers>);
+  THES_CHECK(thes::test::range_eq(view, integers));
+}
+} // namespace
+
+THES_TEST_MAIN()
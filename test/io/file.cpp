@@ -168,6 +168,29 @@ THES_TEST_CASE("pread does not move the file position", "[io][file]") {
   THES_CHECK(buffer.size() == 2);
 }
 
+/** Checks that `pwrite` writes at an absolute offset and leaves the position untouched. */
+THES_TEST_CASE("pwrite does not move the file position", "[io][file]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = dir.path() / "pwrite.bin";
+  {
+    thes::FileWriter writer{path};
+    const std::array<thes::u8, 4> values{1, 2, 3, 4};
+    writer.write(std::span{values.data(), values.size()});
+    writer.pwrite(thes::u8{20}, 1);
+    THES_CHECK(writer.tell() == 4);
+    // Buffered writes before `pwrite` are flushed first, so they cannot overwrite it later.
+    writer.write(thes::u8{5});
+    const std::array<thes::u8, 2> patch{30, 40};
+    writer.pwrite(std::span{patch.data(), patch.size()}, 2);
+    writer.write(thes::u8{6});
+  }
+
+  thes::FileReader reader{path};
+  std::array<thes::u8, 6> read{};
+  reader.read(std::span{read.data(), read.size()});
+  THES_CHECK(test::range_eq(read, std::vector<thes::u8>{1, 20, 30, 40, 5, 6}));
+}
+
 //==================================================================================================
 // Whole-file reads
 //==================================================================================================
@@ -0,0 +1,137 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+#include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/containers/multi-byte-integers.hpp"
+#include "thesauros/containers/nested-dynamic-array.hpp"
+#include "thesauros/filesystem/tempfile.hpp"
+#include "thesauros/io/file-writer.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/io/mapped-file.hpp"
+#include "thesauros/io/serialization.hpp"
+#include "thesauros/test/equality.hpp"
+#include "thesauros/test/test.hpp"
+#include "thesauros/types/type-tag.hpp"
+#include "thesauros/utility/byte-integer.hpp"
+
+namespace {
+using Chunk = thes::TypedChunk<int, std::size_t, std::allocator<int>>;
+using Nested = thes::NestedDynamicArray<int, std::size_t>;
+using Integers = thes::MultiByteIntegers<thes::ByteInteger<3>, 1>;
+
+/** Writes each of `values` to a fresh file under `dir` and returns its path. */
+std::filesystem::path write(const std::filesystem::path& dir, const auto&... values) {
+  auto path = dir / "data.bin";
+  thes::FileWriter writer{path};
+  (thes::to_file(values, writer), ...);
+  return path;
+}
+
+THES_TEST_CASE("MappedFile maps the bytes of a file", "[io][mapped-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+
+  Chunk chunk{5};
+  const std::array<int, 5> expected{2, 7, 1, 8, 2};
+  std::ranges::copy(expected, chunk.span().begin());
+  const auto path = write(dir.path(), chunk);
+
+  for (const thes::MapAccess access :
+       {thes::MapAccess::normal, thes::MapAccess::sequential, thes::MapAccess::random}) {
+    const thes::MappedFile file{path, {.populate = true, .huge_pages = true, .access = access}};
+    THES_CHECK(file.size() == sizeof(std::size_t) + sizeof(expected));
+
+    thes::MappedReader reader{file};
+    const auto view = thes::view_from_file(reader, thes::type_tag<Chunk>);
+    THES_CHECK(thes::test::range_eq(view, expected));
+    THES_CHECK(reader.tell() == file.size());
+  }
+}
+
+THES_TEST_CASE("MappedFile maps an empty file", "[io][mapped-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = write(dir.path());
+
+  const thes::MappedFile file{path};
+  THES_CHECK(file.size() == 0);
+  thes::MappedReader reader{file};
+  THES_CHECK_THROWS_AS(reader.read(thes::type_tag<int>), thes::FileException);
+}
+
+THES_TEST_CASE("NestedDynamicArray is viewed in a mapped file", "[io][mapped-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+
+  Nested::NestedBuilder builder{};
+  builder.initialize(3, 4);
+  {
+    auto part = builder.part_builder(0, 0);
+    part.emplace(1);
+    part.advance_group();
+    part.advance_group();
+    part.emplace(2);
+    part.emplace(3);
+    part.emplace(4);
+    part.advance_group();
+  }
+  const Nested array = builder.build();
+  const auto path = write(dir.path(), array);
+
+  const thes::MappedFile file{path};
+  thes::MappedReader reader{file};
+  const auto view = thes::view_from_file(reader, thes::type_tag<Nested>);
+  THES_REQUIRE(view.size() == 3);
+  THES_CHECK(view.element_num() == 4);
+  THES_CHECK(thes::test::range_eq(view[0], std::array{1}));
+  THES_CHECK(view[1].empty());
+  THES_CHECK(thes::test::range_eq(view[2], std::array{2, 3, 4}));
+
+  std::size_t group_num = 0;
+  for (const auto group : view) {
+    THES_CHECK(thes::test::range_eq(group, array[group_num]));
+    ++group_num;
+  }
+  THES_CHECK(group_num == 3);
+}
+
+THES_TEST_CASE("MultiByteIntegers are viewed in a mapped file", "[io][mapped-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+
+  // The integers end the file, so their padded loads read from the zeros following it.
+  const Integers integers{1U, 0xABCDEFU, 0x123456U, 42U};
+  const auto path = write(dir.path(), integers);
+
+  const thes::MappedFile file{path};
+  thes::MappedReader reader{file};
+  const auto view = thes::view_from_file(reader, thes::type_tag<Integers>);
+  THES_CHECK(thes::test::range_eq(view, integers));
+}
+
+THES_TEST_CASE("MappedReader rejects invalid views", "[io][mapped-file]") {
+  const thes::fs::TemporaryDirectory dir{};
+
+  const Chunk chunk{3};
+  const auto path = write(dir.path(), chunk);
+  const thes::MappedFile file{path};
+  thes::MappedReader reader{file};
+
+  // Too many values.
+  THES_CHECK_THROWS_AS(reader.view(6, thes::type_tag<int>), thes::FileException);
+  // Values which are not aligned as their type requires.
+  reader.seek(1);
+  THES_CHECK_THROWS_AS(reader.view(1, thes::type_tag<int>), thes::FileException);
+  THES_CHECK_THROWS_AS(reader.seek(file.size() + 1), thes::FileException);
+
+  reader.seek(sizeof(std::size_t));
+  THES_CHECK(reader.view(3, thes::type_tag<int>).size() == 3);
+  THES_CHECK(reader.tell() == file.size());
+}
+} // namespace
+
+THES_TEST_MAIN()
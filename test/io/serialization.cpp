@@ -9,13 +9,18 @@
 #include <cstddef>
 #include <filesystem>
 #include <memory>
+#include <span>
 #include <vector>
 
 #include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/containers/bitset/compressed.hpp"
+#include "thesauros/containers/bitset/set-bits.hpp"
 #include "thesauros/containers/nested-dynamic-array.hpp"
 #include "thesauros/filesystem/tempfile.hpp"
 #include "thesauros/io/file-reader.hpp"
 #include "thesauros/io/file-writer.hpp"
+#include "thesauros/io/file.hpp"
+#include "thesauros/io/mapped-file.hpp"
 #include "thesauros/io/serialization.hpp"
 #include "thesauros/test/equality.hpp"
 #include "thesauros/test/test.hpp"
@@ -88,6 +93,145 @@ THES_TEST_CASE("NestedDynamicArray round-trips through a file", "[io][serializat
   THES_CHECK(restored[1].empty());
   THES_CHECK(thes::test::range_eq(restored[2], std::array{3, 4, 5}));
 }
+
+THES_TEST_CASE("Inconsistent NestedDynamicArray offsets are rejected", "[io][serialization]") {
+  using Offsets = std::vector<std::size_t>;
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = dir.path() / "data.bin";
+
+  const auto write = [&](const Offsets& offsets) {
+    thes::FileWriter writer{path};
+    writer.write(offsets.size());
+    writer.write(std::span{offsets.data(), offsets.size()});
+    writer.write(std::size_t{3});
+    writer.write(std::array{1, 2, 3});
+  };
+  /** Whether a nested array with the given offsets and three values can be read. */
+  const auto read_ok = [&](const Offsets& offsets) {
+    write(offsets);
+    thes::FileReader reader{path};
+    try {
+      return thes::from_file(reader, thes::type_tag<Nested>).element_num() == 3;
+    } catch (const thes::FileException& /*ex*/) {
+      return false;
+    }
+  };
+  /** Whether a nested array with the given offsets and three values can be viewed. */
+  const auto view_ok = [&](const Offsets& offsets) {
+    write(offsets);
+    const thes::MappedFile file{path};
+    thes::MappedReader reader{file};
+    try {
+      return thes::view_from_file(reader, thes::type_tag<Nested>).size() + 1 == offsets.size();
+    } catch (const thes::FileException& /*ex*/) {
+      return false;
+    }
+  };
+
+  THES_CHECK(read_ok(Offsets{0, 1, 1, 3}));
+  THES_CHECK(view_ok(Offsets{0, 1, 1, 3}));
+  // The offsets have to start at zero, never decrease and end at the number of values.
+  for (const Offsets& offsets : {Offsets{}, Offsets{1, 3}, Offsets{0, 2, 1, 3}, Offsets{0, 2}}) {
+    THES_CHECK(!read_ok(offsets));
+    THES_CHECK(!view_ok(offsets));
+  }
+}
+
+THES_TEST_CASE("CompressedBitset round-trips through a file", "[io][serialization]") {
+  const thes::fs::TemporaryDirectory dir{};
+  constexpr std::size_t block_bit_num = thes::CompressedBitset::block_bit_num;
+
+  // One block of each kind: a few scattered bits, many scattered bits and a long run.
+  thes::CompressedBitset bitset{3 * block_bit_num};
+  for (std::size_t i = 0; i < block_bit_num; i += 1000) {
+    bitset.set(i);
+  }
+  for (std::size_t i = block_bit_num; i < 2 * block_bit_num; i += 3) {
+    bitset.set(i);
+  }
+  for (std::size_t i = 2 * block_bit_num + 5; i < 3 * block_bit_num - 5; ++i) {
+    bitset.set(i);
+  }
+  bitset.optimize();
+  THES_REQUIRE(bitset.blocks().size() == 3);
+  THES_CHECK(bitset.blocks()[2].kind == thes::CompressedBlockKind::run);
+
+  const auto restored = round_trip(dir.path(), bitset);
+  THES_CHECK(restored.size() == bitset.size());
+  THES_CHECK(restored.count() == bitset.count());
+  THES_CHECK(thes::test::range_eq(thes::views::set_bits(restored), thes::views::set_bits(bitset)));
+  for (std::size_t i = 0; i < 3; ++i) {
+    THES_CHECK(restored.blocks()[i].kind == bitset.blocks()[i].kind);
+  }
+}
+
+THES_TEST_CASE("An inconsistent CompressedBitset is rejected", "[io][serialization]") {
+  using Bitset = thes::CompressedBitset;
+  using Kind = thes::CompressedBlockKind;
+  using Offsets = std::vector<Bitset::Offset>;
+  const thes::fs::TemporaryDirectory dir{};
+  const auto path = dir.path() / "data.bin";
+
+  /** Whether reading a bitset of `size` bits consisting of the given block succeeds. */
+  const auto accepted = [&](std::size_t size, Kind kind, std::size_t cardinality,
+                            std::size_t length, const auto& payload) {
+    {
+      thes::FileWriter writer{path};
+      writer.write(std::array<std::size_t, 2>{size, 1});
+      writer.write(std::array<std::size_t, 4>{0, std::size_t(kind), cardinality, length});
+      writer.write(std::span{payload.data(), payload.size()});
+    }
+    thes::FileReader reader{path};
+    try {
+      const Bitset bitset = thes::from_file(reader, thes::type_tag<Bitset>);
+      return bitset.count() == cardinality;
+    } catch (const thes::FileException& /*ex*/) {
+      return false;
+    }
+  };
+  const auto array_ok = [&](std::size_t size, const Offsets& offsets) {
+    return accepted(size, Kind::array, offsets.size(), offsets.size(), offsets);
+  };
+  const auto runs_ok = [&](std::size_t size, std::size_t cardinality, const Offsets& runs) {
+    return accepted(size, Kind::run, cardinality, runs.size(), runs);
+  };
+
+  {
+    // One bit, but two blocks.
+    {
+      thes::FileWriter writer{path};
+      writer.write(std::array<std::size_t, 2>{1, 2});
+    }
+    thes::FileReader reader{path};
+    THES_CHECK_THROWS_AS(thes::from_file(reader, thes::type_tag<Bitset>), thes::FileException);
+  }
+
+  // Array offsets have to increase strictly and lie below the size.
+  THES_CHECK(array_ok(100, Offsets{3, 5, 99}));
+  THES_CHECK(!array_ok(100, Offsets{5, 3}));
+  THES_CHECK(!array_ok(100, Offsets{3, 3}));
+  THES_CHECK(!array_ok(100, Offsets{3, 100}));
+
+  // Runs have to be ordered, disjoint and below the size, and their lengths sum to the cardinality.
+  THES_CHECK(runs_ok(100, 14, Offsets{0, 9, 20, 23}));
+  THES_CHECK(!runs_ok(100, 10, Offsets{9, 0}));
+  THES_CHECK(!runs_ok(100, 14, Offsets{0, 9, 5, 8}));
+  THES_CHECK(!runs_ok(100, 14, Offsets{20, 23, 0, 9}));
+  THES_CHECK(!runs_ok(100, 5, Offsets{0, 9}));
+  THES_CHECK(!runs_ok(5, 10, Offsets{0, 9}));
+  // A corrupt length is rejected before anything is allocated for it.
+  THES_CHECK(!accepted(100, Kind::run, 10, std::size_t{1} << 60U, Offsets{0, 9}));
+
+  // Bitmaps have to hold more bits than an array can, all of them below the size.
+  std::vector<Bitset::Word> words(Bitset::bitmap_word_num, ~Bitset::Word{0});
+  THES_CHECK(accepted(Bitset::block_bit_num, Kind::bitmap, Bitset::block_bit_num, words.size(),
+                      words));
+  THES_CHECK(!accepted(Bitset::block_bit_num, Kind::bitmap, 7, words.size(), words));
+  THES_CHECK(!accepted(Bitset::block_bit_num - 1, Kind::bitmap, Bitset::block_bit_num,
+                       words.size(), words));
+  std::ranges::fill(words, Bitset::Word{1});
+  THES_CHECK(!accepted(Bitset::block_bit_num, Kind::bitmap, words.size(), words.size(), words));
+}
 } // namespace
 
 THES_TEST_MAIN()
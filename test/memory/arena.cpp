@@ -0,0 +1,164 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include "thesauros/containers/array/dynamic.hpp"
+#include "thesauros/containers/array/typed-chunk.hpp"
+#include "thesauros/containers/nested-dynamic-array.hpp"
+#include "thesauros/memory/arena.hpp"
+#include "thesauros/test/test.hpp"
+
+namespace {
+using Arena = thes::MonotonicArena<>;
+template<typename T>
+using Array = thes::DynamicArray<T, thes::DefaultInit, thes::DoublingGrowth,
+                                 thes::ArenaAllocator<T>>;
+
+[[nodiscard]] std::uintptr_t address_of(const void* p) {
+  return reinterpret_cast<std::uintptr_t>(p); // NOLINT(*-reinterpret-cast)
+}
+
+//==================================================================================================
+// The arena itself
+//==================================================================================================
+
+/** Checks that consecutive allocations are adjacent up to the padding required for alignment. */
+THES_TEST_CASE("allocations bump a pointer", "[memory][arena]") {
+  Arena arena{256};
+  auto* a = static_cast<std::byte*>(arena.allocate(3, 1));
+  auto* b = static_cast<std::byte*>(arena.allocate(5, 1));
+  THES_CHECK(b == a + 3);
+
+  void* c = arena.allocate(8, 64);
+  THES_CHECK(address_of(c) % 64 == 0);
+  THES_CHECK(arena.block_num() == 1);
+}
+
+/** Checks that allocations exceeding the block size get a block of their own. */
+THES_TEST_CASE("large allocations get a block of their own", "[memory][arena]") {
+  Arena arena{64};
+  [[maybe_unused]] void* small = arena.allocate(32, 8);
+  void* large = arena.allocate(1000, 16);
+  THES_CHECK(address_of(large) % 16 == 0);
+  THES_CHECK(arena.block_num() == 2);
+  THES_CHECK(arena.capacity() >= 1064);
+}
+
+/** Checks that resetting keeps the blocks, so that the same allocations need no new ones. */
+THES_TEST_CASE("reset retains the blocks", "[memory][arena]") {
+  Arena arena{64};
+  void* first = nullptr;
+  for (int round = 0; round < 4; ++round) {
+    void* p = arena.allocate(48, 8);
+    for (int i = 0; i < 8; ++i) {
+      [[maybe_unused]] void* q = arena.allocate(48, 8);
+    }
+    if (round == 0) {
+      first = p;
+    }
+    THES_CHECK(p == first);
+    arena.reset();
+  }
+  const std::size_t blocks = arena.block_num();
+  THES_CHECK(blocks > 1);
+
+  arena.release();
+  THES_CHECK(arena.block_num() == 0);
+  THES_CHECK(arena.capacity() == 0);
+}
+
+/** Checks that an arena can be backed by huge pages. */
+THES_TEST_CASE("a huge pages arena allocates", "[memory][arena]") {
+  thes::HugePagesArena arena{};
+  auto* p = static_cast<int*>(arena.allocate(sizeof(int) * 1024, alignof(int)));
+  p[1023] = 3;
+  THES_CHECK(address_of(p) % thes::HugePagesAllocator<std::byte>::huge_page_size == 0);
+}
+
+//==================================================================================================
+// Scopes and containers
+//==================================================================================================
+
+/** Checks that scopes discard their allocations and restore the previous current arena. */
+THES_TEST_CASE("scopes nest", "[memory][arena]") {
+  Arena outer{};
+  Arena inner{};
+  THES_CHECK(Arena::current() == nullptr);
+  {
+    const thes::ArenaScope outer_scope{outer};
+    void* p = outer.allocate(16, 8);
+    {
+      const thes::ArenaScope inner_scope{inner};
+      THES_CHECK(Arena::current() == &inner);
+      {
+        const thes::ArenaScope again{outer};
+        [[maybe_unused]] void* q = outer.allocate(16, 8);
+      }
+      THES_CHECK(Arena::current() == &inner);
+    }
+    THES_CHECK(Arena::current() == &outer);
+    // The allocation made in the nested scope has been discarded.
+    auto* next = static_cast<std::byte*>(outer.allocate(16, 8));
+    THES_CHECK(next == static_cast<std::byte*>(p) + 16);
+  }
+  THES_CHECK(Arena::current() == nullptr);
+}
+
+/** Checks that a `DynamicArray` can grow within an arena. */
+THES_TEST_CASE("DynamicArray grows in an arena", "[memory][arena]") {
+  Arena arena{128};
+  Array<int> array{thes::ArenaAllocator<int>{arena}};
+  for (int i = 0; i < 1000; ++i) {
+    array.push_back(i);
+  }
+  THES_REQUIRE(array.size() == 1000);
+  for (int i = 0; i < 1000; ++i) {
+    THES_CHECK(array[std::size_t(i)] == i);
+  }
+  THES_CHECK(array.allocator().arena() == &arena);
+
+  // Copies share the arena.
+  const Array<int> copy{array};
+  THES_CHECK(copy.allocator().arena() == &arena);
+  THES_CHECK(copy.size() == 1000);
+}
+
+/** Checks that default-constructed allocators use the arena of the current scope. */
+THES_TEST_CASE("default-constructed allocators use the current scope", "[memory][arena]") {
+  Arena arena{};
+  {
+    const thes::ArenaScope scope{arena};
+    Array<double> array(16);
+    THES_CHECK(array.allocator().arena() == &arena);
+
+    using Nested = thes::NestedDynamicArray<int, std::size_t, thes::ArenaAllocator<int>>;
+    Nested::FlatBuilder builder{};
+    builder.initialize(2, 3);
+    builder.emplace(1);
+    builder.advance_group();
+    builder.emplace(2);
+    builder.emplace(3);
+    builder.advance_group();
+    const Nested nested = builder.build();
+    THES_CHECK(nested.size() == 2);
+    THES_CHECK(nested[1].size() == 2);
+    THES_CHECK(nested[1][1] == 3);
+
+    thes::TypedChunk<int, std::size_t, thes::ArenaAllocator<int>> chunk(8);
+    THES_CHECK(chunk.allocator().arena() == &arena);
+  }
+
+  // There is no arena to allocate from outside of a scope.
+  thes::ArenaAllocator<int> unbound{};
+  THES_CHECK(unbound.arena() == nullptr);
+  THES_CHECK_THROWS_AS(unbound.allocate(1), std::bad_alloc);
+}
+} // namespace
+
+THES_TEST_MAIN()
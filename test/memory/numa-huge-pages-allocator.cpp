@@ -0,0 +1,97 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "thesauros/containers/array/dynamic.hpp"
+#include "thesauros/execution/execution-policy/linear.hpp"
+#include "thesauros/execution/executor/fixed-thread-pool.hpp"
+#include "thesauros/macropolis/platform.hpp"
+#include "thesauros/memory/numa-huge-pages-allocator.hpp"
+#include "thesauros/test/test.hpp"
+
+#if THES_LINUX
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+using Pool = thes::FixedThreadPool;
+using ExPo = thes::LinearExecutionPolicy<Pool>;
+template<typename T>
+using Allocator = thes::NumaHugePagesAllocator<T, ExPo>;
+template<typename T, typename IP = thes::ValueInit>
+using Array = thes::DynamicArray<T, IP, thes::DoublingGrowth, Allocator<T>>;
+
+#if THES_LINUX
+/** Whether all pages of the given range are resident. */
+[[nodiscard]] bool is_resident(const void* p, std::size_t size) {
+  const auto page = std::size_t(sysconf(_SC_PAGESIZE));
+  const auto address = reinterpret_cast<std::uintptr_t>(p); // NOLINT(*-reinterpret-cast)
+  const std::uintptr_t begin = address / page * page;
+  const std::size_t length = address + size - begin;
+  std::vector<unsigned char> residency((length + page - 1) / page);
+  // NOLINTNEXTLINE(*-no-int-to-ptr,*-reinterpret-cast)
+  if (mincore(reinterpret_cast<void*>(begin), length, residency.data()) != 0) {
+    return false;
+  }
+  for (const unsigned char r : residency) {
+    if ((r & 1U) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif
+
+/** Checks that the pages are faulted in by the allocator, before any element is written. */
+THES_TEST_CASE_PARAM("allocations are faulted in", "[memory][numa-huge-pages-allocator]",
+                     thes::NumaPlacement, placement, thes::NumaPlacement::first_touch,
+                     thes::NumaPlacement::bind) {
+  const Pool pool{3};
+  const ExPo expo{pool};
+  constexpr std::size_t size = (std::size_t{5} << 20U) + 3;
+
+  const Array<double, thes::NoInit> array(size, Allocator<double>{expo, placement});
+  THES_CHECK(reinterpret_cast<std::uintptr_t>(array.data()) % // NOLINT(*-reinterpret-cast)
+               Allocator<double>::huge_page_size ==
+             0);
+#if THES_LINUX
+  THES_CHECK(is_resident(array.data(), size * sizeof(double)));
+#endif
+}
+
+/** Checks that the arrays behave like any other, including when growing. */
+THES_TEST_CASE("arrays work as usual", "[memory][numa-huge-pages-allocator]") {
+  const Pool pool{2};
+  const ExPo expo{pool};
+
+  Array<int> array(1000, Allocator<int>{expo, thes::NumaPlacement::bind});
+  for (std::size_t i = 0; i < array.size(); ++i) {
+    THES_CHECK(array[i] == 0);
+    array[i] = int(i);
+  }
+  for (int i = 1000; i < 100000; ++i) {
+    array.push_back(i);
+  }
+  for (std::size_t i = 0; i < array.size(); ++i) {
+    THES_CHECK(array[i] == int(i));
+  }
+  THES_CHECK(array.allocator().placement() == thes::NumaPlacement::bind);
+  THES_CHECK(&array.allocator().execution_policy() == &expo);
+
+  // Moving assigns the allocator along with the memory.
+  Array<int> moved(0, Allocator<int>{expo});
+  moved = std::move(array);
+  THES_CHECK(moved.size() == 100000);
+}
+} // namespace
+
+THES_TEST_MAIN()
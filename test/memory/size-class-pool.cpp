@@ -0,0 +1,265 @@
+// This file is part of https://github.com/KurtBoehm/thesauros.
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "thesauros/containers/array/dynamic.hpp"
+#include "thesauros/containers/nested-dynamic-array.hpp"
+#include "thesauros/execution/executor/fixed-thread-pool.hpp"
+#include "thesauros/memory/size-class-pool.hpp"
+#include "thesauros/test/test.hpp"
+
+namespace {
+using Pool = thes::SizeClassPool;
+template<typename T>
+using Array = thes::DynamicArray<T, thes::DefaultInit, thes::DoublingGrowth,
+                                 thes::SizeClassAllocator<T>>;
+
+//==================================================================================================
+// Size classes
+//==================================================================================================
+
+/** Checks that requests are rounded up to powers of two, accounting for the alignment. */
+THES_TEST_CASE("requests are rounded up to a size class", "[memory][size-class-pool]") {
+  THES_CHECK(Pool::size_class(1, 1) == 0);
+  THES_CHECK(Pool::size_class(16, 8) == 0);
+  THES_CHECK(Pool::size_class(17, 8) == 1);
+  THES_CHECK(Pool::size_class(8, 64) == 2);
+  THES_CHECK(Pool::block_size(Pool::size_class(1000, 8)) == 1024);
+  THES_CHECK(Pool::size_class(Pool::max_block_size, 8) == Pool::class_num - 1);
+  THES_CHECK(Pool::size_class(Pool::max_block_size + 1, 8) == Pool::class_num);
+}
+
+//==================================================================================================
+// A single thread
+//==================================================================================================
+
+/** Checks that freed blocks are reused by the next allocation of the same class. */
+THES_TEST_CASE("freed blocks are reused", "[memory][size-class-pool]") {
+  Pool pool{1};
+  void* a = pool.allocate(0, 24, 8);
+  THES_CHECK(reinterpret_cast<std::uintptr_t>(a) % 32 == 0); // NOLINT(*-reinterpret-cast)
+  pool.deallocate(0, a, 24, 8);
+  void* b = pool.allocate(0, 32, 8);
+  THES_CHECK(a == b);
+  pool.deallocate(0, b, 32, 8);
+
+  // Large requests are forwarded to `operator new`.
+  void* large = pool.allocate(0, 100000, 8);
+  pool.deallocate(0, large, 100000, 8);
+
+  const Pool::Stats stats = pool.stats();
+  const thes::SizeClassStats& cls = stats[Pool::size_class(32, 8)];
+  THES_CHECK(cls.block_size == 32);
+  THES_CHECK(cls.allocations == 2);
+  THES_CHECK(cls.cache_hits == 1);
+  THES_CHECK(cls.bytes_in_use == 0);
+  THES_CHECK(cls.hit_rate() == 0.5);
+}
+
+/** Checks that a `DynamicArray` can grow through the size classes and beyond. */
+THES_TEST_CASE("DynamicArray grows in a pool", "[memory][size-class-pool]") {
+  Pool pool{1};
+  {
+    Array<int> array{thes::SizeClassAllocator<int>{pool, 0}};
+    for (int i = 0; i < 10000; ++i) {
+      array.push_back(i);
+    }
+    THES_REQUIRE(array.size() == 10000);
+    for (int i = 0; i < 10000; ++i) {
+      THES_CHECK(array[std::size_t(i)] == i);
+    }
+    THES_CHECK(pool.stats()[Pool::size_class(4 * sizeof(int), alignof(int))].bytes_in_use == 0);
+  }
+  for (const thes::SizeClassStats& cls : pool.stats()) {
+    THES_CHECK(cls.bytes_in_use == 0);
+  }
+}
+
+/** Checks that a default-constructed allocator forwards to `operator new` and can be replaced. */
+THES_TEST_CASE("a default allocator has no pool", "[memory][size-class-pool]") {
+  Pool pool{1};
+  Array<int> array{};
+  THES_CHECK(array.allocator().pool() == nullptr);
+  array.push_back(1);
+  array = Array<int>{thes::SizeClassAllocator<int>{pool, 0}};
+  array.push_back(2);
+  THES_CHECK(array.allocator().pool() == &pool);
+  THES_CHECK(pool.stats()[Pool::size_class(sizeof(int), alignof(int))].allocations == 1);
+
+  // The builders of a nested array default-construct both the value and the offset allocator.
+  thes::NestedDynamicArray<int, std::size_t, thes::SizeClassAllocator<int>>::FlatBuilder builder{};
+  builder.initialize(1, 2);
+  builder.emplace(1);
+  builder.emplace(2);
+  builder.advance_group();
+  const auto nested = builder.build();
+  THES_CHECK(nested.size() == 1);
+  THES_CHECK(nested[0].size() == 2);
+}
+
+//==================================================================================================
+// Several threads
+//==================================================================================================
+
+/** Checks that a cache stays with the first thread allocating from it. */
+THES_TEST_CASE("a cache is bound to its first thread", "[memory][size-class-pool]") {
+  Pool pool{2};
+  void* own = pool.allocate(0, 64, 8);
+  std::thread thread{[&] {
+    // The thread owns cache 1, so freeing into it takes the local path.
+    void* p = pool.allocate(1, 64, 8);
+    pool.deallocate(1, p, 64, 8);
+    // Cache 0 belongs to the main thread, so this block goes to its remote list.
+    pool.deallocate(0, own, 64, 8);
+  }};
+  thread.join();
+
+  const std::size_t cls = Pool::size_class(64, 8);
+  THES_CHECK(pool.stats(0)[cls].remote_frees == 1);
+  THES_CHECK(pool.stats(1)[cls].remote_frees == 0);
+  THES_CHECK(pool.stats(1)[cls].bytes_in_use == 0);
+}
+
+/** Checks that a thread finding the cache of its index taken uses another one. */
+THES_TEST_CASE("a thread falls back to a cache of its own", "[memory][size-class-pool]") {
+  Pool pool{2};
+  void* own = pool.allocate(0, 64, 8);
+  void* other = nullptr;
+  bool threw = false;
+  std::thread thread{[&] {
+    // Cache 0 belongs to the main thread, so this thread claims cache 1.
+    other = pool.allocate(0, 64, 8);
+    pool.deallocate(1, other, 64, 8);
+    // Once all caches have owners, a third thread cannot allocate.
+    std::thread{[&] {
+      try {
+        [[maybe_unused]] void* p = pool.allocate(0, 64, 8);
+      } catch (const std::logic_error& /*e*/) {
+        threw = true;
+      }
+    }}.join();
+  }};
+  thread.join();
+  pool.deallocate(0, own, 64, 8);
+
+  const std::size_t cls = Pool::size_class(64, 8);
+  THES_CHECK(threw);
+  THES_CHECK(pool.stats(1)[cls].allocations == 1);
+  THES_CHECK(pool.stats(1)[cls].remote_frees == 0);
+  THES_CHECK(pool.stats()[cls].bytes_in_use == 0);
+}
+
+/** Checks that blocks freed by another thread are returned to the owning cache. */
+THES_TEST_CASE("remote frees are reclaimed", "[memory][size-class-pool]") {
+  Pool pool{2};
+  std::vector<void*> blocks{};
+  for (int i = 0; i < 100; ++i) {
+    blocks.push_back(pool.allocate(0, 64, 8));
+  }
+  std::thread thread{[&] {
+    for (void* p : blocks) {
+      pool.deallocate(0, p, 64, 8);
+    }
+  }};
+  thread.join();
+
+  // The freed blocks are reclaimed once the free list of the class runs dry, i.e. after the
+  // remainder of the first slab has been handed out.
+  const std::size_t remainder = Pool::slab_size / 64 - blocks.size();
+  for (std::size_t i = 0; i < remainder + blocks.size(); ++i) {
+    [[maybe_unused]] void* p = pool.allocate(0, 64, 8);
+  }
+  const thes::SizeClassStats cls = pool.stats()[Pool::size_class(64, 8)];
+  THES_CHECK(cls.remote_frees == blocks.size());
+  // Only the first slab has been needed.
+  THES_CHECK(cls.allocations - cls.cache_hits == 1);
+}
+
+/** Checks the pool with the tasks of a thread pool, which hand their arrays to each other. */
+THES_TEST_CASE("tasks allocate concurrently", "[memory][size-class-pool]") {
+  constexpr std::size_t size = 4;
+  thes::FixedThreadPool threads{size};
+  Pool pool{size};
+
+  std::vector<std::optional<Array<std::size_t>>> arrays(size);
+  std::vector<std::size_t> sums(size);
+  for (int round = 0; round < 16; ++round) {
+    threads.execute([&](std::size_t i) {
+      Array<std::size_t> array{thes::SizeClassAllocator<std::size_t>{pool, i}};
+      for (std::size_t j = 0; j < 100 * (i + 1); ++j) {
+        array.push_back(j);
+      }
+      arrays[i].emplace(std::move(array));
+    });
+    // Each array is destroyed by the next index, i.e. by another thread.
+    threads.execute([&](std::size_t i) {
+      auto& array = arrays[(i + 1) % size];
+      sums[i] = 0;
+      for (const std::size_t value : *array) {
+        sums[i] += value;
+      }
+      array.reset();
+    });
+    for (std::size_t i = 0; i < size; ++i) {
+      const std::size_t n = 100 * ((i + 1) % size + 1);
+      THES_CHECK(sums[i] == n * (n - 1) / 2);
+    }
+  }
+
+  std::size_t remote_frees = 0;
+  std::size_t bytes_in_use = 0;
+  for (const thes::SizeClassStats& cls : pool.stats()) {
+    remote_frees += cls.remote_frees;
+    bytes_in_use += cls.bytes_in_use;
+    THES_CHECK(cls.cache_hits <= cls.allocations);
+  }
+  THES_CHECK(remote_frees >= 16 * size);
+  THES_CHECK(bytes_in_use == 0);
+}
+
+/**
+ * Checks allocating in a submitted region after `execute`, which runs each index on another
+ * thread than `execute` does, so that the caches of the indices belong to other threads.
+ */
+THES_TEST_CASE("tasks allocate in a submitted region", "[memory][size-class-pool]") {
+  constexpr std::size_t size = 4;
+  thes::FixedThreadPool threads{size};
+  Pool pool{size};
+
+  std::vector<std::size_t> sums(size);
+  const auto task = [&](std::size_t i) {
+    Array<std::size_t> array{thes::SizeClassAllocator<std::size_t>{pool, i}};
+    for (std::size_t j = 0; j < 1000; ++j) {
+      array.push_back(j);
+    }
+    sums[i] = 0;
+    for (const std::size_t value : array) {
+      sums[i] += value;
+    }
+  };
+  for (int round = 0; round < 16; ++round) {
+    threads.execute(task);
+    auto submission = threads.submit(task);
+    submission.wait();
+    for (std::size_t i = 0; i < size; ++i) {
+      THES_CHECK(sums[i] == 1000 * 999 / 2);
+    }
+  }
+
+  for (const thes::SizeClassStats& cls : pool.stats()) {
+    THES_CHECK(cls.bytes_in_use == 0);
+  }
+}
+} // namespace
+
+THES_TEST_MAIN()